@@ -0,0 +1,238 @@
+// ai_scheduler.h
+//
+// Distance-based level of detail for dot AI: dots near the player think
+// every tick, farther ones every few ticks with the time they missed, and
+// the far work has a per-frame time budget. No raylib, so the benchmark
+// in bench/ runs the same code as the game.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// AiBand: dots closer to the player than maxDistance think every
+// 'interval' ticks (a power of two)
+struct AiBand {
+  float maxDistance;
+  int interval;
+};
+
+// AiScheduler: decides which dots run Control this frame, and with what
+// delta time. Each batch of one dot type is a lane, with its dots by
+// their index in the batch (batches only grow, so indices are stable).
+//   - Dots in an interval-1 band are on the near list and run every
+//     tick, never deferred
+//   - Any other dot waits in a slot of a small timing wheel and runs
+//     'interval' ticks after it last did; until then it costs nothing
+//   - A dot picks its band again after every run, so the player moving
+//     closer is noticed within one interval (the near band needs that
+//     much margin)
+//   - Due far dots run until the frame's budget is used up; the rest
+//     spill into the next frame and go first there
+//   - Every run gets all the time since that dot last ran, capped at
+//     maxStep, so a far dot covers the same ground in fewer steps
+class AiScheduler {
+public:
+  static const int maxLanes = 4;
+  static const int wheelSize = 16; // Longest interval
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Lane {
+    int known = 0;              // Dots [0, known) have been placed
+    std::vector<double> lastRun; // Scheduler time of each dot's last run
+    std::vector<int> near;       // Running every tick
+    std::vector<int> slots[wheelSize]; // Far dots, by the tick they're due
+    std::vector<int> spill;      // Due, but the budget ran out
+  };
+
+  std::vector<AiBand> bands; // Nearest first; the last catches the rest
+  std::vector<float> bandLimits; // maxDistance squared, per band
+  Lane lanes[maxLanes];
+  std::vector<int> due; // Scratch: this tick's far dots
+  double budgetSeconds;
+  float maxStep = 0.1f;
+  uint32_t tick = 0;
+  double time = 0.0; // Sum of delta times
+  float deltaTime = 0.0f;
+  Clock::time_point frameStart;
+  double budgetLeft = 0.0; // Seconds, shared by the lanes still to run
+  int dotsLeft = 0;        // Dots in the lanes still to run
+
+  // Last frame's numbers
+  int ranNear = 0;
+  int ranFar = 0;
+  int skipped = 0;
+  int deferred = 0;
+  double frameSeconds = 0.0;
+
+  int IntervalFor(float distanceSq) const {
+    size_t band = 0;
+    while (band + 1 < bands.size() && distanceSq >= bandLimits[band])
+      band++;
+    return bands[band].interval;
+  }
+
+  double Elapsed() const {
+    return std::chrono::duration<double>(Clock::now() - frameStart).count();
+  }
+
+  template <typename RunFn> void RunDot(Lane &lane, int i, RunFn &run) {
+    float step = (float)(time - lane.lastRun[i]);
+    run(i, step < maxStep ? step : maxStep);
+    lane.lastRun[i] = time;
+  }
+
+  // Room for 'count' dots in every list of the lane (and in 'due'), so
+  // dots moving between them never allocate; grows in doublings
+  void Reserve(Lane &lane, int count) {
+    if (count <= (int)lane.near.capacity())
+      return;
+    size_t size = std::max((size_t)count, 2 * lane.near.capacity());
+    lane.lastRun.reserve(size);
+    lane.near.reserve(size);
+    for (std::vector<int> &slot : lane.slots)
+      slot.reserve(size);
+    lane.spill.reserve(size);
+    due.reserve(std::max(size, due.capacity()));
+  }
+
+  // Onto the near list, or into the wheel slot 'interval' ticks ahead
+  template <typename DistanceFn>
+  void Place(Lane &lane, int i, DistanceFn &distanceSq) {
+    int interval = IntervalFor(distanceSq(i));
+    if (interval <= 1)
+      lane.near.push_back(i);
+    else
+      lane.slots[(tick + interval) & (wheelSize - 1)].push_back(i);
+  }
+
+  // Runs far dots from 'list' until the lane's time is up; the rest
+  // are appended to the lane's spill
+  template <typename DistanceFn, typename RunFn>
+  void RunFar(Lane &lane, const std::vector<int> &list, double stopAt,
+              DistanceFn &distanceSq, RunFn &run) {
+    size_t next = 0;
+    for (; next < list.size(); ++next) {
+      if ((next & 31) == 31 && Elapsed() >= stopAt) // ~20 ns per look
+        break;
+      RunDot(lane, list[next], run);
+      Place(lane, list[next], distanceSq);
+      ranFar++;
+    }
+    lane.spill.insert(lane.spill.end(), list.begin() + next, list.end());
+  }
+
+public:
+  AiScheduler(double budgetMicroseconds, std::vector<AiBand> newBands)
+      : bands(std::move(newBands)), budgetSeconds(budgetMicroseconds * 1e-6) {
+    if (bands.empty())
+      bands.push_back({0.0f, 1});
+    for (AiBand &band : bands) {
+      if (band.interval > wheelSize)
+        band.interval = wheelSize;
+      bandLimits.push_back(band.maxDistance * band.maxDistance);
+    }
+  }
+
+  // Forget every dot (the game was reset and its batches emptied). The
+  // lists keep their capacity, so the next round doesn't allocate.
+  void Reset() {
+    for (Lane &lane : lanes) {
+      lane.known = 0;
+      lane.lastRun.clear();
+      lane.near.clear();
+      for (std::vector<int> &slot : lane.slots)
+        slot.clear();
+      lane.spill.clear();
+    }
+  }
+
+  void SetBudgetMicroseconds(double microseconds) {
+    budgetSeconds = microseconds * 1e-6;
+  }
+
+  void SetMaxStep(float seconds) { maxStep = seconds; }
+
+  void BeginFrame(float newDeltaTime, int totalDots) {
+    tick++;
+    deltaTime = newDeltaTime;
+    time += newDeltaTime;
+    frameStart = Clock::now();
+    budgetLeft = budgetSeconds;
+    dotsLeft = totalDots;
+    ranNear = ranFar = skipped = deferred = 0;
+  }
+
+  // Runs one lane: 'distanceSq(i)' is dot i's squared distance to the
+  // player, 'run(i, dt)' calls its Control. Lanes share the budget by dot
+  // count, and whatever one leaves goes to the next.
+  template <typename DistanceFn, typename RunFn>
+  void RunLane(int laneIndex, int count, DistanceFn distanceSq, RunFn run) {
+    Lane &lane = lanes[laneIndex];
+    Reserve(lane, count);
+
+    // This tick's slot is taken first: a near dot moving to the longest
+    // interval lands in it again, due a whole wheel from now
+    due.clear();
+    due.swap(lane.spill);
+    std::vector<int> &slot = lane.slots[tick & (wheelSize - 1)];
+    due.insert(due.end(), slot.begin(), slot.end());
+    slot.clear();
+
+    // New dots think this tick, then find their band
+    lane.lastRun.resize(count, time - deltaTime);
+    for (; lane.known < count; ++lane.known)
+      lane.near.push_back(lane.known);
+
+    // The near list: every dot, every tick; those that moved away leave
+    size_t kept = 0;
+    for (size_t n = 0; n < lane.near.size(); ++n) {
+      int i = lane.near[n];
+      RunDot(lane, i, run);
+      int interval = IntervalFor(distanceSq(i));
+      if (interval <= 1)
+        lane.near[kept++] = i;
+      else
+        lane.slots[(tick + interval) & (wheelSize - 1)].push_back(i);
+    }
+    int nearRan = (int)lane.near.size();
+    lane.near.resize(kept);
+
+    // Far dots: last frame's spill first, then this tick's slot (both
+    // already in 'due')
+    double laneStart = Elapsed();
+    double share = dotsLeft > 0 ? budgetLeft * count / dotsLeft : budgetLeft;
+    double stopAt = laneStart + share;
+    int farBefore = ranFar;
+    RunFar(lane, due, stopAt, distanceSq, run);
+
+    deferred += (int)lane.spill.size();
+    skipped += count - nearRan - (ranFar - farBefore) - (int)lane.spill.size();
+    ranNear += nearRan;
+    budgetLeft -= Elapsed() - laneStart;
+    if (budgetLeft < 0.0)
+      budgetLeft = 0.0;
+    dotsLeft -= count;
+  }
+
+  void EndFrame() {
+    frameSeconds =
+        std::chrono::duration<double>(Clock::now() - frameStart).count();
+  }
+
+  int GetRanNear() const { return ranNear; }
+
+  int GetRanFar() const { return ranFar; }
+
+  int GetSkipped() const { return skipped; }
+
+  // Due but left for a later frame by the budget
+  int GetDeferred() const { return deferred; }
+
+  double GetFrameMicroseconds() const { return frameSeconds * 1e6; }
+};
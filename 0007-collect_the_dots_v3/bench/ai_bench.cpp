@@ -0,0 +1,236 @@
+// ai_bench.cpp
+//
+// AI level of detail (ai_scheduler.h) at 5k dots, half targets and half
+// enemies, against every dot thinking every tick:
+//   time   - AI microseconds per frame, full update vs scheduled, and
+//            with a budget small enough to push far work to later frames
+//   near   - how far any dot within 200 px of the player ends up from
+//            where the full update put it (0 means no visible change)
+// Then dots hopping between the near band and the longest interval are
+// checked to run at most once a tick, never with a zero step.
+// The player circles the middle of the screen; the Control math copies
+// Target and Enemy in main.cpp, as bench/dispatch_bench.cpp does. Needs
+// no raylib, so it builds and runs headless.
+//
+// Usage: ai_bench [dots] [frames] [runs]
+
+#include "../ai_scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+const float screenWidth = 800.0f;
+const float screenHeight = 600.0f;
+const float dt = 1.0f / 60.0f;
+const AiBand bands[] = {{250.0f, 1}, {450.0f, 2}, {1e9f, 4}};
+
+struct Vec2 {
+  float x, y;
+};
+
+static inline Vec2 Sub(Vec2 a, Vec2 b) { return {a.x - b.x, a.y - b.y}; }
+static inline Vec2 Add(Vec2 a, Vec2 b) { return {a.x + b.x, a.y + b.y}; }
+static inline Vec2 Scale(Vec2 v, float s) { return {v.x * s, v.y * s}; }
+static inline float Length(Vec2 v) { return sqrtf(v.x * v.x + v.y * v.y); }
+static inline float DistanceSq(Vec2 a, Vec2 b) {
+  Vec2 d = Sub(a, b);
+  return d.x * d.x + d.y * d.y;
+}
+
+static inline Vec2 Clamp(Vec2 p, float radius) {
+  p.x = fminf(fmaxf(p.x, radius), screenWidth - radius);
+  p.y = fminf(fmaxf(p.y, radius), screenHeight - radius);
+  return p;
+}
+
+static inline Vec2 WeightedAttraction(Vec2 from, Vec2 to, float threshold,
+                                      float weight) {
+  Vec2 dir = Sub(to, from);
+  float dist = Length(dir);
+  if (dist < 0.01f || dist > threshold)
+    return {0, 0};
+  dir = Scale(dir, 1.0f / dist);
+  return Scale(dir, weight * (threshold - dist) / threshold);
+}
+
+// Target::Control
+static inline void TargetStep(Vec2 &pos, float step, Vec2 player) {
+  Vec2 velocity = WeightedAttraction(pos, player, 200.0f, -400.0f);
+  float speed = Length(velocity);
+  if (speed > 160.0f)
+    velocity = Scale(velocity, 160.0f / speed);
+  pos = Clamp(Add(pos, Scale(velocity, step)), 10.0f);
+}
+
+// Enemy::Control
+static inline void EnemyStep(Vec2 &pos, float step, Vec2 player) {
+  Vec2 direction = Sub(player, pos);
+  float dist = Length(direction);
+  if (dist > 0.01f)
+    pos = Clamp(Add(pos, Scale(direction, 120.0f * step / dist)), 12.0f);
+}
+
+static Vec2 PlayerAt(int frame) {
+  float angle = frame * dt * 1.5f; // 180 px circle at ~270 px/s
+  return {400.0f + 180.0f * cosf(angle), 300.0f + 180.0f * sinf(angle)};
+}
+
+struct World {
+  std::vector<Vec2> targets, enemies;
+};
+
+static World MakeWorld(int dots) {
+  std::mt19937 rng(5u);
+  std::uniform_real_distribution<float> x(0.0f, screenWidth);
+  std::uniform_real_distribution<float> y(0.0f, screenHeight);
+  World world;
+  for (int i = 0; i < dots; ++i) {
+    Vec2 p = {x(rng), y(rng)};
+    (i % 2 ? world.enemies : world.targets).push_back(p);
+  }
+  return world;
+}
+
+struct RunResult {
+  double microsecondsPerFrame; // AI only
+  double nearRan, farRan, deferred; // Per frame
+  float nearError;                  // px, vs the full update
+};
+
+// scheduler == nullptr: every dot every tick. 'reference', when given,
+// holds the full update's positions per frame to compare against.
+static RunResult Run(int dots, int frames, AiScheduler *scheduler,
+                     std::vector<World> *record,
+                     const std::vector<World> *reference) {
+  World world = MakeWorld(dots);
+  RunResult result = {};
+  double seconds = 0.0;
+  for (int f = 0; f < frames; ++f) {
+    Vec2 player = PlayerAt(f);
+    Clock::time_point start = Clock::now();
+    if (!scheduler) {
+      for (Vec2 &p : world.targets)
+        TargetStep(p, dt, player);
+      for (Vec2 &p : world.enemies)
+        EnemyStep(p, dt, player);
+    } else {
+      scheduler->BeginFrame(dt, dots);
+      scheduler->RunLane(
+          0, (int)world.targets.size(),
+          [&](int i) { return DistanceSq(world.targets[i], player); },
+          [&](int i, float step) { TargetStep(world.targets[i], step, player); });
+      scheduler->RunLane(
+          1, (int)world.enemies.size(),
+          [&](int i) { return DistanceSq(world.enemies[i], player); },
+          [&](int i, float step) { EnemyStep(world.enemies[i], step, player); });
+      scheduler->EndFrame();
+      result.nearRan += scheduler->GetRanNear();
+      result.farRan += scheduler->GetRanFar();
+      result.deferred += scheduler->GetDeferred();
+    }
+    seconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+    if (record)
+      record->push_back(world);
+    if (reference) {
+      const World &full = (*reference)[f];
+      auto compare = [&](const std::vector<Vec2> &mine,
+                         const std::vector<Vec2> &theirs) {
+        for (size_t i = 0; i < mine.size(); ++i) {
+          if (DistanceSq(theirs[i], player) < 200.0f * 200.0f)
+            result.nearError = std::max(
+                result.nearError, sqrtf(DistanceSq(mine[i], theirs[i])));
+        }
+      };
+      compare(world.targets, full.targets);
+      compare(world.enemies, full.enemies);
+    }
+  }
+  result.microsecondsPerFrame = seconds * 1e6 / frames;
+  result.nearRan /= frames;
+  result.farRan /= frames;
+  result.deferred /= frames;
+  return result;
+}
+
+// Dots near the player for a few ticks, then far enough for the longest
+// interval, at staggered times: each must run at most once per tick, and
+// every run must get some time
+static bool RunsOncePerTick(int dots, int frames) {
+  const AiBand hopping[] = {{100.0f, 1}, {1e9f, AiScheduler::wheelSize}};
+  AiScheduler scheduler(1e6, {std::begin(hopping), std::end(hopping)});
+  std::vector<int> runs(dots);
+  bool ok = true;
+  for (int f = 0; f < frames; ++f) {
+    std::fill(runs.begin(), runs.end(), 0);
+    scheduler.BeginFrame(dt, dots);
+    scheduler.RunLane(
+        0, dots,
+        [&](int i) { return (f + i) % 37 < 5 ? 0.0f : 1e6f; },
+        [&](int i, float step) {
+          ok = ok && ++runs[i] == 1 && step > 0.0f;
+        });
+    scheduler.EndFrame();
+  }
+  return ok;
+}
+
+static double MedianTime(int dots, int frames, int runs, double budget) {
+  std::vector<double> times;
+  for (int r = 0; r < runs; ++r) {
+    AiScheduler scheduler(budget, {std::begin(bands), std::end(bands)});
+    times.push_back(budget < 0.0
+                        ? Run(dots, frames, nullptr, nullptr, nullptr)
+                              .microsecondsPerFrame
+                        : Run(dots, frames, &scheduler, nullptr, nullptr)
+                              .microsecondsPerFrame);
+  }
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+int main(int argc, char **argv) {
+  int dots = argc > 1 ? atoi(argv[1]) : 5000;
+  int frames = argc > 2 ? atoi(argv[2]) : 120;
+  int runs = argc > 3 ? atoi(argv[3]) : 15;
+  const double generous = 1000.0, tight = 15.0; // Budgets, us
+
+  // Positions from the full update, then each scheduled run against them
+  std::vector<World> full;
+  Run(dots, frames, nullptr, &full, nullptr);
+  AiScheduler lod(generous, {std::begin(bands), std::end(bands)});
+  RunResult scheduled = Run(dots, frames, &lod, nullptr, &full);
+  AiScheduler squeezed(tight, {std::begin(bands), std::end(bands)});
+  RunResult spilled = Run(dots, frames, &squeezed, nullptr, &full);
+
+  double fullUs = MedianTime(dots, frames, runs, -1.0);
+  double lodUs = MedianTime(dots, frames, runs, generous);
+  double tightUs = MedianTime(dots, frames, runs, tight);
+
+  printf("%d dots, %d frames (median of %d runs), bands 250 px every "
+         "tick, 450 px every 2nd, beyond every 4th\n",
+         dots, frames, runs);
+  printf("                         AI us/frame  near/frame  far/frame  "
+         "deferred  near error px\n");
+  printf("every dot every tick     %10.1f  %10d  %9d  %8d  %13s\n", fullUs,
+         dots, 0, 0, "-");
+  printf("scheduled, %4.0f us budget %9.1f  %10.0f  %9.0f  %8.0f  %13.4f\n",
+         generous, lodUs, scheduled.nearRan, scheduled.farRan,
+         scheduled.deferred, scheduled.nearError);
+  printf("scheduled, %4.0f us budget %9.1f  %10.0f  %9.0f  %8.0f  %13.4f\n",
+         tight, tightUs, spilled.nearRan, spilled.farRan, spilled.deferred,
+         spilled.nearError);
+  printf("saved: %.1f us/frame (%.0f%%)\n", fullUs - lodUs,
+         (fullUs - lodUs) * 100.0 / fullUs);
+
+  bool once = RunsOncePerTick(dots, frames);
+  printf("near to every %dth tick and back: %s\n", AiScheduler::wheelSize,
+         once ? "at most one run per tick" : "RAN TWICE");
+  return once ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+// cull_bench.cpp
+//
+// View culling (spatial_grid.h, view_culler.h) at 1M dots in a toroidal
+// world of 50x50 screens, against walking every dot as Game::Render did.
+// Render prep is everything a frame spends before BeginDrawing: finding
+// what to draw, recording it into a RenderQueue and sorting the queue.
+// The grid path pays for rebuilding the grid too, as Game::Update does
+// every frame. Per camera:
+//   visible  - dots listed (wrapped copies counted once each) and their
+//              share of the crowd
+//   cull     - cull through a built grid, then record and sort
+//   grid     - the same plus the rebuild: the grid path's frame
+//   all      - test every dot against the view, then record and sort
+// Cameras: an 800x600 view mid-world, the same over the corner where the
+// world wraps (four copies), zoomed out 4x and 10x, and rotated. The
+// rebuild is paid once a frame however many cameras look, so 'cull' is
+// what each further camera adds. Both paths must list the same dots.
+// Needs raylib.h for Camera2D and the queue's types, but not the library.
+//
+// Usage: cull_bench [dots] [frames]
+
+#include "../render_queue.h"
+#include "../spatial_grid.h"
+#include "../view_culler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+const float screenWidth = 800.0f;
+const float screenHeight = 600.0f;
+const float worldWidth = 50 * screenWidth;
+const float worldHeight = 50 * screenHeight;
+// About a third of the view: a 800x600 query covers a dozen cells, and
+// the rebuild's per-cell counts stay small enough to sit in cache
+const float cellSize = 256.0f;
+
+struct BenchDot {
+  Vector2 position;
+  float radius;
+  Color color;
+};
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+// Dot::Draw, with the wrapped copy's offset
+static inline void Draw(RenderQueue &queue, const BenchDot &dot,
+                        Vector2 offset) {
+  queue.PushCircle(LayerWorld, 0,
+                   {dot.position.x + offset.x, dot.position.y + offset.y},
+                   dot.radius, dot.color);
+}
+
+// The old way: every dot against every copy of the world the view
+// touches, the same bounding box test as ViewCuller
+static void CullAll(const std::vector<BenchDot> &dots, const CullRect &view,
+                    float maxRadius, std::vector<VisibleDot> &out) {
+  out.clear();
+  int firstX = (int)std::floor((view.left - maxRadius) / worldWidth);
+  int lastX = (int)std::floor((view.right + maxRadius) / worldWidth);
+  int firstY = (int)std::floor((view.top - maxRadius) / worldHeight);
+  int lastY = (int)std::floor((view.bottom + maxRadius) / worldHeight);
+  for (int i = 0; i < (int)dots.size(); ++i) {
+    const BenchDot &d = dots[i];
+    for (int cy = firstY; cy <= lastY; ++cy) {
+      for (int cx = firstX; cx <= lastX; ++cx) {
+        float x = d.position.x + cx * worldWidth;
+        float y = d.position.y + cy * worldHeight;
+        if (x + d.radius >= view.left && x - d.radius <= view.right &&
+            y + d.radius >= view.top && y - d.radius <= view.bottom)
+          out.push_back({i, {cx * worldWidth, cy * worldHeight}});
+      }
+    }
+  }
+}
+
+static bool SameDots(std::vector<VisibleDot> a, std::vector<VisibleDot> b) {
+  auto less = [](const VisibleDot &p, const VisibleDot &q) {
+    if (p.index != q.index)
+      return p.index < q.index;
+    if (p.offset.x != q.offset.x)
+      return p.offset.x < q.offset.x;
+    return p.offset.y < q.offset.y;
+  };
+  std::sort(a.begin(), a.end(), less);
+  std::sort(b.begin(), b.end(), less);
+  if (a.size() != b.size())
+    return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].index != b[i].index || a[i].offset.x != b[i].offset.x ||
+        a[i].offset.y != b[i].offset.y)
+      return false;
+  }
+  return true;
+}
+
+struct Shot {
+  const char *name;
+  Vector2 target; // Where the camera starts; it pans right and down
+  float zoom;
+  float rotation;
+};
+
+int main(int argc, char **argv) {
+  int count = argc > 1 ? atoi(argv[1]) : 1000000;
+  int frames = argc > 2 ? atoi(argv[2]) : 60;
+
+  std::mt19937 rng(7u);
+  std::uniform_real_distribution<float> x(0.0f, worldWidth);
+  std::uniform_real_distribution<float> y(0.0f, worldHeight);
+  std::uniform_real_distribution<float> radius(10.0f, 12.0f);
+  std::vector<BenchDot> dots(count);
+  std::vector<float> dotX(count), dotY(count), dotRadius(count);
+  for (int i = 0; i < count; ++i) {
+    dots[i] = {{x(rng), y(rng)}, radius(rng), i % 2 ? RED : DARKGREEN};
+    dotX[i] = dots[i].position.x;
+    dotY[i] = dots[i].position.y;
+    dotRadius[i] = dots[i].radius;
+  }
+
+  SpatialGrid grid(worldWidth, worldHeight, cellSize);
+  grid.Reserve(count);
+
+  printf("%d dots, world %.0fx%.0f (wraps), %d cells of %.0f px, "
+         "%d frames per camera\n",
+         count, worldWidth, worldHeight, grid.GetCellCount(), cellSize,
+         frames);
+  printf("camera         visible  ratio     tested  copies  cull ms  grid ms"
+         "   all ms  speedup\n");
+
+  const Shot shots[] = {
+      {"centre", {worldWidth / 2, worldHeight / 2}, 1.0f, 0.0f},
+      {"wrap corner", {0.0f, 0.0f}, 1.0f, 0.0f},
+      {"zoom 1/4", {worldWidth / 2, worldHeight / 2}, 0.25f, 0.0f},
+      {"zoom 1/10", {worldWidth / 2, worldHeight / 2}, 0.1f, 0.0f},
+      {"rotated 30", {worldWidth / 2, worldHeight / 2}, 1.0f, 30.0f},
+  };
+  ViewCuller culler(true);
+  RenderQueue queue;
+  std::vector<VisibleDot> all;
+  int mismatches = 0;
+  for (const Shot &shot : shots) {
+    std::vector<double> buildTimes, cullTimes, gridTimes, allTimes;
+    long long visible = 0, tested = 0, copies = 0;
+    for (int f = 0; f < frames; ++f) {
+      Camera2D camera = {{screenWidth / 2, screenHeight / 2},
+                         {shot.target.x + f * 3.0f, shot.target.y + f * 2.0f},
+                         shot.rotation, shot.zoom};
+
+      Clock::time_point start = Clock::now();
+      grid.Build(dotX.data(), dotY.data(), dotRadius.data(), count);
+      buildTimes.push_back(Seconds(start));
+      start = Clock::now();
+      queue.Clear();
+      culler.Cull(grid, camera, screenWidth, screenHeight);
+      for (const VisibleDot &v : culler.GetVisible())
+        Draw(queue, dots[v.index], v.offset);
+      queue.Sort();
+      cullTimes.push_back(Seconds(start));
+      gridTimes.push_back(buildTimes.back() + cullTimes.back());
+
+      start = Clock::now();
+      queue.Clear();
+      CullAll(dots, CameraWorldRect(camera, screenWidth, screenHeight),
+              grid.GetMaxRadius(), all);
+      for (const VisibleDot &v : all)
+        Draw(queue, dots[v.index], v.offset);
+      queue.Sort();
+      allTimes.push_back(Seconds(start));
+
+      visible += culler.GetVisibleCount();
+      tested += culler.GetTested();
+      copies += culler.GetCopies();
+      if (!SameDots(culler.GetVisible(), all))
+        mismatches++;
+    }
+    double cullMs = Median(cullTimes) * 1e3, gridMs = Median(gridTimes) * 1e3;
+    double allMs = Median(allTimes) * 1e3;
+    printf("%-12s %9.0f %5.2f%% %10.0f %7.1f %8.3f %8.3f %8.3f %7.2fx\n",
+           shot.name, (double)visible / frames,
+           100.0 * visible / frames / count, (double)tested / frames,
+           (double)copies / frames, cullMs, gridMs, allMs, allMs / gridMs);
+  }
+  printf("mismatched frames: %d\n", mismatches);
+  return mismatches ? 1 : 0;
+}
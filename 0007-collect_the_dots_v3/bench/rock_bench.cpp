@@ -0,0 +1,238 @@
+// rock_bench.cpp
+//
+// Asteroids-style rocks (rock_field.h) under sustained fire: 20k rocks of
+// mixed sizes drift through a wrapping world of 25x25 screens while guns
+// scattered over it fire every frame. Hit rocks break into smaller ones
+// from the pool, so the crowd grows past 20k as they split; whenever
+// fewer than the target are left, big rocks are spawned to make up the
+// numbers. Per phase of a frame, mean and p99:
+//   move     - rocks and bullets advance and wrap
+//   index    - the grid rebuild
+//   collide  - broadphase across the seams, circles, SAT, response
+//   shoot    - bullets against the rocks around them, then the splits
+// Heap allocations are counted over the timed frames, by replacing
+// operator new; the pool and grid must need none. Before the run, and
+// again after it, the broadphase's overlapping pairs are checked against
+// every pair of rocks measured the short way round the world.
+//
+// Usage: rock_bench [rocks] [frames] [guns]
+
+#include "../rock_field.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static std::atomic<long long> allocations{0};
+
+void *operator new(size_t size) {
+  allocations++;
+  if (void *p = malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { free(p); }
+
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+const float worldWidth = 25 * 800.0f;
+const float worldHeight = 25 * 600.0f;
+const float frameTime = 1.0f / 60.0f;
+const float bulletSpeed = 500.0f;
+const float bulletLife = 1.5f;
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Timings {
+  std::vector<double> samples;
+
+  void Add(Clock::time_point start) { samples.push_back(Seconds(start)); }
+
+  void Report(const char *name) {
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double s : samples)
+      sum += s;
+    printf("%-8s %8.3f %8.3f %8.3f\n", name, sum / samples.size() * 1e3,
+           samples[samples.size() * 99 / 100] * 1e3, samples.back() * 1e3);
+  }
+};
+
+// xorshift, as the field uses, so the setup allocates nothing either
+struct BenchRandom {
+  uint32_t state = 2463534242u;
+
+  float Next() {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (state >> 8) * (1.0f / 16777216.0f);
+  }
+};
+
+static RockVec RandomPoint(BenchRandom &rng) {
+  return {rng.Next() * worldWidth, rng.Next() * worldHeight};
+}
+
+static RockVec RandomVelocity(BenchRandom &rng, float speed) {
+  float angle = rng.Next() * 6.28318531f;
+  float s = speed * (0.3f + 0.7f * rng.Next());
+  return {cosf(angle) * s, sinf(angle) * s};
+}
+
+// Overlapping bounding circles among the live rocks, by the grid and by
+// testing every pair; both must find the same pairs
+static bool CheckPairs(const RockField &field) {
+  const RockPool &pool = field.GetPool();
+  const std::vector<int> &live = pool.GetLive();
+  int count = (int)live.size();
+  std::vector<float> x(count), y(count), radius(count);
+  for (int i = 0; i < count; ++i) {
+    x[i] = pool.Get(live[i]).position.x;
+    y[i] = pool.Get(live[i]).position.y;
+    radius[i] = pool.Get(live[i]).radius;
+  }
+  auto overlaps = [&](int i, int j) {
+    float dx = WrapDelta(x[j] - x[i], worldWidth);
+    float dy = WrapDelta(y[j] - y[i], worldHeight);
+    float reach = radius[i] + radius[j];
+    return dx * dx + dy * dy < reach * reach;
+  };
+
+  Clock::time_point start = Clock::now();
+  std::vector<std::pair<int, int>> brute;
+  for (int i = 0; i < count; ++i) {
+    for (int j = i + 1; j < count; ++j) {
+      if (overlaps(i, j))
+        brute.push_back({i, j});
+    }
+  }
+  double bruteTime = Seconds(start);
+
+  start = Clock::now();
+  SpatialGrid grid(worldWidth, worldHeight, 2.0f * rockRadii[rockSizes - 1]);
+  grid.Build(x.data(), y.data(), radius.data(), count);
+  std::vector<std::pair<int, int>> near;
+  int seam = 0; // Pairs that only touch across the world's edge
+  grid.ForEachNearPair(true, [&](const GridItem &p, const GridItem &q) {
+    if (!overlaps(p.index, q.index))
+      return;
+    near.push_back({std::min(p.index, q.index), std::max(p.index, q.index)});
+    if (fabsf(q.x - p.x) > worldWidth * 0.5f ||
+        fabsf(q.y - p.y) > worldHeight * 0.5f)
+      seam++;
+  });
+  double gridTime = Seconds(start);
+
+  std::sort(near.begin(), near.end());
+  bool same = near == brute;
+  printf("pairs %d rocks: %zu overlapping (%d across the seam), grid %zu; "
+         "all pairs %.1f ms, grid %.2f ms: %s\n",
+         count, brute.size(), seam, near.size(), bruteTime * 1e3,
+         gridTime * 1e3, same ? "same" : "MISMATCH");
+  return same;
+}
+
+int main(int argc, char **argv) {
+  int target = argc > 1 ? atoi(argv[1]) : 20000;
+  int frames = argc > 2 ? atoi(argv[2]) : 600;
+  int guns = argc > 3 ? atoi(argv[3]) : 200;
+  const int warmup = 120; // Until the bullets in flight level off
+
+  // Room for a wave of splits on top of the target, and for every bullet
+  // the guns can have in flight
+  int bulletCapacity = (int)(guns * bulletLife / frameTime) + guns;
+  RockField field(worldWidth, worldHeight, target * 2, bulletCapacity, 7u);
+  BenchRandom rng;
+  std::vector<RockVec> gunAt(guns);
+  for (RockVec &gun : gunAt)
+    gun = RandomPoint(rng);
+  for (int i = 0; i < target; ++i)
+    field.SpawnRock(RandomPoint(rng), RandomVelocity(rng, 60.0f),
+                    (int)(rng.Next() * rockSizes));
+
+  field.Index();
+  bool ok = CheckPairs(field);
+
+  Timings move, index, collide, shoot, total;
+  for (Timings *t : {&move, &index, &collide, &shoot, &total})
+    t->samples.reserve(frames);
+  long long nearPairs = 0, circlePairs = 0, contacts = 0, hits = 0;
+  long long splitsBefore = 0, spawned = 0, allocationsBefore = 0;
+  int fewest = target * 2, most = 0;
+  for (int frame = 0; frame < warmup + frames; ++frame) {
+    if (frame == warmup) {
+      splitsBefore = field.GetSplits();
+      allocationsBefore = allocations;
+    }
+    bool timed = frame >= warmup;
+
+    // Top up with big rocks, then every gun fires once
+    while (field.GetPool().GetLiveCount() < target) {
+      field.SpawnRock(RandomPoint(rng), RandomVelocity(rng, 60.0f),
+                      rockSizes - 1);
+      if (timed)
+        spawned++;
+    }
+    for (const RockVec &gun : gunAt)
+      field.Fire(gun, RandomVelocity(rng, bulletSpeed), bulletLife);
+
+    Clock::time_point start = Clock::now(), phase = start;
+    field.Move(frameTime);
+    if (timed)
+      move.Add(phase);
+    phase = Clock::now();
+    field.Index();
+    if (timed)
+      index.Add(phase);
+    phase = Clock::now();
+    field.CollideRocks();
+    if (timed)
+      collide.Add(phase);
+    phase = Clock::now();
+    field.Shoot();
+    if (!timed)
+      continue;
+    shoot.Add(phase);
+    total.Add(start);
+    nearPairs += field.GetNearPairs();
+    circlePairs += field.GetCirclePairs();
+    contacts += field.GetContacts();
+    hits += field.GetHits();
+    fewest = std::min(fewest, field.GetPool().GetLiveCount());
+    most = std::max(most, field.GetPool().GetLiveCount());
+  }
+  long long frameAllocations = allocations - allocationsBefore;
+  long long splits = field.GetSplits() - splitsBefore;
+
+  printf("%d rocks (%d to %d live), %d guns, %zu bullets in flight, "
+         "%d frames\n",
+         target, fewest, most, guns, field.GetBullets().size(), frames);
+  printf("phase     mean ms   p99 ms   max ms\n");
+  move.Report("move");
+  index.Report("index");
+  collide.Report("collide");
+  shoot.Report("shoot");
+  total.Report("frame");
+  printf("per frame: %.0f near pairs, %.0f circles overlap, %.1f contacts "
+         "(SAT), %.1f hits, %.1f splits, %.1f rocks topped up\n",
+         (double)nearPairs / frames, (double)circlePairs / frames,
+         (double)contacts / frames, (double)hits / frames,
+         (double)splits / frames, (double)spawned / frames);
+  printf("heap allocations over the timed frames: %lld; pool full %lld "
+         "times\n",
+         frameAllocations, field.GetSpawnFailures());
+
+  field.Index();
+  ok = CheckPairs(field) && ok;
+  return ok && frameAllocations == 0 ? 0 : 1;
+}
@@ -0,0 +1,309 @@
+// solver_bench.cpp
+//
+// The overlap solver (overlap_solver.h) against the pairwise push it
+// replaced, on a crowd of enemies closing in on a still player:
+//   scaling     - Solve time per frame by thread count and iterations
+//   determinism - positions after a solve, compared bit for bit across
+//                 thread counts and with the pairs shuffled or reversed
+//   quality     - overlap left after a frame's solve, and jitter: how far
+//                 a dot still moves per frame once the crowd has settled
+//   lone pair   - two overlapping dots with nothing else near must end
+//                 exactly touching, for any iteration count (no pop)
+// The seek and push math copies Enemy::Control and the old
+// ResolveSeparate in main.cpp. Needs no raylib, so it builds and runs
+// headless.
+//
+// Usage: solver_bench [dots] [frames] [repeats]
+
+#include "../overlap_solver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+const float playerX = 400.0f, playerY = 300.0f;
+const float enemyRadius = 12.0f, enemySpeed = 120.0f;
+const float dt = 1.0f / 60.0f;
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Crowd {
+  std::vector<float> x, y, radius;
+  int Count() const { return (int)x.size(); }
+};
+
+static Crowd MakeCrowd(int count, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+  Crowd crowd;
+  for (int i = 0; i < count; ++i) {
+    // Scattered over a ring around the player, so they all close in
+    float angle = unit(rng) * 6.2831853f;
+    float distance = 150.0f + unit(rng) * 250.0f;
+    crowd.x.push_back(playerX + cosf(angle) * distance);
+    crowd.y.push_back(playerY + sinf(angle) * distance);
+    crowd.radius.push_back(enemyRadius);
+  }
+  return crowd;
+}
+
+// Enemy::Control: straight at the player
+static void Seek(Crowd &crowd) {
+  for (int i = 0; i < crowd.Count(); ++i) {
+    float dx = playerX - crowd.x[i], dy = playerY - crowd.y[i];
+    float dist = sqrtf(dx * dx + dy * dy);
+    if (dist > 0.01f) {
+      crowd.x[i] += dx / dist * enemySpeed * dt;
+      crowd.y[i] += dy / dist * enemySpeed * dt;
+    }
+  }
+}
+
+// Touching pairs, found through a uniform grid (the game tests all
+// pairs; this only keeps big crowds quick to set up), sorted
+static void FindPairs(const Crowd &crowd,
+                      std::vector<OverlapConstraint> &pairs) {
+  const float cell = enemyRadius * 2.0f;
+  const int columns = 2048;
+  std::vector<std::pair<long long, int>> keyed;
+  for (int i = 0; i < crowd.Count(); ++i) {
+    long long cx = (long long)floorf(crowd.x[i] / cell) + columns / 2;
+    long long cy = (long long)floorf(crowd.y[i] / cell) + columns / 2;
+    keyed.push_back({cy * columns + cx, i});
+  }
+  std::sort(keyed.begin(), keyed.end());
+  pairs.clear();
+  for (size_t k = 0; k < keyed.size(); ++k) {
+    int i = keyed[k].second;
+    long long key = keyed[k].first;
+    for (long long dy = -1; dy <= 1; ++dy) {
+      for (long long dx = -1; dx <= 1; ++dx) {
+        long long other = key + dy * columns + dx;
+        auto first = std::lower_bound(keyed.begin(), keyed.end(),
+                                      std::make_pair(other, -1));
+        for (auto it = first; it != keyed.end() && it->first == other; ++it) {
+          int j = it->second;
+          if (j <= i)
+            continue;
+          float ddx = crowd.x[j] - crowd.x[i], ddy = crowd.y[j] - crowd.y[i];
+          float reach = crowd.radius[i] + crowd.radius[j];
+          if (ddx * ddx + ddy * ddy < reach * reach)
+            pairs.push_back({i, j});
+        }
+      }
+    }
+  }
+  std::sort(pairs.begin(), pairs.end(),
+            [](const OverlapConstraint &p, const OverlapConstraint &q) {
+              return p.a != q.a ? p.a < q.a : p.b < q.b;
+            });
+}
+
+// The old ResolveSeparate: one pass, each push written back at once
+static void PairwisePush(Crowd &crowd,
+                         const std::vector<OverlapConstraint> &pairs) {
+  for (const OverlapConstraint &c : pairs) {
+    float dx = crowd.x[c.b] - crowd.x[c.a], dy = crowd.y[c.b] - crowd.y[c.a];
+    float dist = sqrtf(dx * dx + dy * dy);
+    if (dist == 0.0f)
+      continue; // Vector2Normalize of zero is zero: no push
+    float overlap = crowd.radius[c.a] + crowd.radius[c.b] - dist;
+    if (overlap > 0.0f) {
+      float scale = overlap * 0.5f / dist;
+      crowd.x[c.a] -= dx * scale;
+      crowd.y[c.a] -= dy * scale;
+      crowd.x[c.b] += dx * scale;
+      crowd.y[c.b] += dy * scale;
+    }
+  }
+}
+
+// Deepest overlap left among the given pairs (px)
+static float WorstOverlap(const Crowd &crowd,
+                          const std::vector<OverlapConstraint> &pairs) {
+  float worst = 0.0f;
+  for (const OverlapConstraint &c : pairs) {
+    float dx = crowd.x[c.b] - crowd.x[c.a], dy = crowd.y[c.b] - crowd.y[c.a];
+    float overlap =
+        crowd.radius[c.a] + crowd.radius[c.b] - sqrtf(dx * dx + dy * dy);
+    worst = std::max(worst, overlap);
+  }
+  return worst;
+}
+
+static bool SamePositions(const Crowd &a, const Crowd &b) {
+  return memcmp(a.x.data(), b.x.data(), a.x.size() * sizeof(float)) == 0 &&
+         memcmp(a.y.data(), b.y.data(), a.y.size() * sizeof(float)) == 0;
+}
+
+struct Quality {
+  float worstOverlap; // Median over the measured frames
+  double jitter;      // Mean distance moved per dot per frame (px)
+};
+
+// Runs the crowd in, then measures the last quarter of the frames.
+// solver == nullptr runs the pairwise push.
+static Quality Simulate(int count, int frames, OverlapSolver *solver) {
+  Crowd crowd = MakeCrowd(count, 7u);
+  std::vector<OverlapConstraint> pairs;
+  std::vector<float> overlaps;
+  double moved = 0.0;
+  long long samples = 0;
+  int settled = frames - frames / 4;
+  for (int f = 0; f < frames; ++f) {
+    Crowd before = crowd;
+    Seek(crowd);
+    FindPairs(crowd, pairs);
+    if (solver)
+      solver->Solve(crowd.x.data(), crowd.y.data(), crowd.radius.data(),
+                    count, pairs.data(), (int)pairs.size());
+    else
+      PairwisePush(crowd, pairs);
+    if (f < settled)
+      continue;
+    overlaps.push_back(WorstOverlap(crowd, pairs));
+    for (int i = 0; i < count; ++i) {
+      float dx = crowd.x[i] - before.x[i], dy = crowd.y[i] - before.y[i];
+      moved += sqrtf(dx * dx + dy * dy);
+      samples++;
+    }
+  }
+  std::sort(overlaps.begin(), overlaps.end());
+  return {overlaps[overlaps.size() / 2], moved / samples};
+}
+
+// Two dots overlapping by 'overlap' px, solved with nothing else around:
+// how far from touching they end up (px, negative when pushed too far)
+static float LonePairGap(int iterations, float overlap) {
+  float x[2] = {100.0f, 100.0f + 2.0f * enemyRadius - overlap};
+  float y[2] = {50.0f, 50.0f};
+  float radius[2] = {enemyRadius, enemyRadius};
+  OverlapConstraint pair = {0, 1};
+  OverlapSolver solver(1, iterations);
+  solver.Solve(x, y, radius, 2, &pair, 1);
+  return (x[1] - x[0]) - 2.0f * enemyRadius;
+}
+
+int main(int argc, char **argv) {
+  int count = argc > 1 ? atoi(argv[1]) : 2000;
+  int frames = argc > 2 ? atoi(argv[2]) : 400;
+  int repeats = argc > 3 ? atoi(argv[3]) : 50;
+
+  // A settled crowd, then one more frame of seeking: the frame to solve
+  Crowd crowd = MakeCrowd(count, 7u);
+  std::vector<OverlapConstraint> pairs;
+  {
+    OverlapSolver settle(1);
+    for (int f = 0; f < frames; ++f) {
+      Seek(crowd);
+      FindPairs(crowd, pairs);
+      settle.Solve(crowd.x.data(), crowd.y.data(), crowd.radius.data(), count,
+                   pairs.data(), (int)pairs.size());
+    }
+    Seek(crowd);
+    FindPairs(crowd, pairs);
+  }
+  printf("%d enemies crowding the player, %zu touching pairs in the "
+         "measured frame\n",
+         count, pairs.size());
+
+  // Scaling
+  const int threadCounts[] = {1, 2, 4, 8};
+  const int iterationCounts[] = {1, 4, 8};
+  printf("\nSolve, us/frame     ");
+  for (int threads : threadCounts)
+    printf("%4d thr", threads);
+  printf("\n");
+  for (int iterations : iterationCounts) {
+    printf("%2d iterations      ", iterations);
+    for (int threads : threadCounts) {
+      OverlapSolver solver(threads, iterations);
+      Crowd work = crowd;
+      solver.Solve(work.x.data(), work.y.data(), work.radius.data(), count,
+                   pairs.data(), (int)pairs.size()); // Warm the scratch
+      double best = 1e30;
+      for (int r = 0; r < repeats; ++r) {
+        work = crowd;
+        Clock::time_point start = Clock::now();
+        solver.Solve(work.x.data(), work.y.data(), work.radius.data(), count,
+                     pairs.data(), (int)pairs.size());
+        best = std::min(best, Seconds(start));
+      }
+      printf(" %7.1f", best * 1e6);
+    }
+    printf("\n");
+  }
+  {
+    Crowd work = crowd;
+    double best = 1e30;
+    for (int r = 0; r < repeats; ++r) {
+      work = crowd;
+      Clock::time_point start = Clock::now();
+      PairwisePush(work, pairs);
+      best = std::min(best, Seconds(start));
+    }
+    printf("pairwise push        %7.1f (one thread only)\n", best * 1e6);
+  }
+
+  // Determinism
+  std::vector<OverlapConstraint> reversed(pairs.rbegin(), pairs.rend());
+  std::vector<OverlapConstraint> shuffled = pairs;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(99u));
+  for (OverlapConstraint &c : shuffled)
+    std::swap(c.a, c.b); // Which end is 'a' shouldn't matter either
+  Crowd reference = crowd;
+  OverlapSolver(1).Solve(reference.x.data(), reference.y.data(),
+                         reference.radius.data(), count, pairs.data(),
+                         (int)pairs.size());
+  bool allSame = true;
+  for (int threads : threadCounts) {
+    for (const std::vector<OverlapConstraint> *order :
+         {&pairs, &reversed, &shuffled}) {
+      OverlapSolver solver(threads);
+      solver.SetGrain(64); // Smaller slices, so every thread takes part
+      Crowd work = crowd;
+      solver.Solve(work.x.data(), work.y.data(), work.radius.data(), count,
+                   order->data(), (int)order->size());
+      allSame = allSame && SamePositions(work, reference);
+    }
+  }
+  Crowd forward = crowd, backward = crowd;
+  PairwisePush(forward, pairs);
+  PairwisePush(backward, reversed);
+  printf("\nsolver, 1-8 threads x sorted/reversed/shuffled pairs: %s\n",
+         allSame ? "identical" : "DIFFERENT");
+  printf("pairwise push, sorted vs reversed pairs: %s\n",
+         SamePositions(forward, backward) ? "identical" : "different");
+
+  // Quality
+  printf("\n%d frames, last %d measured   overlap left px   jitter "
+         "px/frame\n",
+         frames, frames / 4);
+  Quality pairwise = Simulate(count, frames, nullptr);
+  printf("pairwise push                %10.2f %14.3f\n",
+         pairwise.worstOverlap, pairwise.jitter);
+  for (int iterations : iterationCounts) {
+    OverlapSolver solver(1, iterations);
+    Quality q = Simulate(count, frames, &solver);
+    printf("solver, %d iterations         %10.2f %14.3f\n", iterations,
+           q.worstOverlap, q.jitter);
+  }
+
+  // Lone pair
+  bool touching = true;
+  for (int iterations : iterationCounts) {
+    for (float overlap : {0.5f, 4.0f, 23.0f})
+      touching = touching && fabsf(LonePairGap(iterations, overlap)) < 1e-4f;
+  }
+  printf("\nlone overlapping pair, 1-8 iterations: %s\n",
+         touching ? "ends touching" : "OVERSHOOTS");
+  return allSame && touching ? 0 : 1;
+}
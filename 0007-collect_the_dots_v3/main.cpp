@@ -1,9 +1,21 @@
+#include "ai_scheduler.h"
+#include "overlap_solver.h"
+#include "render_queue.h"
+#include "spatial_grid.h"
+#include "view_culler.h"
 #include "raylib.h"
 #include "raymath.h" // Add this for vector math
+#include <algorithm>
+#include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <deque>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <new>
+#include <thread>
 #include <vector>
 
 #ifdef PLATFORM_WEB
@@ -14,8 +26,161 @@
 const int screenWidth = 800;
 const int screenHeight = 600;
 
+// Overlap solver: Jacobi iterations per frame, and at most this many
+// threads (small crowds stay on the calling thread anyway)
+const int solverIterations = 4;
+const int solverMaxThreads = 4;
+
+// AI level of detail. Targets only react to a player within 200 px, so
+// everything out to 250 px (200 plus what player and target cover in
+// four ticks) thinks every tick; farther dots think every 2nd or 4th
+// tick, within a per-frame budget for that far work.
+const AiBand aiBands[] = {{250.0f, 1}, {450.0f, 2}, {1e9f, 4}};
+const double aiBudgetMicroseconds = 1000.0;
+
+// View culling: the world the camera looks at, the grid's cell size, and
+// whether the world wraps at its edges (drawn tiled around the camera).
+// The world is the screen for now; the culler is built for bigger ones.
+const float worldWidth = (float)screenWidth;
+const float worldHeight = (float)screenHeight;
+const float cullCellSize = 64.0f;
+const bool worldWraps = false;
+
+// Poison freed frame memory so reads of last frame's data stand out.
+// On by default unless NDEBUG is defined.
+#ifndef NDEBUG
+#define FRAME_ARENA_POISON
+#endif
+
+// FrameArena: bump allocator for data that only lives for one frame.
+// Allocation is a pointer bump, individual frees are no-ops, and Reset()
+// releases everything at once at the end of the frame.
+class FrameArena {
+private:
+  std::unique_ptr<unsigned char[]> buffer;
+  size_t capacity;
+  size_t offset = 0;
+  size_t highWater = 0;     // Most bytes ever used in one frame
+  size_t overflowCount = 0; // Allocations that fell back to the heap
+
+  bool Owns(const void *p) const {
+    const unsigned char *byte = static_cast<const unsigned char *>(p);
+    return byte >= buffer.get() && byte < buffer.get() + capacity;
+  }
+
+public:
+  explicit FrameArena(size_t capacity)
+      : buffer(new unsigned char[capacity]), capacity(capacity) {}
+
+  void *Allocate(size_t size, size_t alignment) {
+    size_t start = (offset + alignment - 1) & ~(alignment - 1);
+    if (start + size > capacity) {
+      // Out of frame memory: stay correct, but count it so it gets noticed
+      overflowCount++;
+      return ::operator new(size);
+    }
+    offset = start + size;
+    if (offset > highWater)
+      highWater = offset;
+    return buffer.get() + start;
+  }
+
+  void Deallocate(void *p, size_t size) {
+    if (!Owns(p)) {
+      ::operator delete(p);
+      return;
+    }
+#ifdef FRAME_ARENA_POISON
+    std::memset(p, 0xDD, size);
+#endif
+  }
+
+  void Reset() {
+#ifdef FRAME_ARENA_POISON
+    std::memset(buffer.get(), 0xDD, offset);
+#endif
+    offset = 0;
+  }
+
+  size_t GetUsed() const { return offset; }
+
+  size_t GetHighWater() const { return highWater; }
+
+  size_t GetCapacity() const { return capacity; }
+
+  size_t GetOverflowCount() const { return overflowCount; }
+};
+
+// STL allocator adapter so standard containers can live in a FrameArena.
+// Containers using it must not outlive the frame they were created in.
+template <typename T> class FrameAllocator {
+public:
+  using value_type = T;
+
+  FrameArena *arena;
+
+  explicit FrameAllocator(FrameArena &arena) noexcept : arena(&arena) {}
+
+  template <typename U>
+  FrameAllocator(const FrameAllocator<U> &other) noexcept
+      : arena(other.arena) {}
+
+  T *allocate(size_t n) {
+    return static_cast<T *>(arena->Allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T *p, size_t n) noexcept {
+    arena->Deallocate(p, n * sizeof(T));
+  }
+
+  template <typename U> bool operator==(const FrameAllocator<U> &other) const {
+    return arena == other.arena;
+  }
+
+  template <typename U> bool operator!=(const FrameAllocator<U> &other) const {
+    return arena != other.arena;
+  }
+};
+
+template <typename T> using FrameVector = std::vector<T, FrameAllocator<T>>;
+
 // Base Dot class
 enum class DotType { Player, Target, Enemy, Other };
+const int dotTypeCount = 4;
+
+// What happens when two dots of the given types touch
+enum class CollisionResponse { None, Score, GameOver, Separate };
+const int collisionResponseCount = 4;
+
+// Response for every type pair, indexed [typeA][typeB]. Pairs marked None
+// are rejected before any distance math.
+const CollisionResponse collisionResponses[dotTypeCount][dotTypeCount] = {
+    // Player, Target, Enemy, Other
+    {CollisionResponse::Separate, CollisionResponse::Score,
+     CollisionResponse::GameOver, CollisionResponse::None}, // Player
+    {CollisionResponse::Score, CollisionResponse::Separate,
+     CollisionResponse::Separate, CollisionResponse::None}, // Target
+    {CollisionResponse::GameOver, CollisionResponse::Separate,
+     CollisionResponse::Separate, CollisionResponse::None}, // Enemy
+    {CollisionResponse::None, CollisionResponse::None, CollisionResponse::None,
+     CollisionResponse::None}, // Other
+};
+
+// Collision layer bit for a type
+inline unsigned int LayerBit(DotType type) {
+  return 1u << static_cast<int>(type);
+}
+
+// Layers a type collides with by default: every type it has a response for
+inline unsigned int DefaultMask(DotType type) {
+  unsigned int mask = 0;
+  for (int other = 0; other < dotTypeCount; ++other) {
+    if (collisionResponses[static_cast<int>(type)][other] !=
+        CollisionResponse::None)
+      mask |= 1u << other;
+  }
+  return mask;
+}
 
 class Dot {
 protected:
@@ -23,21 +188,31 @@ protected:
   float radius;
   Color color;
   DotType type;
+  unsigned int layer; // Layer bit this dot lives on
+  unsigned int mask;  // Layers this dot collides with
 
 public:
   Dot(Vector2 startPos, float radius, Color color, DotType type)
-      : position(startPos), radius(radius), color(color), type(type) {}
+      : position(startPos), radius(radius), color(color), type(type),
+        layer(LayerBit(type)), mask(DefaultMask(type)) {}
 
-  virtual void Control(float deltaTime,
-                       class PositionManager &positionManager) {
+  // Not virtual: PositionManager updates each dot type in its own batch
+  // and calls the derived type's Control directly, so the call is inlined.
+  // Types that don't define their own get these defaults.
+  void Control(float deltaTime, class PositionManager &positionManager) {
     // Default behavior: no movement
   }
 
-  virtual void HandleCollision(Dot *other) {
+  void HandleCollision(Dot *other) {
     // Default behavior: do nothing
   }
 
-  void Draw() const { DrawCircleV(position, radius, color); }
+  // Into the frame's queue; Game::Render draws it sorted. 'offset' moves
+  // a wrapped copy of the dot to the other side of the world.
+  void Draw(RenderQueue &queue, Vector2 offset = {0.0f, 0.0f}) const {
+    queue.PushCircle(LayerWorld, 0, Vector2Add(position, offset), radius,
+                     color);
+  }
 
   Vector2 GetPosition() const { return position; }
 
@@ -47,6 +222,12 @@ public:
 
   DotType GetType() const { return type; }
 
+  unsigned int GetLayer() const { return layer; }
+
+  unsigned int GetMask() const { return mask; }
+
+  void SetMask(unsigned int newMask) { mask = newMask; }
+
 protected:
   static Vector2 Vector2WeightedAttraction(Vector2 from, Vector2 to,
                                            float threshold, float weight) {
@@ -60,22 +241,121 @@ protected:
   }
 };
 
-// Forward declaration
+// Forward declarations
+class Player;
+class Target;
 class Enemy;
 
 // PositionManager class
 class PositionManager {
 private:
+  // Layer and mask are read through 'dot' when pairs are tested, so
+  // Dot::SetMask takes effect on the next Update
   struct DotEntry {
     Dot *dot;
-    DotType type;
+    DotType type; // Fixed for a dot's lifetime
+  };
+  // A touching pair waiting for its response
+  struct Contact {
+    Dot *dotA;
+    Dot *dotB;
+    DotType typeA;
+    int indexA; // Into dots
+    int indexB;
   };
-  std::vector<DotEntry> dots;
+  using ResponseHandler = void (PositionManager::*)(
+      const FrameVector<Contact> &contacts,
+      FrameVector<Dot *> &targetsToRespawn);
+
+  std::vector<DotEntry> dots; // All dots, for collisions
+  // The same dots split by type, so Control runs one type at a time
+  std::vector<Player *> players;
+  std::vector<Target *> targets;
+  std::vector<Enemy *> enemies;
   std::function<void()> onScoreIncrement;
   std::function<void()> onGameOver;
+  FrameArena *frameArena = nullptr; // Scratch memory for Update
+  OverlapSolver *overlapSolver = nullptr; // Separates touching dots
+  AiScheduler *aiScheduler = nullptr; // Null: every dot thinks every tick
+  int solvedConstraints = 0; // Pairs handed to the solver this frame
+  int culledPairs = 0; // Pairs rejected by layer/mask or response table
+  int testedPairs = 0; // Pairs that reached the circle test
+
+  void ResolveScore(const FrameVector<Contact> &contacts,
+                    FrameVector<Dot *> &targetsToRespawn) {
+    if (!onScoreIncrement) {
+      ResolveSeparate(contacts, targetsToRespawn);
+      return;
+    }
+    for (const Contact &c : contacts) {
+      onScoreIncrement();
+      // Mark the target for respawn
+      targetsToRespawn.push_back(c.typeA == DotType::Target ? c.dotA : c.dotB);
+    }
+  }
+
+  void ResolveGameOver(const FrameVector<Contact> &contacts,
+                       FrameVector<Dot *> &targetsToRespawn) {
+    if (!onGameOver) {
+      ResolveSeparate(contacts, targetsToRespawn);
+      return;
+    }
+    if (!contacts.empty())
+      onGameOver();
+  }
+
+  void ResolveSeparate(const FrameVector<Contact> &contacts,
+                       FrameVector<Dot *> &targetsToRespawn) {
+    // Every pair is solved together from the same starting positions, so
+    // the result doesn't depend on the order the pairs were found in
+    FrameAllocator<float> floatAllocator(*frameArena);
+    FrameVector<float> x(dots.size(), floatAllocator);
+    FrameVector<float> y(dots.size(), floatAllocator);
+    FrameVector<float> radius(dots.size(), floatAllocator);
+    for (size_t i = 0; i < dots.size(); ++i) {
+      Vector2 position = dots[i].dot->GetPosition();
+      x[i] = position.x;
+      y[i] = position.y;
+      radius[i] = dots[i].dot->GetRadius();
+    }
+    FrameVector<OverlapConstraint> constraints(floatAllocator);
+    constraints.reserve(contacts.size());
+    for (const Contact &c : contacts)
+      constraints.push_back({c.indexA, c.indexB});
+    overlapSolver->Solve(x.data(), y.data(), radius.data(), (int)dots.size(),
+                         constraints.data(), (int)constraints.size());
+    solvedConstraints += (int)constraints.size();
+    for (size_t i = 0; i < dots.size(); ++i)
+      dots[i].dot->SetPosition({x[i], y[i]});
+  }
+
+  void AddEntry(Dot *dot) {
+    dots.push_back({dot, dot->GetType()});
+  }
+
+  // Runs Control for one type with no virtual dispatch
+  template <typename T>
+  void ControlBatch(const std::vector<T *> &batch, float deltaTime);
+
+  // The same through aiScheduler: only the dots due this tick, each with
+  // the time since it last ran
+  template <typename T>
+  void ScheduleBatch(int lane, const std::vector<T *> &batch,
+                     Vector2 playerPos);
 
 public:
-  void AddDot(Dot *dot) { dots.push_back({dot, dot->GetType()}); }
+  void AddDot(Player *player);
+  void AddDot(Target *target);
+  void AddDot(Enemy *enemy);
+
+  // Forgets every dot, keeping the lists' capacity for the next round
+  void Clear() {
+    dots.clear();
+    players.clear();
+    targets.clear();
+    enemies.clear();
+    solvedConstraints = culledPairs = testedPairs = 0;
+  }
 
   void SetScoreIncrementCallback(const std::function<void()> &callback) {
     onScoreIncrement = callback;
@@ -85,61 +365,19 @@ public:
     onGameOver = callback;
   }
 
-  void Update(float deltaTime) {
-    // Track which targets need to be respawned this frame
-    std::vector<Dot *> targetsToRespawn;
-    // Check for collisions between all dots
-    for (size_t i = 0; i < dots.size(); ++i) {
-      for (size_t j = i + 1; j < dots.size(); ++j) {
-        Dot *dotA = dots[i].dot;
-        Dot *dotB = dots[j].dot;
-        DotType typeA = dots[i].type;
-        DotType typeB = dots[j].type;
-        if (CheckCollisionCircles(dotA->GetPosition(), dotA->GetRadius(),
-                                  dotB->GetPosition(), dotB->GetRadius())) {
-          // Only handle respawn/game over for player-target and player-enemy
-          if (onScoreIncrement &&
-              ((typeA == DotType::Player && typeB == DotType::Target) ||
-               (typeA == DotType::Target && typeB == DotType::Player))) {
-            onScoreIncrement();
-            // Mark the target for respawn
-            if (typeA == DotType::Target)
-              targetsToRespawn.push_back(dotA);
-            if (typeB == DotType::Target)
-              targetsToRespawn.push_back(dotB);
-          } else if (onGameOver &&
-                     ((typeA == DotType::Player && typeB == DotType::Enemy) ||
-                      (typeA == DotType::Enemy && typeB == DotType::Player))) {
-            onGameOver();
-          } else {
-            // For all other collisions, resolve overlap (simple elastic push)
-            Vector2 posA = dotA->GetPosition();
-            Vector2 posB = dotB->GetPosition();
-            float rA = dotA->GetRadius();
-            float rB = dotB->GetRadius();
-            Vector2 delta = Vector2Subtract(posB, posA);
-            float dist = Vector2Length(delta);
-            if (dist == 0)
-              dist = 0.01f; // Prevent div by zero
-            float overlap = (rA + rB) - dist;
-            if (overlap > 0) {
-              Vector2 push =
-                  Vector2Scale(Vector2Normalize(delta), overlap / 2.0f);
-              dotA->SetPosition(Vector2Subtract(posA, push));
-              dotB->SetPosition(Vector2Add(posB, push));
-            }
-          }
-        }
-      }
-    }
-    // Respawn all targets that were collected this frame
-    for (Dot *t : targetsToRespawn) {
-      t->SetPosition(this->GetValidPosition(t->GetRadius()));
-    }
-    for (auto &entry : dots) {
-      entry.dot->Control(deltaTime, *this);
-    }
-  }
+  void SetFrameArena(FrameArena *arena) { frameArena = arena; }
+
+  void SetOverlapSolver(OverlapSolver *solver) { overlapSolver = solver; }
+
+  void SetAiScheduler(AiScheduler *scheduler) { aiScheduler = scheduler; }
+
+  int GetSolvedConstraints() const { return solvedConstraints; }
+
+  int GetCulledPairs() const { return culledPairs; }
+
+  int GetTestedPairs() const { return testedPairs; }
+
+  void Update(float deltaTime);
 
   bool IsPositionValid(Vector2 newPos, float radius) const {
     for (const auto &entry : dots) {
@@ -174,13 +412,7 @@ public:
     return newPos;
   }
 
-  Vector2 GetPlayerPosition() const {
-    for (const auto &entry : dots) {
-      if (entry.type == DotType::Player)
-        return entry.dot->GetPosition();
-    }
-    return {0, 0};
-  }
+  Vector2 GetPlayerPosition() const;
 };
 
 // Player class (inherits from Dot)
@@ -192,9 +424,7 @@ public:
   Player(Vector2 startPos, float radius, Color color, float speed)
       : Dot(startPos, radius, color, DotType::Player), speed(speed) {}
 
-  virtual ~Player() {}
-
-  void Control(float deltaTime, PositionManager &positionManager) override {
+  void Control(float deltaTime, PositionManager &positionManager) {
     Vector2 newPos = position;
 
     if (IsKeyDown(KEY_W))
@@ -210,7 +440,7 @@ public:
     position = positionManager.UpdatePosition(this, newPos, radius);
   }
 
-  void HandleCollision(Dot *other) override {
+  void HandleCollision(Dot *other) {
     // Player-specific collision handling (e.g., no special behavior for now)
   }
 };
@@ -221,9 +451,7 @@ public:
   Target(Vector2 startPos, float radius, Color color)
       : Dot(startPos, radius, color, DotType::Target) {}
 
-  virtual ~Target() {}
-
-  void Control(float deltaTime, PositionManager &positionManager) override {
+  void Control(float deltaTime, PositionManager &positionManager) {
     // Strong repulsion from player only
     Vector2 playerPos = positionManager.GetPlayerPosition();
     Vector2 repulsion =
@@ -243,7 +471,7 @@ public:
     position = positionManager.UpdatePosition(this, newPos, radius);
   }
 
-  void HandleCollision(Dot *other) override {
+  void HandleCollision(Dot *other) {
     // Only respawn if collided with player
     if (other->GetType() == DotType::Player) {
       position = {static_cast<float>(rand() % screenWidth),
@@ -263,9 +491,7 @@ public:
   Enemy(Vector2 startPos, float radius, Color color, float speed)
       : Dot(startPos, radius, color, DotType::Enemy), speed(speed) {}
 
-  virtual ~Enemy() {}
-
-  void Control(float deltaTime, PositionManager &positionManager) override {
+  void Control(float deltaTime, PositionManager &positionManager) {
     // Move towards the player
     Vector2 playerPos = positionManager.GetPlayerPosition();
     Vector2 direction = Vector2Subtract(playerPos, position);
@@ -278,41 +504,186 @@ public:
     }
   }
 
-  void HandleCollision(Dot *other) override {
+  void HandleCollision(Dot *other) {
     // Only end game if collided with player (handled in PositionManager)
     // Otherwise, do nothing (collision resolution is handled in
     // PositionManager)
   }
 };
 
+// PositionManager methods that need the complete dot types
+
+void PositionManager::AddDot(Player *player) {
+  AddEntry(player);
+  players.push_back(player);
+}
+
+void PositionManager::AddDot(Target *target) {
+  AddEntry(target);
+  targets.push_back(target);
+}
+
+void PositionManager::AddDot(Enemy *enemy) {
+  AddEntry(enemy);
+  enemies.push_back(enemy);
+}
+
+template <typename T>
+void PositionManager::ControlBatch(const std::vector<T *> &batch,
+                                   float deltaTime) {
+  for (T *dot : batch) {
+    dot->Control(deltaTime, *this);
+  }
+}
+
+template <typename T>
+void PositionManager::ScheduleBatch(int lane, const std::vector<T *> &batch,
+                                    Vector2 playerPos) {
+  aiScheduler->RunLane(
+      lane, (int)batch.size(),
+      [&](int i) {
+        return Vector2DistanceSqr(batch[i]->GetPosition(), playerPos);
+      },
+      [&](int i, float dt) { batch[i]->Control(dt, *this); });
+}
+
+Vector2 PositionManager::GetPlayerPosition() const {
+  return players.empty() ? Vector2{0, 0} : players.front()->GetPosition();
+}
+
+void PositionManager::Update(float deltaTime) {
+  // Per-frame lists live in the frame arena, so a steady frame does not
+  // touch the heap
+  FrameAllocator<Contact> contactAllocator(*frameArena);
+  // Track which targets need to be respawned this frame
+  FrameVector<Dot *> targetsToRespawn(contactAllocator);
+  // Touching pairs, grouped by response
+  FrameVector<Contact> contacts[collisionResponseCount] = {
+      FrameVector<Contact>(contactAllocator),
+      FrameVector<Contact>(contactAllocator),
+      FrameVector<Contact>(contactAllocator),
+      FrameVector<Contact>(contactAllocator)};
+  culledPairs = 0;
+  testedPairs = 0;
+  solvedConstraints = 0;
+  // Check for collisions between all dots
+  for (size_t i = 0; i < dots.size(); ++i) {
+    const DotEntry &a = dots[i];
+    unsigned int layerA = a.dot->GetLayer(), maskA = a.dot->GetMask();
+    for (size_t j = i + 1; j < dots.size(); ++j) {
+      const DotEntry &b = dots[j];
+      // Cull on layers and response before touching positions
+      CollisionResponse response = collisionResponses[static_cast<int>(
+          a.type)][static_cast<int>(b.type)];
+      if (response == CollisionResponse::None ||
+          !(maskA & b.dot->GetLayer()) || !(b.dot->GetMask() & layerA)) {
+        culledPairs++;
+        continue;
+      }
+      testedPairs++;
+      if (CheckCollisionCircles(a.dot->GetPosition(), a.dot->GetRadius(),
+                                b.dot->GetPosition(), b.dot->GetRadius())) {
+        contacts[static_cast<int>(response)].push_back(
+            {a.dot, b.dot, a.type, (int)i, (int)j});
+      }
+    }
+  }
+  // Run each response once over its whole batch
+  static const ResponseHandler responseHandlers[collisionResponseCount] = {
+      nullptr, &PositionManager::ResolveScore,
+      &PositionManager::ResolveGameOver, &PositionManager::ResolveSeparate};
+  for (int r = 0; r < collisionResponseCount; ++r) {
+    if (responseHandlers[r] && !contacts[r].empty())
+      (this->*responseHandlers[r])(contacts[r], targetsToRespawn);
+  }
+  // Respawn all targets that were collected this frame
+  for (Dot *t : targetsToRespawn) {
+    t->SetPosition(this->GetValidPosition(t->GetRadius()));
+  }
+  // One tight loop per type instead of interleaved virtual calls. The
+  // player moves first, as it always has, so the others chase where it
+  // is this frame; far targets and enemies think less often.
+  ControlBatch(players, deltaTime);
+  if (aiScheduler) {
+    Vector2 playerPos = GetPlayerPosition();
+    aiScheduler->BeginFrame(deltaTime, (int)(targets.size() + enemies.size()));
+    ScheduleBatch(0, targets, playerPos);
+    ScheduleBatch(1, enemies, playerPos);
+    aiScheduler->EndFrame();
+  } else {
+    ControlBatch(targets, deltaTime);
+    ControlBatch(enemies, deltaTime);
+  }
+}
+
 // Game class
 class Game {
 private:
   std::unique_ptr<Player> player;
-  std::vector<std::unique_ptr<Target>> targets;
-  std::vector<std::unique_ptr<Enemy>> enemies;
+  // Stored by value, grouped by type; deque keeps addresses stable as dots
+  // are added, so PositionManager can hold pointers to them
+  std::deque<Target> targets;
+  std::deque<Enemy> enemies;
   PositionManager positionManager;
+  FrameArena frameArena; // Reset at the end of every Run()
+  OverlapSolver overlapSolver;
+  AiScheduler aiScheduler;
+  RenderQueue renderQueue; // This frame's draws, cleared by Render
+  Camera2D camera;          // World to screen; identity while world = screen
+  SpatialGrid dotGrid;      // Targets and enemies, rebuilt every Update
+  ViewCuller viewCuller;    // What the camera sees, from dotGrid
+  // Grid index -> dot, and the positions Build reads; kept between frames
+  std::vector<const Dot *> gridDots;
+  std::vector<float> gridX;
+  std::vector<float> gridY;
+  std::vector<float> gridRadius;
   int score;
   bool gameOver;
 
   void InitGameObjects();
   void AddTarget();
   void AddEnemy();
+  void IndexDots();
 
 public:
   Game();
   void Reset();
   void Update(float deltaTime);
   void Render();
+  void Run();
 };
 
 // Definitions for Game methods
-Game::Game() : score(0), gameOver(false) { InitGameObjects(); }
+// Hardware threads, capped; 1 when unknown
+static int SolverThreads() {
+  int threads = (int)std::thread::hardware_concurrency();
+  return threads < 1 ? 1 : std::min(threads, solverMaxThreads);
+}
+
+Game::Game()
+    : frameArena(64 * 1024), overlapSolver(SolverThreads(), solverIterations),
+      aiScheduler(aiBudgetMicroseconds,
+                  std::vector<AiBand>(std::begin(aiBands), std::end(aiBands))),
+      camera{{0.0f, 0.0f}, {0.0f, 0.0f}, 0.0f, 1.0f},
+      dotGrid(worldWidth, worldHeight, cullCellSize), viewCuller(worldWraps),
+      score(0), gameOver(false) {
+  InitGameObjects();
+  IndexDots();
+}
 
 void Game::InitGameObjects() {
-  player = std::make_unique<Player>(
-      Vector2{screenWidth / 2.0f, screenHeight / 2.0f}, 15.0f, BLUE, 200.0f);
-  positionManager = PositionManager();
+  // Reused on restart, like the lists below, so R doesn't allocate
+  Player fresh(Vector2{screenWidth / 2.0f, screenHeight / 2.0f}, 15.0f, BLUE,
+               200.0f);
+  if (player)
+    *player = fresh;
+  else
+    player = std::make_unique<Player>(fresh);
+  positionManager.Clear();
+  positionManager.SetFrameArena(&frameArena);
+  positionManager.SetOverlapSolver(&overlapSolver);
+  aiScheduler.Reset();
+  positionManager.SetAiScheduler(&aiScheduler);
   targets.clear();
   enemies.clear();
   AddTarget();
@@ -327,17 +698,14 @@ void Game::InitGameObjects() {
 }
 
 void Game::AddTarget() {
-  auto t = std::make_unique<Target>(positionManager.GetValidPosition(10.0f),
-                                    10.0f, RED);
-  positionManager.AddDot(t.get());
-  targets.push_back(std::move(t));
+  targets.emplace_back(positionManager.GetValidPosition(10.0f), 10.0f, RED);
+  positionManager.AddDot(&targets.back());
 }
 
 void Game::AddEnemy() {
-  auto e = std::make_unique<Enemy>(positionManager.GetValidPosition(12.0f),
-                                   12.0f, DARKGREEN, 120.0f);
-  positionManager.AddDot(e.get());
-  enemies.push_back(std::move(e));
+  enemies.emplace_back(positionManager.GetValidPosition(12.0f), 12.0f,
+                       DARKGREEN, 120.0f);
+  positionManager.AddDot(&enemies.back());
 }
 
 void Game::Reset() {
@@ -354,37 +722,112 @@ void Game::Update(float deltaTime) {
       Reset();
     }
   }
+  IndexDots();
+}
+
+// Puts every target and enemy in dotGrid where it is now. This walks the
+// whole crowd once a frame (after the AI has moved it anyway); Render then
+// only asks the grid for what the camera sees.
+void Game::IndexDots() {
+  gridDots.clear();
+  gridX.clear();
+  gridY.clear();
+  gridRadius.clear();
+  auto add = [this](const Dot &dot) {
+    Vector2 position = dot.GetPosition();
+    gridDots.push_back(&dot);
+    gridX.push_back(position.x);
+    gridY.push_back(position.y);
+    gridRadius.push_back(dot.GetRadius());
+  };
+  for (const auto &t : targets)
+    add(t);
+  for (const auto &e : enemies)
+    add(e);
+  dotGrid.Build(gridX.data(), gridY.data(), gridRadius.data(),
+                (int)gridDots.size());
 }
 
 void Game::Render() {
-  BeginDrawing();
-  ClearBackground(RAYWHITE);
+  // Last frame's numbers, for the HUD
+  int lastCommands = renderQueue.GetCount();
+  int lastBatchBreaks = renderQueue.GetBatchBreaks();
+  renderQueue.Clear();
   if (gameOver) {
-    DrawText("Game Over!", screenWidth / 2 - 100, screenHeight / 2 - 40, 40,
-             RED);
-    DrawText(TextFormat("Final Score: %d", score), screenWidth / 2 - 100,
-             screenHeight / 2 + 10, 30, DARKGRAY);
-    DrawText("Press R to Restart", screenWidth / 2 - 120, screenHeight / 2 + 60,
-             28, DARKBLUE);
+    renderQueue.PushText(LayerOverlay, 0, "Game Over!", screenWidth / 2 - 100,
+                         screenHeight / 2 - 40, 40, RED);
+    renderQueue.PushText(LayerOverlay, 0, TextFormat("Final Score: %d", score),
+                         screenWidth / 2 - 100, screenHeight / 2 + 10, 30,
+                         DARKGRAY);
+    renderQueue.PushText(LayerOverlay, 0, "Press R to Restart",
+                         screenWidth / 2 - 120, screenHeight / 2 + 60, 28,
+                         DARKBLUE);
   } else {
-    DrawText("Catch the moving dot!", 10, 10, 20, DARKGRAY);
-    DrawText(TextFormat("Score: %d", score), 10, 40, 20, DARKGRAY);
-    player->Draw();
-    for (const auto &t : targets)
-      t->Draw();
-    for (const auto &e : enemies)
-      e->Draw();
+    // HUD first in code, drawn last: the layer decides
+    renderQueue.PushText(LayerHud, 0, "Catch the moving dot!", 10, 10, 20,
+                         DARKGRAY);
+    renderQueue.PushText(LayerHud, 0, TextFormat("Score: %d", score), 10, 40,
+                         20, DARKGRAY);
+    renderQueue.PushText(LayerHud, 0,
+                         TextFormat("Pairs culled: %d / %d",
+                                    positionManager.GetCulledPairs(),
+                                    positionManager.GetCulledPairs() +
+                                        positionManager.GetTestedPairs()),
+                         10, 70, 10, GRAY);
+    renderQueue.PushText(LayerHud, 0,
+                         TextFormat("Frame arena peak: %d / %d bytes",
+                                    (int)frameArena.GetHighWater(),
+                                    (int)frameArena.GetCapacity()),
+                         10, 82, 10, GRAY);
+    renderQueue.PushText(
+        LayerHud, 0,
+        TextFormat("Overlap solver: %d pairs, %d iterations, %d threads",
+                   positionManager.GetSolvedConstraints(),
+                   overlapSolver.GetIterations(),
+                   overlapSolver.GetThreadCount()),
+        10, 94, 10, GRAY);
+    renderQueue.PushText(
+        LayerHud, 0,
+        TextFormat("AI: %d near, %d far, %d waiting, %.0f us",
+                   aiScheduler.GetRanNear(), aiScheduler.GetRanFar(),
+                   aiScheduler.GetSkipped() + aiScheduler.GetDeferred(),
+                   aiScheduler.GetFrameMicroseconds()),
+        10, 106, 10, GRAY);
+    renderQueue.PushText(LayerHud, 0,
+                         TextFormat("Draw: %d commands, %d batch breaks",
+                                    lastCommands, lastBatchBreaks),
+                         10, 118, 10, GRAY);
+    // Only what the camera sees, wrapped copies included
+    viewCuller.Cull(dotGrid, camera, (float)screenWidth, (float)screenHeight);
+    for (const VisibleDot &v : viewCuller.GetVisible())
+      gridDots[v.index]->Draw(renderQueue, v.offset);
+    renderQueue.PushText(LayerHud, 0,
+                         TextFormat("Visible: %d of %d dots, %d tested",
+                                    viewCuller.GetVisibleCount(),
+                                    dotGrid.GetCount(),
+                                    viewCuller.GetTested()),
+                         10, 130, 10, GRAY);
+    player->Draw(renderQueue);
   }
+  renderQueue.SetWorldCamera(camera);
+  renderQueue.Sort();
+
+  BeginDrawing();
+  ClearBackground(RAYWHITE);
+  renderQueue.Submit();
   EndDrawing();
 }
 
+void Game::Run() {
+  Update(GetFrameTime());
+  Render();
+  // Everything allocated for this frame is released here
+  frameArena.Reset();
+}
+
 Game *gameInstance = nullptr;
 
-void MainLoop() {
-  float deltaTime = GetFrameTime();
-  gameInstance->Update(deltaTime);
-  gameInstance->Render();
-}
+void MainLoop() { gameInstance->Run(); }
 
 int main() {
   // Initialization
@@ -402,9 +845,7 @@ int main() {
   emscripten_set_main_loop(MainLoop, 0, 1);
 #else
   while (!WindowShouldClose()) {
-    float deltaTime = GetFrameTime();
-    game.Update(deltaTime);
-    game.Render();
+    game.Run();
   }
 #endif
 
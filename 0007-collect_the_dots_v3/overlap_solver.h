@@ -0,0 +1,271 @@
+// overlap_solver.h
+//
+// Position-based separation of overlapping circles, split across worker
+// threads. Plain float arrays in and out, so it needs no raylib and the
+// benchmark in bench/ runs the same code as the game.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// WorkerPool: runs one job over an index range on a fixed set of threads.
+// The calling thread takes the first slice, so a pool of 1 starts no
+// threads at all. Slices are contiguous and depend only on the range and
+// the thread count, never on timing.
+class WorkerPool {
+public:
+  using Job = void (*)(void *context, int begin, int end);
+
+private:
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  std::atomic<unsigned> generation{0}; // Bumped once per Run
+  Job job = nullptr;
+  void *context = nullptr;
+  int count = 0;
+  int slices = 0;  // Threads taking part in this Run (caller included)
+  int pending = 0; // Worker slices not finished yet
+  bool stopping = false;
+
+  void Slice(int index) const {
+    int begin = (int)((long long)count * index / slices);
+    int end = (int)((long long)count * (index + 1) / slices);
+    if (begin < end)
+      job(context, begin, end);
+  }
+
+  void Work(int index) {
+    unsigned seen = 0;
+    for (;;) {
+      // Jobs come in quick bursts (two per solver iteration): spin a
+      // little before sleeping, yielding so one core still makes progress
+      for (int spin = 0; spin < 256 && generation.load() == seen; ++spin)
+        std::this_thread::yield();
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [&]() { return stopping || generation.load() != seen; });
+      if (stopping)
+        return;
+      seen = generation.load();
+      bool active = index < slices;
+      lock.unlock();
+      if (!active)
+        continue;
+      Slice(index);
+      lock.lock();
+      if (--pending == 0)
+        done.notify_one();
+    }
+  }
+
+public:
+  explicit WorkerPool(int threads) {
+#ifdef PLATFORM_WEB
+    threads = 1; // No pthreads in the web build
+#endif
+    for (int i = 1; i < threads; ++i)
+      workers.emplace_back(&WorkerPool::Work, this, i);
+  }
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread &worker : workers)
+      worker.join();
+  }
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  int GetThreadCount() const { return (int)workers.size() + 1; }
+
+  // Calls job over [0, total) in up to GetThreadCount() slices of at
+  // least 'grain' items each, and returns once every slice is done
+  void Run(Job newJob, void *newContext, int total, int grain) {
+    int used = grain > 0 ? (total + grain - 1) / grain : total;
+    used = std::max(1, std::min(used, GetThreadCount()));
+    if (used == 1) {
+      if (total > 0)
+        newJob(newContext, 0, total);
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      job = newJob;
+      context = newContext;
+      count = total;
+      slices = used;
+      pending = used - 1;
+      generation.fetch_add(1);
+    }
+    wake.notify_all();
+    Slice(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&]() { return pending == 0; });
+  }
+};
+
+// One pair of bodies that should not overlap
+struct OverlapConstraint {
+  int a;
+  int b;
+};
+
+// OverlapSolver: pushes overlapping circles apart with Jacobi iterations.
+// Every iteration first computes each constraint's push from the same
+// positions, then moves each body by the average of its pushes (scaled
+// by the relaxation, capped at its constraint count). Each body sums its
+// own pushes in constraint order, and constraints are sorted first, so
+// the result is bit-for-bit the same for any thread count and any order
+// the pairs were found in.
+class OverlapSolver {
+private:
+  WorkerPool pool;
+  int iterations;
+  float relaxation;
+  int grain = 256; // Fewest items worth handing to another thread
+
+  // Scratch kept between solves, so a steady frame allocates nothing
+  std::vector<OverlapConstraint> constraints;
+  std::vector<float> pushX, pushY; // Per constraint, applied to b (a gets -)
+  std::vector<int> firstRef;       // Per body, into refs (CSR)
+  std::vector<int> refs;           // Constraint index * 2 + (body is b)
+  std::vector<int> cursor;         // Per body, next free slot in refs
+
+  // What a job needs, passed as the pool's context
+  struct Pass {
+    OverlapSolver *solver;
+    float *x;
+    float *y;
+    const float *radius;
+  };
+
+  static void ComputePushes(void *context, int begin, int end) {
+    const Pass &pass = *static_cast<const Pass *>(context);
+    OverlapSolver &s = *pass.solver;
+    for (int c = begin; c < end; ++c) {
+      int a = s.constraints[c].a, b = s.constraints[c].b;
+      float dx = pass.x[b] - pass.x[a];
+      float dy = pass.y[b] - pass.y[a];
+      float dist = sqrtf(dx * dx + dy * dy);
+      float overlap = pass.radius[a] + pass.radius[b] - dist;
+      if (overlap <= 0.0f) {
+        s.pushX[c] = 0.0f;
+        s.pushY[c] = 0.0f;
+      } else if (dist > 1e-4f) {
+        float scale = overlap * 0.5f / dist;
+        s.pushX[c] = dx * scale;
+        s.pushY[c] = dy * scale;
+      } else {
+        // Same spot: split along x, the lower index going left
+        s.pushX[c] = overlap * 0.5f;
+        s.pushY[c] = 0.0f;
+      }
+    }
+  }
+
+  static void ApplyPushes(void *context, int begin, int end) {
+    const Pass &pass = *static_cast<const Pass *>(context);
+    const OverlapSolver &s = *pass.solver;
+    for (int body = begin; body < end; ++body) {
+      int first = s.firstRef[body], last = s.firstRef[body + 1];
+      if (first == last)
+        continue;
+      float sumX = 0.0f, sumY = 0.0f;
+      for (int r = first; r < last; ++r) {
+        int c = s.refs[r] >> 1;
+        float sign = (s.refs[r] & 1) ? 1.0f : -1.0f;
+        sumX += sign * s.pushX[c];
+        sumY += sign * s.pushY[c];
+      }
+      // Each push is already half the overlap, so a body with a single
+      // constraint takes it whole: a lone pair ends exactly touching.
+      // Over-relaxation only helps a body pushed from several sides.
+      float n = (float)(last - first);
+      float scale = std::min(s.relaxation, n) / n;
+      pass.x[body] += sumX * scale;
+      pass.y[body] += sumY * scale;
+    }
+  }
+
+public:
+  explicit OverlapSolver(int threads = 1, int iterations = 4,
+                         float relaxation = 2.0f)
+      : pool(threads), iterations(iterations), relaxation(relaxation) {}
+
+  int GetThreadCount() const { return pool.GetThreadCount(); }
+
+  int GetIterations() const { return iterations; }
+
+  void SetIterations(int newIterations) { iterations = newIterations; }
+
+  // 1 moves each body by the average of its pushes, which undershoots in
+  // a crowd (every neighbour pushes the same way); up to about 3 settles
+  // faster, 4 starts to shake the crowd (see bench/solver_bench.cpp).
+  // A body with n constraints is scaled by at most n, so one with a
+  // single contact never overshoots.
+  void SetRelaxation(float newRelaxation) { relaxation = newRelaxation; }
+
+  void SetGrain(int newGrain) { grain = newGrain; }
+
+  // Moves bodies [0, bodyCount) in x/y so the given pairs overlap less.
+  // Pairs naming a body twice are ignored.
+  void Solve(float *x, float *y, const float *radius, int bodyCount,
+             const OverlapConstraint *input, int count) {
+    // One pass: lower index first, count each body's constraints, and
+    // note whether the pairs already came sorted (the all-pairs test in
+    // PositionManager finds them in order)
+    constraints.resize(count);
+    firstRef.assign(bodyCount + 1, 0);
+    int total = 0;
+    bool sorted = true;
+    OverlapConstraint last = {-1, -1};
+    for (int c = 0; c < count; ++c) {
+      int a = std::min(input[c].a, input[c].b);
+      int b = std::max(input[c].a, input[c].b);
+      if (a == b)
+        continue;
+      sorted = sorted && (a > last.a || (a == last.a && b >= last.b));
+      last = constraints[total++] = {a, b};
+      firstRef[a + 1]++;
+      firstRef[b + 1]++;
+    }
+    constraints.resize(total);
+    if (total == 0)
+      return;
+    if (!sorted) {
+      std::sort(constraints.begin(), constraints.end(),
+                [](const OverlapConstraint &p, const OverlapConstraint &q) {
+                  return p.a != q.a ? p.a < q.a : p.b < q.b;
+                });
+    }
+
+    // Each body's constraints, in constraint order
+    for (int body = 0; body < bodyCount; ++body)
+      firstRef[body + 1] += firstRef[body];
+    refs.resize(total * 2);
+    cursor.assign(firstRef.begin(), firstRef.end() - 1);
+    for (int c = 0; c < total; ++c) {
+      refs[cursor[constraints[c].a]++] = c * 2;
+      refs[cursor[constraints[c].b]++] = c * 2 + 1;
+    }
+
+    pushX.resize(total);
+    pushY.resize(total);
+    Pass pass = {this, x, y, radius};
+    for (int i = 0; i < iterations; ++i) {
+      pool.Run(&ComputePushes, &pass, total, grain);
+      pool.Run(&ApplyPushes, &pass, bodyCount, grain);
+    }
+  }
+};
@@ -0,0 +1,298 @@
+// render_queue.h
+//
+// Draw commands recorded in any order, sorted by a 64-bit key (layer,
+// depth, shader, texture) with a radix sort, then drawn. Recording is
+// plain data, so the sort needs no window.
+
+#pragma once
+
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+// Draw order, back to front: the top byte of a sort key. Not the
+// collision layers of Dot, which only decide who touches whom.
+enum RenderLayer : uint8_t {
+  LayerBackground = 0,
+  LayerWorld = 1,
+  LayerHud = 2,
+  LayerOverlay = 3, // Game over
+};
+
+// What a command draws; the key's lowest byte
+enum RenderPrimitive : uint8_t {
+  PrimitiveRectangle = 0,
+  PrimitiveText = 1,
+  PrimitiveTexture = 2,
+  PrimitiveCircle = 3, // Triangles, not quads
+};
+
+// Texture field of shapes (raylib's white texture) and of text in the
+// default font; other textures use their GL id. It only groups commands
+// for batching, so a clash costs a batch break, never a wrong draw.
+const uint16_t renderShapesTexture = 0;
+const uint16_t renderFontTexture = 1;
+
+// Sort key, most significant bits first:
+//   layer:8 | depth:24 | shader:8 | texture:16 | primitive:8
+// Depth orders commands within a layer, lowest first (screen y for a
+// top-down or isometric view). At equal depth, commands with the same
+// shader and texture come out together and rlgl batches them.
+inline uint64_t MakeRenderKey(RenderLayer layer, uint32_t depth,
+                              uint8_t shader, uint16_t texture,
+                              RenderPrimitive primitive) {
+  return ((uint64_t)layer << 56) | ((uint64_t)(depth & 0xFFFFFF) << 32) |
+         ((uint64_t)shader << 24) | ((uint64_t)texture << 8) |
+         (uint64_t)primitive;
+}
+
+// One command's key and where the command is, the unit the sort moves
+struct RenderSortItem {
+  uint64_t key;
+  uint32_t command;
+};
+
+// Stable LSD radix sort on the whole key, 11 bits per pass, skipping
+// bits every key shares. 'scratch' must hold 'count' items; returns
+// whichever of the two buffers holds the result.
+inline RenderSortItem *RadixSortRenderItems(RenderSortItem *items,
+                                            RenderSortItem *scratch,
+                                            size_t count) {
+  if (count < 64) {
+    // A HUD's worth: insertion sort, stable too, without the tables
+    for (size_t i = 1; i < count; ++i) {
+      RenderSortItem item = items[i];
+      size_t j = i;
+      for (; j > 0 && items[j - 1].key > item.key; --j)
+        items[j] = items[j - 1];
+      items[j] = item;
+    }
+    return items;
+  }
+
+  // Each digit starts at the lowest varying bit the ones before it left
+  uint64_t any = 0, all = ~(uint64_t)0;
+  for (size_t i = 0; i < count; ++i) {
+    any |= items[i].key;
+    all &= items[i].key;
+  }
+  uint64_t varying = any ^ all;
+  const int digitBits = 11;
+  const int maxPasses = (64 + digitBits - 1) / digitBits;
+  int shifts[maxPasses];
+  int passCount = 0;
+  while (varying) {
+    int shift = __builtin_ctzll(varying);
+    shifts[passCount++] = shift;
+    varying = shift + digitBits < 64 ? varying >> (shift + digitBits)
+                                           << (shift + digitBits)
+                                     : 0;
+  }
+
+  // Every digit's histogram in one pass over the keys
+  const uint64_t mask = (1u << digitBits) - 1;
+  static thread_local uint32_t counts[maxPasses][1 << digitBits];
+  memset(counts, 0, sizeof(counts[0]) * passCount);
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t key = items[i].key;
+    for (int p = 0; p < passCount; ++p)
+      counts[p][(key >> shifts[p]) & mask]++;
+  }
+
+  RenderSortItem *from = items;
+  RenderSortItem *to = scratch;
+  for (int p = 0; p < passCount; ++p) {
+    uint32_t *bucket = counts[p];
+    uint32_t offset = 0;
+    for (int b = 0; b < (1 << digitBits); ++b) {
+      uint32_t n = bucket[b];
+      bucket[b] = offset;
+      offset += n;
+    }
+    int shift = shifts[p];
+    for (size_t i = 0; i < count; ++i)
+      to[bucket[(from[i].key >> shift) & mask]++] = from[i];
+    std::swap(from, to);
+  }
+  return from;
+}
+
+// One recorded draw
+struct RenderCommand {
+  Rectangle rect;    // Rectangle, texture destination; circle: centre in
+                     // x/y, radius in width; text: x/y, font size in height
+  Rectangle source;  // Texture only
+  Texture2D texture; // Texture only
+  Color color;
+  uint32_t text; // Text only: offset into the queue's text storage
+  RenderPrimitive primitive;
+};
+
+// RenderQueue: one frame's draw commands. Push in any order, Sort, then
+// Submit between BeginDrawing and EndDrawing. Clear keeps the memory, so
+// a steady frame allocates nothing.
+class RenderQueue {
+private:
+  std::vector<RenderCommand> commands;
+  std::vector<RenderSortItem> items;   // In submit order
+  std::vector<RenderSortItem> scratch; // For the sort
+  std::vector<char> text;              // Strings, each 0-terminated
+  Shader shaders[256] = {};
+  bool hasShader[256] = {};
+  Camera2D worldCamera = {};
+  bool hasWorldCamera = false;
+
+  void Push(uint64_t key, const RenderCommand &command) {
+    items.push_back({key, (uint32_t)commands.size()});
+    commands.push_back(command);
+  }
+
+public:
+  void Clear() {
+    commands.clear();
+    items.clear();
+    text.clear();
+  }
+
+  void Reserve(size_t commandCount, size_t textBytes) {
+    commands.reserve(commandCount);
+    items.reserve(commandCount);
+    scratch.reserve(commandCount);
+    text.reserve(textBytes);
+  }
+
+  void PushRectangle(RenderLayer layer, uint32_t depth, Rectangle rect,
+                     Color color) {
+    RenderCommand command = {};
+    command.rect = rect;
+    command.color = color;
+    command.primitive = PrimitiveRectangle;
+    Push(MakeRenderKey(layer, depth, 0, renderShapesTexture,
+                       PrimitiveRectangle),
+         command);
+  }
+
+  void PushCircle(RenderLayer layer, uint32_t depth, Vector2 centre,
+                  float radius, Color color) {
+    RenderCommand command = {};
+    command.rect = {centre.x, centre.y, radius, radius};
+    command.color = color;
+    command.primitive = PrimitiveCircle;
+    Push(MakeRenderKey(layer, depth, 0, renderShapesTexture, PrimitiveCircle),
+         command);
+  }
+
+  // Default font; the string is copied
+  void PushText(RenderLayer layer, uint32_t depth, const char *string, int x,
+                int y, int fontSize, Color color) {
+    RenderCommand command = {};
+    command.rect = {(float)x, (float)y, 0.0f, (float)fontSize};
+    command.color = color;
+    command.text = (uint32_t)text.size();
+    command.primitive = PrimitiveText;
+    text.insert(text.end(), string, string + strlen(string) + 1);
+    Push(MakeRenderKey(layer, depth, 0, renderFontTexture, PrimitiveText),
+         command);
+  }
+
+  void PushTexture(RenderLayer layer, uint32_t depth, Texture2D texture,
+                   Rectangle source, Rectangle dest, Color tint,
+                   uint8_t shader = 0) {
+    RenderCommand command = {};
+    command.rect = dest;
+    command.source = source;
+    command.texture = texture;
+    command.color = tint;
+    command.primitive = PrimitiveTexture;
+    Push(MakeRenderKey(layer, depth, shader, (uint16_t)texture.id,
+                       PrimitiveTexture),
+         command);
+  }
+
+  // Shader for keys with this shader byte (1-255; 0 is raylib's default)
+  void SetShader(uint8_t slot, Shader shader) {
+    shaders[slot] = shader;
+    hasShader[slot] = slot != 0;
+  }
+
+  void Sort() {
+    scratch.resize(items.size());
+    RenderSortItem *sorted =
+        RadixSortRenderItems(items.data(), scratch.data(), items.size());
+    if (sorted != items.data())
+      items.swap(scratch);
+  }
+
+  // Background and world layers are drawn through this camera; the HUD
+  // and overlay stay in screen space
+  void SetWorldCamera(const Camera2D &camera) {
+    worldCamera = camera;
+    hasWorldCamera = true;
+  }
+
+  // Draws every command: in key order after Sort, else as pushed
+  void Submit() const {
+    int shader = 0;
+    bool inCamera = false;
+    for (const RenderSortItem &item : items) {
+      bool world = (item.key >> 56) <= LayerWorld;
+      if (hasWorldCamera && world != inCamera) {
+        if (world)
+          BeginMode2D(worldCamera);
+        else
+          EndMode2D();
+        inCamera = world;
+      }
+      int wanted = (int)((item.key >> 24) & 0xFF);
+      if (wanted != shader) {
+        if (hasShader[shader])
+          EndShaderMode();
+        if (hasShader[wanted])
+          BeginShaderMode(shaders[wanted]);
+        shader = wanted;
+      }
+      const RenderCommand &c = commands[item.command];
+      switch (c.primitive) {
+      case PrimitiveRectangle:
+        DrawRectangleRec(c.rect, c.color);
+        break;
+      case PrimitiveCircle:
+        DrawCircleV({c.rect.x, c.rect.y}, c.rect.width, c.color);
+        break;
+      case PrimitiveText:
+        DrawText(&text[c.text], (int)c.rect.x, (int)c.rect.y,
+                 (int)c.rect.height, c.color);
+        break;
+      case PrimitiveTexture:
+        DrawTexturePro(c.texture, c.source, c.rect, {0.0f, 0.0f}, 0.0f,
+                       c.color);
+        break;
+      }
+    }
+    if (hasShader[shader])
+      EndShaderMode();
+    if (inCamera)
+      EndMode2D();
+  }
+
+  int GetCount() const { return (int)commands.size(); }
+
+  // Shader, texture or triangles/quads changes in the order Submit would
+  // draw, each one a batch rlgl has to flush
+  int GetBatchBreaks() const {
+    int breaks = 0;
+    uint64_t last = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+      uint64_t key = items[i].key;
+      uint64_t batch = ((key >> 8) & 0xFFFFFF) << 1 |
+                       (uint64_t)((key & 0xFF) == PrimitiveCircle);
+      if (i > 0 && batch != last)
+        breaks++;
+      last = batch;
+    }
+    return breaks;
+  }
+};
@@ -0,0 +1,488 @@
+// rock_field.h
+//
+// Asteroids-style rocks in a world that wraps at its edges: a fixed pool
+// that splits a rock into smaller ones without allocating, a broadphase
+// over a SpatialGrid whose cells wrap too, and a separating axis test
+// between the rocks' convex outlines. Bullets break rocks. No raylib, so
+// the benchmark in bench/ runs the same code as the game.
+
+#pragma once
+
+#include "spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+const int rockMaxVertices = 8;
+const int rockSizes = 4; // Size 0 is the smallest and breaks up for good
+const float rockRadii[rockSizes] = {8.0f, 14.0f, 24.0f, 40.0f};
+const int rockChildren = 2; // Rocks a hit rock of size > 0 breaks into
+
+// RockVec: a point or direction in world pixels
+struct RockVec {
+  float x, y;
+};
+
+inline float RockDot(RockVec a, RockVec b) { return a.x * b.x + a.y * b.y; }
+
+// The shortest way from one point to another along an axis of a wrapped
+// world: at most half the world either way
+inline float WrapDelta(float delta, float size) {
+  if (delta > size * 0.5f)
+    return delta - size;
+  if (delta < -size * 0.5f)
+    return delta + size;
+  return delta;
+}
+
+// Rock: one pooled rock. Its outline is convex and counter-clockwise,
+// around the rock's position; Move rotates it into 'vertices' and
+// 'normals' once a frame, so tests never transform it again.
+struct Rock {
+  RockVec position;
+  RockVec velocity;
+  float angle;
+  float spin;       // Radians per second
+  float radius;     // Bounding circle of the outline
+  int size;         // Index into rockRadii
+  int vertexCount;
+  int liveSlot;     // Index in the pool's live list; -1 when free
+  bool hit;         // Breaks up at the end of this Shoot
+  RockVec outline[rockMaxVertices]; // Unrotated
+  RockVec edgeNormals[rockMaxVertices]; // Unit, outward, unrotated
+  RockVec vertices[rockMaxVertices];    // Rotated, around position
+  RockVec normals[rockMaxVertices];
+};
+
+// RockPool: every rock lives in one array allocated up front.
+//   - Spawn takes a slot off the free list, Release puts it back: no
+//     heap traffic however many rocks break up
+//   - The live rocks' slots are kept densely, for iteration; Release
+//     swaps the last one into the gap
+//   - Full is not an error: Spawn returns -1 and the caller carries on
+class RockPool {
+private:
+  std::vector<Rock> rocks;
+  std::vector<int> freeSlots;
+  std::vector<int> live;
+
+public:
+  explicit RockPool(int capacity) : rocks(capacity) {
+    freeSlots.reserve(capacity);
+    live.reserve(capacity);
+    for (int i = capacity - 1; i >= 0; --i) {
+      rocks[i].liveSlot = -1;
+      freeSlots.push_back(i);
+    }
+  }
+
+  int Spawn() {
+    if (freeSlots.empty())
+      return -1;
+    int id = freeSlots.back();
+    freeSlots.pop_back();
+    rocks[id].liveSlot = (int)live.size();
+    rocks[id].hit = false;
+    live.push_back(id);
+    return id;
+  }
+
+  void Release(int id) {
+    int slot = rocks[id].liveSlot;
+    int moved = live.back();
+    live[slot] = moved;
+    rocks[moved].liveSlot = slot;
+    live.pop_back();
+    rocks[id].liveSlot = -1;
+    freeSlots.push_back(id);
+  }
+
+  Rock &Get(int id) { return rocks[id]; }
+
+  const Rock &Get(int id) const { return rocks[id]; }
+
+  const std::vector<int> &GetLive() const { return live; }
+
+  int GetLiveCount() const { return (int)live.size(); }
+
+  int GetCapacity() const { return (int)rocks.size(); }
+};
+
+// RockBullet: a point moving in a straight line until it hits or expires
+struct RockBullet {
+  RockVec position;
+  RockVec velocity;
+  float life; // Seconds left
+};
+
+// Separating axis test between two convex outlines, 'delta' being b's
+// position minus a's (wrapped). On overlap, 'normal' points from a to b
+// and 'depth' is how far to push them apart along it.
+inline bool RocksOverlap(const Rock &a, const Rock &b, RockVec delta,
+                         RockVec &normal, float &depth) {
+  depth = INFINITY;
+  const Rock *shapes[2] = {&a, &b};
+  for (const Rock *shape : shapes) {
+    for (int e = 0; e < shape->vertexCount; ++e) {
+      RockVec axis = shape->normals[e];
+      float minA = INFINITY, maxA = -INFINITY;
+      for (int i = 0; i < a.vertexCount; ++i) {
+        float p = RockDot(a.vertices[i], axis);
+        minA = std::min(minA, p);
+        maxA = std::max(maxA, p);
+      }
+      float shift = RockDot(delta, axis);
+      float minB = INFINITY, maxB = -INFINITY;
+      for (int i = 0; i < b.vertexCount; ++i) {
+        float p = RockDot(b.vertices[i], axis) + shift;
+        minB = std::min(minB, p);
+        maxB = std::max(maxB, p);
+      }
+      float overlap = std::min(maxA, maxB) - std::max(minA, minB);
+      if (overlap <= 0.0f)
+        return false; // A gap on this axis: they don't touch
+      if (overlap < depth) {
+        depth = overlap;
+        normal = shift < 0.0f ? RockVec{-axis.x, -axis.y} : axis;
+      }
+    }
+  }
+  return true;
+}
+
+// True when 'point' (relative to the rock's position) is inside it
+inline bool RockContains(const Rock &rock, RockVec point) {
+  for (int e = 0; e < rock.vertexCount; ++e) {
+    RockVec v = rock.vertices[e];
+    RockVec offset = {point.x - v.x, point.y - v.y};
+    if (RockDot(offset, rock.normals[e]) > 0.0f)
+      return false;
+  }
+  return true;
+}
+
+// RockField: rocks and bullets in a wrapping world, one phase at a time.
+// A frame is Move, Index, CollideRocks, Shoot, in that order.
+//   - Move: rocks and bullets advance and wrap around the edges
+//   - Index: the rocks go into a grid with cells at least as wide as the
+//     biggest rock, so any two touching rocks share or neighbour a cell,
+//     across the seam too. A rock near an edge is never copied to the
+//     other side: the pair test measures the short way round.
+//   - CollideRocks: bounding circles, then the separating axis test;
+//     touching rocks are pushed apart and bounce
+//   - Shoot: each bullet asks the grid for rocks around it, and a hit
+//     rock breaks into rockChildren smaller ones after all bullets are
+//     done, so a slot is never reused in the middle of a pass
+class RockField {
+private:
+  float worldWidth;
+  float worldHeight;
+  RockPool pool;
+  SpatialGrid grid;
+  std::vector<RockBullet> bullets;
+  int bulletCapacity;
+  struct RockHit {
+    int rock;
+    RockVec push; // The bullet's velocity
+  };
+  std::vector<RockHit> hits; // Rocks hit this Shoot
+  // Build's input, one entry per live rock; kept between frames
+  std::vector<float> gridX;
+  std::vector<float> gridY;
+  std::vector<float> gridRadius;
+  std::vector<int> gridRock; // Grid index -> rock id
+  uint32_t seed;
+
+  int nearPairs = 0;   // Pairs the grid handed over, last CollideRocks
+  int circlePairs = 0; // Of those, bounding circles overlapping
+  int contacts = 0;    // Of those, outlines overlapping
+  int hitCount = 0;    // Bullets that hit, last Shoot
+  long long splits = 0;         // Rocks broken, ever
+  long long spawnFailures = 0;  // Rocks not made because the pool was full
+
+  float Random() { // 0 to 1; xorshift, so no allocation or locking
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return (seed >> 8) * (1.0f / 16777216.0f);
+  }
+
+  // An irregular convex outline: points at jittered angles and radii,
+  // then their convex hull (monotone chain), counter-clockwise
+  void MakeOutline(Rock &rock) {
+    const float twoPi = 6.28318531f;
+    float size = rockRadii[rock.size];
+    int count = 6 + (int)(Random() * 3.0f);
+    RockVec points[rockMaxVertices];
+    for (int i = 0; i < count; ++i) {
+      float angle = (i + Random() * 0.7f) * twoPi / count;
+      float r = size * (0.7f + 0.3f * Random());
+      points[i] = {cosf(angle) * r, sinf(angle) * r};
+    }
+    for (int i = 1; i < count; ++i) { // By x then y; a handful of points
+      RockVec p = points[i];
+      int j = i;
+      for (; j > 0 && (points[j - 1].x > p.x ||
+                       (points[j - 1].x == p.x && points[j - 1].y > p.y));
+           --j)
+        points[j] = points[j - 1];
+      points[j] = p;
+    }
+    auto cross = [](RockVec o, RockVec p, RockVec q) {
+      return (p.x - o.x) * (q.y - o.y) - (p.y - o.y) * (q.x - o.x);
+    };
+    RockVec hull[2 * rockMaxVertices];
+    int n = 0;
+    for (int i = 0; i < count; ++i) {
+      while (n >= 2 && cross(hull[n - 2], hull[n - 1], points[i]) <= 0.0f)
+        n--;
+      hull[n++] = points[i];
+    }
+    for (int i = count - 2, lower = n + 1; i >= 0; --i) {
+      while (n >= lower && cross(hull[n - 2], hull[n - 1], points[i]) <= 0.0f)
+        n--;
+      hull[n++] = points[i];
+    }
+    rock.vertexCount = n - 1; // The last point repeats the first
+    rock.radius = 0.0f;
+    for (int i = 0; i < rock.vertexCount; ++i) {
+      RockVec p = hull[i], q = hull[(i + 1) % rock.vertexCount];
+      RockVec edge = {q.x - p.x, q.y - p.y};
+      float length = sqrtf(RockDot(edge, edge));
+      rock.outline[i] = p;
+      rock.edgeNormals[i] = {edge.y / length, -edge.x / length};
+      rock.radius = std::max(rock.radius, sqrtf(RockDot(p, p)));
+    }
+    Turn(rock);
+  }
+
+  static void Turn(Rock &rock) {
+    float c = cosf(rock.angle), s = sinf(rock.angle);
+    for (int i = 0; i < rock.vertexCount; ++i) {
+      RockVec p = rock.outline[i], n = rock.edgeNormals[i];
+      rock.vertices[i] = {p.x * c - p.y * s, p.x * s + p.y * c};
+      rock.normals[i] = {n.x * c - n.y * s, n.x * s + n.y * c};
+    }
+  }
+
+  void Wrap(RockVec &p) const {
+    if (p.x < 0.0f)
+      p.x += worldWidth;
+    else if (p.x >= worldWidth)
+      p.x -= worldWidth;
+    if (p.y < 0.0f)
+      p.y += worldHeight;
+    else if (p.y >= worldHeight)
+      p.y -= worldHeight;
+  }
+
+  RockVec Delta(RockVec from, RockVec to) const {
+    return {WrapDelta(to.x - from.x, worldWidth),
+            WrapDelta(to.y - from.y, worldHeight)};
+  }
+
+  void Split(int id, RockVec push) {
+    Rock parent = pool.Get(id); // A copy: the slot is about to be reused
+    pool.Release(id);
+    splits++;
+    if (parent.size == 0)
+      return; // Dust
+    // Children fly apart across the bullet's path, and a little along it
+    float length = sqrtf(RockDot(push, push));
+    RockVec along = length > 0.0f ? RockVec{push.x / length, push.y / length}
+                                  : RockVec{1.0f, 0.0f};
+    RockVec across = {-along.y, along.x};
+    for (int k = 0; k < rockChildren; ++k) {
+      float side = k % 2 ? -1.0f : 1.0f;
+      float kick = 30.0f + 40.0f * Random();
+      float offset = rockRadii[parent.size - 1] * 0.6f * side;
+      RockVec position = {parent.position.x + across.x * offset,
+                          parent.position.y + across.y * offset};
+      RockVec velocity = {
+          parent.velocity.x + (across.x * side + along.x * 0.3f) * kick,
+          parent.velocity.y + (across.y * side + along.y * 0.3f) * kick};
+      if (SpawnRock(position, velocity, parent.size - 1) < 0)
+        break;
+    }
+  }
+
+public:
+  RockField(float worldWidth, float worldHeight, int rockCapacity,
+            int bulletCapacity, uint32_t seed)
+      : worldWidth(worldWidth), worldHeight(worldHeight), pool(rockCapacity),
+        grid(worldWidth, worldHeight, 2.0f * rockRadii[rockSizes - 1]),
+        bulletCapacity(bulletCapacity), seed(seed ? seed : 1u) {
+    bullets.reserve(bulletCapacity);
+    hits.reserve(bulletCapacity); // A bullet breaks one rock at most
+    gridX.reserve(rockCapacity);
+    gridY.reserve(rockCapacity);
+    gridRadius.reserve(rockCapacity);
+    gridRock.reserve(rockCapacity);
+    grid.Reserve(rockCapacity);
+  }
+
+  // The new rock's id, or -1 when the pool is full
+  int SpawnRock(RockVec position, RockVec velocity, int size) {
+    int id = pool.Spawn();
+    if (id < 0) {
+      spawnFailures++;
+      return -1;
+    }
+    Rock &rock = pool.Get(id);
+    rock.position = position;
+    Wrap(rock.position);
+    rock.velocity = velocity;
+    rock.angle = Random() * 6.28318531f;
+    rock.spin = (Random() - 0.5f) * 2.0f;
+    rock.size = std::clamp(size, 0, rockSizes - 1);
+    MakeOutline(rock);
+    return id;
+  }
+
+  // False when every bullet slot is in use
+  bool Fire(RockVec position, RockVec velocity, float life) {
+    if ((int)bullets.size() >= bulletCapacity)
+      return false;
+    Wrap(position);
+    bullets.push_back({position, velocity, life});
+    return true;
+  }
+
+  void Move(float deltaTime) {
+    for (int id : pool.GetLive()) {
+      Rock &rock = pool.Get(id);
+      rock.position.x += rock.velocity.x * deltaTime;
+      rock.position.y += rock.velocity.y * deltaTime;
+      Wrap(rock.position);
+      rock.angle += rock.spin * deltaTime;
+      Turn(rock);
+    }
+    for (size_t i = 0; i < bullets.size();) {
+      RockBullet &b = bullets[i];
+      b.life -= deltaTime;
+      if (b.life <= 0.0f) {
+        b = bullets.back();
+        bullets.pop_back();
+        continue;
+      }
+      b.position.x += b.velocity.x * deltaTime;
+      b.position.y += b.velocity.y * deltaTime;
+      Wrap(b.position);
+      ++i;
+    }
+  }
+
+  void Index() {
+    gridX.clear();
+    gridY.clear();
+    gridRadius.clear();
+    gridRock.clear();
+    for (int id : pool.GetLive()) {
+      const Rock &rock = pool.Get(id);
+      gridX.push_back(rock.position.x);
+      gridY.push_back(rock.position.y);
+      gridRadius.push_back(rock.radius);
+      gridRock.push_back(id);
+    }
+    grid.Build(gridX.data(), gridY.data(), gridRadius.data(),
+               (int)gridRock.size());
+  }
+
+  void CollideRocks() {
+    nearPairs = circlePairs = contacts = 0;
+    grid.ForEachNearPair(true, [&](const GridItem &p, const GridItem &q) {
+      nearPairs++;
+      // Positions as indexed: pushes made earlier this pass don't move
+      // a rock to a different pair
+      RockVec delta = {WrapDelta(q.x - p.x, worldWidth),
+                       WrapDelta(q.y - p.y, worldHeight)};
+      float reach = p.radius + q.radius;
+      if (RockDot(delta, delta) >= reach * reach)
+        return;
+      circlePairs++;
+      Rock &a = pool.Get(gridRock[p.index]);
+      Rock &b = pool.Get(gridRock[q.index]);
+      RockVec normal;
+      float depth;
+      if (!RocksOverlap(a, b, delta, normal, depth))
+        return;
+      contacts++;
+      // Heavier rocks (by area) move less; equal masses, elastic
+      float massA = a.radius * a.radius, massB = b.radius * b.radius;
+      float shareA = massB / (massA + massB), shareB = 1.0f - shareA;
+      a.position.x -= normal.x * depth * shareA;
+      a.position.y -= normal.y * depth * shareA;
+      b.position.x += normal.x * depth * shareB;
+      b.position.y += normal.y * depth * shareB;
+      RockVec relative = {b.velocity.x - a.velocity.x,
+                          b.velocity.y - a.velocity.y};
+      float closing = RockDot(relative, normal);
+      if (closing < 0.0f) {
+        float impulse = -2.0f * closing / (1.0f / massA + 1.0f / massB);
+        a.velocity.x -= normal.x * impulse / massA;
+        a.velocity.y -= normal.y * impulse / massA;
+        b.velocity.x += normal.x * impulse / massB;
+        b.velocity.y += normal.y * impulse / massB;
+      }
+    });
+  }
+
+  void Shoot() {
+    hits.clear();
+    hitCount = 0;
+    for (size_t i = 0; i < bullets.size();) {
+      const RockBullet &bullet = bullets[i];
+      int struck = -1;
+      auto test = [&](const GridItem &item) {
+        Rock &rock = pool.Get(gridRock[item.index]);
+        if (struck >= 0 || rock.hit)
+          return; // This bullet is spent, or the rock is breaking already
+        RockVec offset = Delta(rock.position, bullet.position);
+        if (RockDot(offset, offset) > rock.radius * rock.radius ||
+            !RockContains(rock, offset))
+          return;
+        rock.hit = true;
+        struck = gridRock[item.index];
+      };
+      grid.QueryAround(bullet.position.x, bullet.position.y, true, test);
+      if (struck < 0) {
+        ++i;
+        continue;
+      }
+      hits.push_back({struck, bullet.velocity});
+      hitCount++;
+      bullets[i] = bullets.back();
+      bullets.pop_back();
+    }
+    for (const RockHit &hit : hits)
+      Split(hit.rock, hit.push);
+  }
+
+  void Step(float deltaTime) {
+    Move(deltaTime);
+    Index();
+    CollideRocks();
+    Shoot();
+  }
+
+  const RockPool &GetPool() const { return pool; }
+
+  const std::vector<RockBullet> &GetBullets() const { return bullets; }
+
+  float GetWorldWidth() const { return worldWidth; }
+
+  float GetWorldHeight() const { return worldHeight; }
+
+  int GetNearPairs() const { return nearPairs; }
+
+  int GetCirclePairs() const { return circlePairs; }
+
+  int GetContacts() const { return contacts; }
+
+  int GetHits() const { return hitCount; }
+
+  long long GetSplits() const { return splits; }
+
+  long long GetSpawnFailures() const { return spawnFailures; }
+};
@@ -0,0 +1,192 @@
+// spatial_grid.h
+//
+// A uniform grid over the world, rebuilt from dot positions with a
+// counting sort: one pass counts the dots per cell, one places them.
+// Queries hand back the dots in the cells a rectangle covers, or the
+// pairs of dots in neighbouring cells, optionally across the edges of a
+// world that wraps. No raylib, so the benchmarks in bench/ run the same
+// code as the game.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// GridItem: one dot as the grid keeps it, in cell order
+struct GridItem {
+  float x, y;
+  float radius;
+  int index; // The dot's index in the arrays given to Build
+};
+
+// SpatialGrid: dots bucketed by the cell their centre is in.
+//   - Cells tile the world exactly: as many whole cells of at least
+//     'cellSize' as fit each way, stretched to cover it, so a wrapped
+//     world has no narrow cell at the seam
+//   - Build is O(dots + cells) and allocates nothing once its vectors
+//     have grown to the crowd's size
+//   - A cell's dots are contiguous with their position and radius copied
+//     in, so a query reads memory in order and never touches the dots
+//   - Centres outside the world go to the nearest edge cell
+//   - Query visits every dot of every cell the rectangle touches: the
+//     caller does the exact test, and grows the rectangle by
+//     GetMaxRadius() to catch dots that only overhang it
+//   - ForEachNearPair and QueryAround look one cell each way, so they
+//     find everything within a cell's size. When the world wraps, the
+//     last column neighbours the first (rows too); that needs at least
+//     3 cells each way, or a pair would be seen twice.
+class SpatialGrid {
+private:
+  float worldWidth;
+  float worldHeight;
+  float cellSize; // The least a cell measures either way
+  int columns;
+  int rows;
+  float inverseColumn; // Columns per pixel
+  float inverseRow;
+  float maxRadius = 0.0f;
+  std::vector<int> cellStart; // Cell c's dots are items[cellStart[c]..c+1)
+  std::vector<int> cellOf;    // Scratch: each dot's cell
+  std::vector<int> fill;      // Scratch: next free slot per cell
+  std::vector<GridItem> items;
+
+  int Column(float x) const {
+    return std::clamp((int)std::floor(x * inverseColumn), 0, columns - 1);
+  }
+
+  int Row(float y) const {
+    return std::clamp((int)std::floor(y * inverseRow), 0, rows - 1);
+  }
+
+public:
+  SpatialGrid(float worldWidth, float worldHeight, float cellSize)
+      : worldWidth(worldWidth), worldHeight(worldHeight), cellSize(cellSize),
+        columns(std::max(1, (int)(worldWidth / cellSize))),
+        rows(std::max(1, (int)(worldHeight / cellSize))),
+        inverseColumn(columns / worldWidth), inverseRow(rows / worldHeight) {}
+
+  // Grows the buffers for 'count' dots now, so Build never allocates
+  void Reserve(int count) {
+    cellStart.reserve(columns * rows + 1);
+    fill.reserve(columns * rows);
+    cellOf.reserve(count);
+    items.reserve(count);
+  }
+
+  void Build(const float *x, const float *y, const float *radius,
+             int count) {
+    int cells = columns * rows;
+    cellStart.assign(cells + 1, 0);
+    cellOf.resize(count);
+    maxRadius = 0.0f;
+    for (int i = 0; i < count; ++i) {
+      int cell = Row(y[i]) * columns + Column(x[i]);
+      cellOf[i] = cell;
+      cellStart[cell + 1]++;
+      maxRadius = std::max(maxRadius, radius[i]);
+    }
+    for (int c = 0; c < cells; ++c)
+      cellStart[c + 1] += cellStart[c];
+    fill.assign(cellStart.begin(), cellStart.end() - 1);
+    items.resize(count);
+    for (int i = 0; i < count; ++i)
+      items[fill[cellOf[i]]++] = {x[i], y[i], radius[i], i};
+  }
+
+  // Calls visit(const GridItem &) for the dots in every cell that
+  // [left, right] x [top, bottom] touches, a row of cells at a time
+  template <typename Visit>
+  void Query(float left, float top, float right, float bottom,
+             Visit &&visit) const {
+    if (items.empty() || right < left || bottom < top)
+      return;
+    int firstColumn = Column(left), lastColumn = Column(right);
+    int firstRow = Row(top), lastRow = Row(bottom);
+    for (int row = firstRow; row <= lastRow; ++row) {
+      // A row's cells are adjacent, so their dots are one run
+      int begin = cellStart[row * columns + firstColumn];
+      int end = cellStart[row * columns + lastColumn + 1];
+      for (int i = begin; i < end; ++i)
+        visit(items[i]);
+    }
+  }
+
+  // Calls visit(const GridItem &, const GridItem &) once for every pair
+  // of dots in the same cell or in touching cells (diagonals too)
+  template <typename Visit>
+  void ForEachNearPair(bool wrap, Visit &&visit) const {
+    // Half the neighbours, so each pair of cells comes up once
+    static const int ahead[4][2] = {{1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+    if (items.empty())
+      return;
+    for (int row = 0; row < rows; ++row) {
+      for (int column = 0; column < columns; ++column) {
+        int cell = row * columns + column;
+        int begin = cellStart[cell], end = cellStart[cell + 1];
+        if (begin == end)
+          continue;
+        for (int i = begin; i < end; ++i) {
+          for (int j = i + 1; j < end; ++j)
+            visit(items[i], items[j]);
+        }
+        for (const int *step : ahead) {
+          int c = column + step[0], r = row + step[1];
+          if (wrap) {
+            c = (c + columns) % columns;
+            r = r % rows;
+          } else if (c < 0 || c >= columns || r >= rows) {
+            continue;
+          }
+          int other = r * columns + c;
+          for (int i = begin; i < end; ++i) {
+            for (int j = cellStart[other]; j < cellStart[other + 1]; ++j)
+              visit(items[i], items[j]);
+          }
+        }
+      }
+    }
+  }
+
+  // Calls visit(const GridItem &) for the dots in the 3x3 cells around
+  // (x, y), wrapping at the world's edges if asked
+  template <typename Visit>
+  void QueryAround(float x, float y, bool wrap, Visit &&visit) const {
+    if (items.empty())
+      return;
+    int column = Column(x), row = Row(y);
+    for (int dr = -1; dr <= 1; ++dr) {
+      int r = row + dr;
+      if (wrap)
+        r = (r + rows) % rows;
+      else if (r < 0 || r >= rows)
+        continue;
+      for (int dc = -1; dc <= 1; ++dc) {
+        int c = column + dc;
+        if (wrap)
+          c = (c + columns) % columns;
+        else if (c < 0 || c >= columns)
+          continue;
+        int cell = r * columns + c;
+        for (int i = cellStart[cell]; i < cellStart[cell + 1]; ++i)
+          visit(items[i]);
+      }
+    }
+  }
+
+  float GetWorldWidth() const { return worldWidth; }
+
+  float GetWorldHeight() const { return worldHeight; }
+
+  float GetCellSize() const { return cellSize; }
+
+  float GetMaxRadius() const { return maxRadius; }
+
+  int GetCount() const { return (int)items.size(); }
+
+  int GetCellCount() const { return columns * rows; }
+
+  int GetColumns() const { return columns; }
+
+  int GetRows() const { return rows; }
+};
@@ -0,0 +1,127 @@
+// view_culler.h
+//
+// Which dots a Camera2D can see, looked up in a SpatialGrid, so the draw
+// path never visits the rest of the world. A toroidal world (one that
+// wraps at its edges) is drawn as copies of itself around the camera: a
+// dot near one edge shows again past the opposite edge, and the culler
+// lists it once per copy it appears in, with that copy's offset.
+// raylib only for Camera2D and Vector2; nothing here draws.
+
+#pragma once
+
+#include "raylib.h"
+#include "spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// VisibleDot: a dot to draw at its position plus 'offset'
+struct VisibleDot {
+  int index; // As given to SpatialGrid::Build
+  Vector2 offset;
+};
+
+// CullRect: a rectangle in world coordinates, edges inclusive
+struct CullRect {
+  float left, top, right, bottom;
+};
+
+// The part of the world a camera shows in a viewport of the given size.
+// Raylib maps world to screen as (world - target) rotated, times zoom,
+// plus offset; this runs the four viewport corners back through that and
+// takes their bounds, so a rotated camera gets the box around its view.
+inline CullRect CameraWorldRect(const Camera2D &camera, float viewWidth,
+                                float viewHeight) {
+  float zoom = camera.zoom != 0.0f ? camera.zoom : 1.0f;
+  float angle = -camera.rotation * DEG2RAD;
+  float c = cosf(angle), s = sinf(angle);
+  const Vector2 corners[4] = {
+      {0.0f, 0.0f}, {viewWidth, 0.0f}, {0.0f, viewHeight},
+      {viewWidth, viewHeight}};
+  CullRect rect = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+  for (const Vector2 &corner : corners) {
+    float dx = (corner.x - camera.offset.x) / zoom;
+    float dy = (corner.y - camera.offset.y) / zoom;
+    float x = camera.target.x + dx * c - dy * s;
+    float y = camera.target.y + dx * s + dy * c;
+    rect.left = std::min(rect.left, x);
+    rect.top = std::min(rect.top, y);
+    rect.right = std::max(rect.right, x);
+    rect.bottom = std::max(rect.bottom, y);
+  }
+  return rect;
+}
+
+// ViewCuller: the dots a camera sees this frame, as a list to draw.
+//   - One grid query per copy of the world the view touches: just the
+//     world itself unless it wraps and the camera looks across an edge
+//   - Each candidate's bounding box is tested against the view, so a
+//     dot is listed only when some of it is on screen
+//   - Dots are never duplicated in memory; a wrapped copy is an index
+//     and an offset
+//   - The list is kept between frames, so a steady frame allocates
+//     nothing
+class ViewCuller {
+private:
+  bool wrap;
+  std::vector<VisibleDot> visible;
+  int tested = 0; // Grid items looked at by the last Cull
+  int copies = 0; // Copies of the world the last Cull queried
+
+  void CullCopy(const SpatialGrid &grid, const CullRect &view,
+                Vector2 offset) {
+    // The view in this copy's coordinates
+    float left = view.left - offset.x, right = view.right - offset.x;
+    float top = view.top - offset.y, bottom = view.bottom - offset.y;
+    float grow = grid.GetMaxRadius();
+    copies++;
+    grid.Query(left - grow, top - grow, right + grow, bottom + grow,
+               [&](const GridItem &item) {
+                 tested++;
+                 if (item.x + item.radius >= left &&
+                     item.x - item.radius <= right &&
+                     item.y + item.radius >= top &&
+                     item.y - item.radius <= bottom)
+                   visible.push_back({item.index, offset});
+               });
+  }
+
+public:
+  explicit ViewCuller(bool wrap) : wrap(wrap) {}
+
+  void SetWrap(bool wraps) { wrap = wraps; }
+
+  bool GetWrap() const { return wrap; }
+
+  void Cull(const SpatialGrid &grid, const Camera2D &camera, float viewWidth,
+            float viewHeight) {
+    visible.clear();
+    tested = 0;
+    copies = 0;
+    CullRect view = CameraWorldRect(camera, viewWidth, viewHeight);
+    if (!wrap) {
+      CullCopy(grid, view, {0.0f, 0.0f});
+      return;
+    }
+    // Copy (i, j) of the world spans [i * width, (i + 1) * width) and
+    // the same down; visit every copy the grown view reaches
+    float width = grid.GetWorldWidth(), height = grid.GetWorldHeight();
+    float grow = grid.GetMaxRadius();
+    int firstX = (int)std::floor((view.left - grow) / width);
+    int lastX = (int)std::floor((view.right + grow) / width);
+    int firstY = (int)std::floor((view.top - grow) / height);
+    int lastY = (int)std::floor((view.bottom + grow) / height);
+    for (int j = firstY; j <= lastY; ++j) {
+      for (int i = firstX; i <= lastX; ++i)
+        CullCopy(grid, view, {i * width, j * height});
+    }
+  }
+
+  const std::vector<VisibleDot> &GetVisible() const { return visible; }
+
+  int GetVisibleCount() const { return (int)visible.size(); }
+
+  int GetTested() const { return tested; }
+
+  int GetCopies() const { return copies; }
+};
@@ -0,0 +1,315 @@
+// asset_pack.cpp
+
+#include "asset_pack.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#if !defined(PLATFORM_WEB) && !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ASSET_PACK_MMAP
+#endif
+
+static size_t WaveBytes(const Wave &wave) {
+  return (size_t)wave.frameCount * wave.channels * (wave.sampleSize / 8);
+}
+
+static size_t ImageBytes(int width, int height, int mipmaps, int format) {
+  size_t bytes = 0;
+  for (int level = 0; level < (mipmaps > 0 ? mipmaps : 1); ++level) {
+    bytes += (size_t)GetPixelDataSize(width, height, format);
+    width = width > 1 ? width / 2 : 1;
+    height = height > 1 ? height / 2 : 1;
+  }
+  return bytes;
+}
+
+static size_t AlignUp(size_t value) {
+  return (value + packAlignment - 1) & ~(size_t)(packAlignment - 1);
+}
+
+static bool NameLess(const PackEntry &a, const PackEntry &b) {
+  return strncmp(a.name, b.name, sizeof(a.name)) < 0;
+}
+
+// ----------- AssetPack -----------
+
+AssetPack::AssetPack()
+    : base(nullptr), size(0), entries(nullptr), entryCount(0),
+      mapped(false) {}
+
+AssetPack::~AssetPack() { Close(); }
+
+bool AssetPack::Open(const char *path) {
+  Close();
+
+  const uint8_t *data = nullptr;
+  size_t bytes = 0;
+  bool isMapped = false;
+#ifdef ASSET_PACK_MMAP
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat info;
+  if (fstat(fd, &info) == 0 && info.st_size > 0) {
+    bytes = (size_t)info.st_size;
+    void *view = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view != MAP_FAILED) {
+      data = static_cast<const uint8_t *>(view);
+      isMapped = true;
+    }
+  }
+  close(fd); // The mapping keeps the file alive
+#else
+  // No mmap here: one read into an aligned buffer, still no per-asset
+  // opens or decodes
+  FILE *file = fopen(path, "rb");
+  if (!file)
+    return false;
+  fseek(file, 0, SEEK_END);
+  long length = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  if (length > 0) {
+    bytes = (size_t)length;
+    uint8_t *buffer = static_cast<uint8_t *>(
+        ::operator new(bytes, std::align_val_t(packAlignment)));
+    if (fread(buffer, 1, bytes, file) == bytes) {
+      data = buffer;
+    } else {
+      ::operator delete(buffer, std::align_val_t(packAlignment));
+    }
+  }
+  fclose(file);
+#endif
+  if (!data)
+    return false;
+  base = data;
+  size = bytes;
+  mapped = isMapped;
+
+  // Check everything once, so lookups can trust the index
+  PackHeader header;
+  bool valid = size >= sizeof(header);
+  if (valid) {
+    memcpy(&header, base, sizeof(header));
+    valid = header.magic == packMagic && header.version == packVersion &&
+            header.indexOffset % alignof(PackEntry) == 0 &&
+            header.indexOffset <= size &&
+            header.entryCount <=
+                (size - header.indexOffset) / sizeof(PackEntry);
+  }
+  if (valid) {
+    entries = reinterpret_cast<const PackEntry *>(base + header.indexOffset);
+    entryCount = header.entryCount;
+    for (uint32_t i = 0; valid && i < entryCount; ++i) {
+      const PackEntry &entry = entries[i];
+      valid = entry.offset % packAlignment == 0 && entry.offset <= size &&
+              entry.size <= size - entry.offset &&
+              memchr(entry.name, 0, sizeof(entry.name)) != nullptr;
+    }
+  }
+  if (!valid) {
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void AssetPack::Close() {
+  if (!base)
+    return;
+#ifdef ASSET_PACK_MMAP
+  if (mapped)
+    munmap(const_cast<uint8_t *>(base), size);
+#else
+  ::operator delete(const_cast<uint8_t *>(base),
+                    std::align_val_t(packAlignment));
+#endif
+  base = nullptr;
+  size = 0;
+  entries = nullptr;
+  entryCount = 0;
+  mapped = false;
+}
+
+const PackEntry *AssetPack::Find(const char *name) const {
+  uint32_t low = 0, high = entryCount;
+  while (low < high) {
+    uint32_t mid = (low + high) / 2;
+    int order = strncmp(entries[mid].name, name, sizeof(entries[mid].name));
+    if (order == 0)
+      return &entries[mid];
+    if (order < 0)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return nullptr;
+}
+
+const PackEntry *AssetPack::FindTyped(const char *name, uint32_t type) const {
+  const PackEntry *entry = Find(name);
+  return entry && entry->type == type ? entry : nullptr;
+}
+
+bool AssetPack::GetWave(const char *name, Wave &wave) const {
+  const PackEntry *entry = FindTyped(name, PackWave);
+  if (!entry)
+    return false;
+  Wave found = {entry->params[0], entry->params[1], entry->params[2],
+                entry->params[3], (void *)(base + entry->offset)};
+  if (WaveBytes(found) > entry->size)
+    return false;
+  wave = found;
+  return true;
+}
+
+bool AssetPack::GetImage(const char *name, Image &image) const {
+  const PackEntry *entry = FindTyped(name, PackImage);
+  if (!entry)
+    return false;
+  Image found = {(void *)(base + entry->offset), (int)entry->params[0],
+                 (int)entry->params[1], (int)entry->params[2],
+                 (int)entry->params[3]};
+  if (ImageBytes(found.width, found.height, found.mipmaps, found.format) >
+      entry->size)
+    return false;
+  image = found;
+  return true;
+}
+
+bool AssetPack::GetFont(const char *name, PackedFont &font) const {
+  const PackEntry *entry = FindTyped(name, PackFont);
+  if (!entry)
+    return false;
+  PackedFont found;
+  found.baseSize = (int)entry->params[0];
+  found.glyphCount = (int)entry->params[1];
+  size_t table = AlignUp((size_t)found.glyphCount * sizeof(PackGlyph));
+  found.glyphs = reinterpret_cast<const PackGlyph *>(base + entry->offset);
+  found.atlas = {(void *)(base + entry->offset + table),
+                 (int)entry->params[2], (int)entry->params[3], 1,
+                 (int)entry->params[4]};
+  size_t atlasBytes = ImageBytes(found.atlas.width, found.atlas.height, 1,
+                                 found.atlas.format);
+  if (table > entry->size || atlasBytes > entry->size - table)
+    return false;
+  font = found;
+  return true;
+}
+
+// ----------- AssetPackWriter -----------
+
+size_t AssetPackWriter::Append(const void *data, size_t bytes) {
+  size_t offset = AlignUp(payload.size());
+  payload.resize(offset + bytes);
+  if (bytes)
+    memcpy(payload.data() + offset, data, bytes);
+  return offset;
+}
+
+bool AssetPackWriter::AddEntry(const char *name, uint32_t type,
+                               const void *data, size_t bytes,
+                               PackEntry &entry) {
+  size_t length = strlen(name);
+  if (length == 0 || length >= sizeof(entry.name))
+    return false;
+  for (const PackEntry &existing : entries) {
+    if (strncmp(existing.name, name, sizeof(existing.name)) == 0)
+      return false;
+  }
+  memset(&entry, 0, sizeof(entry));
+  memcpy(entry.name, name, length);
+  entry.type = type;
+  entry.offset = Append(data, bytes);
+  entry.size = bytes;
+  return true;
+}
+
+bool AssetPackWriter::AddWave(const char *name, const Wave &wave) {
+  PackEntry entry;
+  if (!wave.data || !AddEntry(name, PackWave, wave.data, WaveBytes(wave),
+                              entry))
+    return false;
+  entry.params[0] = wave.frameCount;
+  entry.params[1] = wave.sampleRate;
+  entry.params[2] = wave.sampleSize;
+  entry.params[3] = wave.channels;
+  entries.push_back(entry);
+  return true;
+}
+
+bool AssetPackWriter::AddImage(const char *name, const Image &image) {
+  PackEntry entry;
+  size_t bytes =
+      ImageBytes(image.width, image.height, image.mipmaps, image.format);
+  if (!image.data || !AddEntry(name, PackImage, image.data, bytes, entry))
+    return false;
+  entry.params[0] = (uint32_t)image.width;
+  entry.params[1] = (uint32_t)image.height;
+  entry.params[2] = (uint32_t)image.mipmaps;
+  entry.params[3] = (uint32_t)image.format;
+  entries.push_back(entry);
+  return true;
+}
+
+bool AssetPackWriter::AddFont(const char *name, int baseSize,
+                              const GlyphInfo *glyphs, const Rectangle *recs,
+                              int glyphCount, const Image &atlas) {
+  if (!atlas.data || glyphCount <= 0)
+    return false;
+  std::vector<PackGlyph> table(glyphCount);
+  for (int i = 0; i < glyphCount; ++i) {
+    table[i] = {glyphs[i].value,  glyphs[i].offsetX, glyphs[i].offsetY,
+                glyphs[i].advanceX, recs[i].x,       recs[i].y,
+                recs[i].width,    recs[i].height};
+  }
+  PackEntry entry;
+  if (!AddEntry(name, PackFont, table.data(),
+                table.size() * sizeof(PackGlyph), entry))
+    return false;
+  size_t atlasBytes = ImageBytes(atlas.width, atlas.height, 1, atlas.format);
+  size_t atlasOffset = Append(atlas.data, atlasBytes);
+  entry.size = atlasOffset + atlasBytes - entry.offset;
+  entry.params[0] = (uint32_t)baseSize;
+  entry.params[1] = (uint32_t)glyphCount;
+  entry.params[2] = (uint32_t)atlas.width;
+  entry.params[3] = (uint32_t)atlas.height;
+  entry.params[4] = (uint32_t)atlas.format;
+  entries.push_back(entry);
+  return true;
+}
+
+bool AssetPackWriter::Write(const char *path) const {
+  size_t dataStart = AlignUp(sizeof(PackHeader));
+  std::vector<PackEntry> index = entries;
+  for (PackEntry &entry : index) {
+    entry.offset += dataStart;
+  }
+  std::sort(index.begin(), index.end(), NameLess);
+
+  PackHeader header = {};
+  header.magic = packMagic;
+  header.version = packVersion;
+  header.entryCount = (uint32_t)index.size();
+  header.indexOffset = AlignUp(dataStart + payload.size());
+
+  FILE *file = fopen(path, "wb");
+  if (!file)
+    return false;
+  static const uint8_t zeros[packAlignment] = {};
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(zeros, 1, dataStart - sizeof(header), file) ==
+                dataStart - sizeof(header) &&
+            fwrite(payload.data(), 1, payload.size(), file) ==
+                payload.size();
+  size_t padding = header.indexOffset - dataStart - payload.size();
+  ok = ok && fwrite(zeros, 1, padding, file) == padding &&
+       fwrite(index.data(), sizeof(PackEntry), index.size(), file) ==
+           index.size();
+  return fclose(file) == 0 && ok;
+}
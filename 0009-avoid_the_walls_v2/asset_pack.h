@@ -0,0 +1,126 @@
+// asset_pack.h
+
+#pragma once
+
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Pack file layout (little-endian):
+//   PackHeader
+//   payloads, each starting on a packAlignment boundary
+//   PackEntry[entryCount], sorted by name
+// Payloads are stored exactly as raylib holds them in memory (decoded
+// PCM, raw pixels), so loading one is a pointer into the file.
+
+const uint32_t packMagic = 0x4B505741u; // "AWPK"
+const uint32_t packVersion = 1;
+const uint32_t packAlignment = 64;
+
+enum PackAssetType : uint32_t {
+  PackWave = 1,  // params: frameCount, sampleRate, sampleSize, channels
+  PackImage = 2, // params: width, height, mipmaps, format
+  PackFont = 3,  // params: baseSize, glyphCount, atlas width, height, format
+};
+
+struct PackHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t entryCount;
+  uint32_t reserved;
+  uint64_t indexOffset;
+};
+
+struct PackEntry {
+  char name[48]; // Zero padded
+  uint32_t type; // PackAssetType
+  uint32_t params[5];
+  uint64_t offset; // Payload, from the start of the file
+  uint64_t size;
+};
+
+// A font payload: PackGlyph[glyphCount], then the atlas pixels at the
+// next packAlignment boundary
+struct PackGlyph {
+  int32_t value; // Codepoint
+  int32_t offsetX, offsetY, advanceX;
+  float x, y, width, height; // Rectangle in the atlas
+};
+
+// ----------- PackedFont -----------
+// A font atlas and its glyph table, both pointing into a pack
+struct PackedFont {
+  int baseSize;
+  int glyphCount;
+  const PackGlyph *glyphs;
+  Image atlas;
+};
+
+// ----------- AssetPack -----------
+// Manages: one pack file, read-only
+// Should Own:
+//   - The mapping of the file (mmap on desktop, a single read elsewhere)
+//   - Checking the header and index once, when opened
+//   - Finding assets by name (binary search over the sorted index)
+// Should Not:
+//   - Copy or decode payloads: Wave and Image data point into the
+//     mapping, so never UnloadWave/UnloadImage them, and keep the pack
+//     open while they are used (LoadSoundFromWave and
+//     LoadTextureFromImage copy, after which the pack can close)
+class AssetPack {
+public:
+  AssetPack();
+  ~AssetPack();
+  AssetPack(const AssetPack &) = delete;
+  AssetPack &operator=(const AssetPack &) = delete;
+
+  bool Open(const char *path); // False if missing or malformed
+  void Close();
+  bool IsOpen() const { return base != nullptr; }
+
+  const PackEntry *Find(const char *name) const;
+  bool GetWave(const char *name, Wave &wave) const;
+  bool GetImage(const char *name, Image &image) const;
+  bool GetFont(const char *name, PackedFont &font) const;
+
+  int Count() const { return (int)entryCount; }
+  const PackEntry &Entry(int index) const { return entries[index]; }
+  size_t Size() const { return size; }
+
+private:
+  const uint8_t *base;
+  size_t size;
+  const PackEntry *entries;
+  uint32_t entryCount;
+  bool mapped; // Otherwise 'base' is a heap copy
+
+  const PackEntry *FindTyped(const char *name, uint32_t type) const;
+};
+
+// ----------- AssetPackWriter -----------
+// Manages: building a pack (the packer tool and benchmarks)
+// Should Own:
+//   - Copies of the added payloads, laid out as they will be on disk
+// Should Not:
+//   - Load or decode source files (the caller hands over raylib structs)
+class AssetPackWriter {
+public:
+  // False if the name is too long or already used
+  bool AddWave(const char *name, const Wave &wave);
+  bool AddImage(const char *name, const Image &image);
+  bool AddFont(const char *name, int baseSize, const GlyphInfo *glyphs,
+               const Rectangle *recs, int glyphCount, const Image &atlas);
+  bool Write(const char *path) const;
+
+  int Count() const { return (int)entries.size(); }
+  size_t PayloadBytes() const { return payload.size(); }
+
+private:
+  std::vector<PackEntry> entries;
+  std::vector<uint8_t> payload; // Offsets are relative to this until Write
+
+  bool AddEntry(const char *name, uint32_t type, const void *data,
+                size_t bytes, PackEntry &entry);
+  size_t Append(const void *data, size_t bytes); // Aligned, returns offset
+};
@@ -0,0 +1,246 @@
+// batch_sim.cpp
+
+#include "batch_sim.h"
+#include <cstring>
+
+// 4-wide vectors; GCC/Clang lower these to SSE on desktop builds
+typedef float f32x4 __attribute__((vector_size(16)));
+typedef int32_t i32x4 __attribute__((vector_size(16)));
+typedef uint32_t u32x4 __attribute__((vector_size(16)));
+
+template <typename V, typename T> static inline V Load(const T *p) {
+  V v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+template <typename V, typename T> static inline void Store(T *p, V v) {
+  std::memcpy(p, &v, sizeof(v));
+}
+
+static inline f32x4 Splat(float f) { return f32x4{f, f, f, f}; }
+
+// mask lanes are all ones (true) or all zeros (false)
+static inline f32x4 Select(i32x4 mask, f32x4 a, f32x4 b) {
+  return (f32x4)(((i32x4)a & mask) | ((i32x4)b & ~mask));
+}
+
+static inline uint32_t NextRandom(uint32_t &state) {
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+// ----------- PolicyStats -----------
+
+float PolicyStats::Percentile(float p) const {
+  long long wanted = (long long)(p * games);
+  long long seen = 0;
+  for (size_t bin = 0; bin < histogram.size(); ++bin) {
+    seen += histogram[bin];
+    if (seen > wanted)
+      return bin * 0.1f;
+  }
+  return maxSurvival;
+}
+
+// ----------- BatchSimulator -----------
+
+BatchSimulator::BatchSimulator(const SimParams &params, int lanes,
+                               uint32_t seed)
+    : params(params), lanes((lanes + 3) & ~3), seed(seed ? seed : 1) {
+  for (std::vector<float> *array : {&posX, &posY, &dirX, &dirY, &speed,
+                                    &countdown, &elapsed, &lookahead,
+                                    &turnChance, &reaction, &turnWait}) {
+    array->assign(this->lanes, 0.0f);
+  }
+  rng.assign(this->lanes, 0);
+  turns.assign(this->lanes, 0);
+  policyOf.assign(this->lanes, 0);
+  retired.assign(this->lanes, 1);
+}
+
+void BatchSimulator::AddPolicy(const BotPolicy &policy) {
+  policies.push_back(policy);
+  PolicyStats policyStats;
+  policyStats.histogram.assign((size_t)(params.maxSeconds * 10.0f) + 1, 0);
+  stats.push_back(policyStats);
+}
+
+void BatchSimulator::ResetLane(int lane) {
+  // Same start as EntityManager::ResetPlayer
+  posX[lane] = params.fieldWidth / 2 - params.playerSize / 2;
+  posY[lane] = params.fieldHeight / 2 - params.playerSize / 2;
+  static const float dirs[4][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+  int dir = NextRandom(rng[lane]) % 4;
+  dirX[lane] = dirs[dir][0];
+  dirY[lane] = dirs[dir][1];
+  speed[lane] = params.startSpeed;
+  countdown[lane] = params.countdownSeconds;
+  elapsed[lane] = 0.0f;
+  turnWait[lane] = 0.0f;
+  turns[lane] = 0;
+  retired[lane] = 0;
+}
+
+void BatchSimulator::FinishLane(int lane) {
+  PolicyStats &s = stats[policyOf[lane]];
+  float survived = elapsed[lane];
+  if (survived >= params.maxSeconds) {
+    survived = params.maxSeconds;
+    s.timeouts++;
+  }
+  if (s.games == 0 || survived < s.minSurvival)
+    s.minSurvival = survived;
+  if (s.games == 0 || survived > s.maxSurvival)
+    s.maxSurvival = survived;
+  s.games++;
+  s.totalSurvival += survived;
+  s.totalTurns += turns[lane];
+  size_t bin = (size_t)(survived * 10.0f);
+  if (bin >= s.histogram.size())
+    bin = s.histogram.size() - 1;
+  s.histogram[bin]++;
+}
+
+void BatchSimulator::StepBlock(int i, bool *anyEnded) {
+  const f32x4 zero = Splat(0.0f);
+  const f32x4 one = Splat(1.0f);
+  const f32x4 dt = Splat(params.deltaTime);
+  const f32x4 size = Splat(params.playerSize);
+  const f32x4 width = Splat(params.fieldWidth);
+  const f32x4 height = Splat(params.fieldHeight);
+
+  f32x4 x = Load<f32x4>(&posX[i]);
+  f32x4 y = Load<f32x4>(&posY[i]);
+  f32x4 dx = Load<f32x4>(&dirX[i]);
+  f32x4 dy = Load<f32x4>(&dirY[i]);
+  f32x4 s = Load<f32x4>(&speed[i]);
+  f32x4 cd = Load<f32x4>(&countdown[i]);
+  f32x4 el = Load<f32x4>(&elapsed[i]);
+  f32x4 wait = Load<f32x4>(&turnWait[i]);
+  i32x4 turnCount = Load<i32x4>(&turns[i]);
+
+  // Countdown: nothing moves until it runs out (Game::Update)
+  i32x4 active = cd <= zero;
+  cd = Select(active, cd, cd - dt);
+  f32x4 activeF = Select(active, one, zero);
+
+  // Bot: room on each side, and how far the wall ahead is
+  f32x4 roomLeft = x;
+  f32x4 roomRight = width - (x + size);
+  f32x4 roomUp = y;
+  f32x4 roomDown = height - (y + size);
+  f32x4 ahead = Select(dx > zero, roomRight, zero) +
+                Select(dx < zero, roomLeft, zero) +
+                Select(dy > zero, roomDown, zero) +
+                Select(dy < zero, roomUp, zero);
+
+  u32x4 r = Load<u32x4>(&rng[i]);
+  r ^= r << 13;
+  r ^= r >> 17;
+  r ^= r << 5;
+  Store(&rng[i], r);
+  f32x4 roll = __builtin_convertvector(r >> 8, f32x4) * (1.0f / 16777216.0f);
+  // The low byte, for how long this turn takes to react to
+  f32x4 pace = __builtin_convertvector(r & 255u, f32x4) * (1.0f / 256.0f);
+
+  // The best room a turn could give: up or down when moving left/right,
+  // left or right when moving up/down
+  f32x4 horizontal = dx * dx; // 1 when moving left/right, else 0
+  f32x4 roomAcross = Select(roomUp > roomDown, roomUp, roomDown);
+  f32x4 roomAlong = Select(roomLeft > roomRight, roomLeft, roomRight);
+  f32x4 roomAside = horizontal * roomAcross + (one - horizontal) * roomAlong;
+
+  i32x4 wantTurn = ((ahead < Load<f32x4>(&lookahead[i]) * s) &
+                    (roomAside > ahead)) |
+                   (roll < Load<f32x4>(&turnChance[i]));
+  i32x4 turn = active & (wait <= zero) & wantTurn;
+  wait = Select(turn, Load<f32x4>(&reaction[i]) * (Splat(0.5f) + pace),
+                wait - dt * activeF);
+
+  // Turn 90 degrees toward the side with more room
+  f32x4 newDx =
+      (one - horizontal) * Select(roomRight >= roomLeft, one, -one);
+  f32x4 newDy = horizontal * Select(roomDown >= roomUp, one, -one);
+  dx = Select(turn, newDx, dx);
+  dy = Select(turn, newDy, dy);
+  s += Select(turn, Splat(params.speedPerTurn), zero);
+  turnCount -= turn; // true lanes are -1
+
+  // Move and test the walls (PhysicsEngine::Update)
+  f32x4 step = s * dt * activeF;
+  x += dx * step;
+  y += dy * step;
+  el += dt * activeF;
+  i32x4 hit = (x < zero) | (x + size > width) | (y < zero) |
+              (y + size > height) | (el >= Splat(params.maxSeconds));
+  i32x4 ended = active & hit;
+
+  Store(&posX[i], x);
+  Store(&posY[i], y);
+  Store(&dirX[i], dx);
+  Store(&dirY[i], dy);
+  Store(&speed[i], s);
+  Store(&countdown[i], cd);
+  Store(&elapsed[i], el);
+  Store(&turnWait[i], wait);
+  Store(&turns[i], turnCount);
+
+  int32_t endedLanes[4];
+  Store(endedLanes, ended);
+  for (int lane = 0; lane < 4; ++lane) {
+    anyEnded[lane] = endedLanes[lane] != 0;
+  }
+}
+
+long long BatchSimulator::Run(long long games) {
+  if (policies.empty())
+    AddPolicy({"default", 0.3f, 0.0f, 0.2f});
+
+  long long started = 0;
+  long long finished = 0;
+  int liveLanes = 0;
+  for (int lane = 0; lane < lanes; ++lane) {
+    rng[lane] = seed + 0x9E3779B9u * (uint32_t)(lane + 1);
+    int policy = lane % (int)policies.size();
+    policyOf[lane] = policy;
+    lookahead[lane] = policies[policy].lookahead;
+    turnChance[lane] = policies[policy].turnChance;
+    reaction[lane] = policies[policy].reaction;
+    if (started < games) {
+      ResetLane(lane);
+      started++;
+      liveLanes++;
+    } else {
+      retired[lane] = 1;
+      countdown[lane] = 1e30f; // Parked: never leaves the countdown
+    }
+  }
+
+  long long instanceTicks = 0;
+  while (finished < games) {
+    for (int i = 0; i < lanes; i += 4) {
+      bool ended[4];
+      StepBlock(i, ended);
+      for (int lane = 0; lane < 4; ++lane) {
+        if (!ended[lane] || retired[i + lane])
+          continue;
+        FinishLane(i + lane);
+        finished++;
+        if (started < games) {
+          ResetLane(i + lane);
+          started++;
+        } else {
+          retired[i + lane] = 1;
+          countdown[i + lane] = 1e30f;
+          liveLanes--;
+        }
+      }
+    }
+    instanceTicks += liveLanes;
+  }
+  seed = NextRandom(seed);
+  return instanceTicks;
+}
@@ -0,0 +1,100 @@
+// batch_sim.h
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// ----------- SimParams -----------
+// The rules of one Avoid the Walls run, as used by Game (see constants.h).
+// Changing these is what the batch simulator is for.
+struct SimParams {
+  float fieldWidth;
+  float fieldHeight;
+  float playerSize;
+  float startSpeed;       // px/sec after a reset
+  float speedPerTurn;     // px/sec added on every turn
+  float countdownSeconds; // Idle time before the player starts moving
+  float deltaTime;        // Fixed tick length
+  float maxSeconds;       // Runs still alive after this long are stopped
+};
+
+// ----------- BotPolicy -----------
+// A simple bot: turns toward the side with more room when the wall ahead is
+// less than 'lookahead' seconds away and that side has more room than the
+// way ahead (every turn adds speed, so turning into less room only speeds
+// up the crash), and also turns at random with probability 'turnChance'
+// per tick. After any turn it can't turn again for 0.5-1.5 times
+// 'reaction' seconds (drawn per turn), as a player can't press keys
+// arbitrarily fast; without that limit a bot turns every tick once the
+// speed outgrows the field.
+struct BotPolicy {
+  const char *name;
+  float lookahead;
+  float turnChance;
+  float reaction;
+};
+
+// ----------- PolicyStats -----------
+// Survival statistics for every finished run of one policy
+struct PolicyStats {
+  long long games = 0;
+  double totalSurvival = 0.0; // Seconds survived after the countdown
+  float minSurvival = 0.0f;
+  float maxSurvival = 0.0f;
+  long long totalTurns = 0;
+  long long timeouts = 0;     // Runs stopped at maxSeconds
+  std::vector<int> histogram; // Runs per 0.1 s survival bin
+
+  double MeanSurvival() const { return games ? totalSurvival / games : 0.0; }
+  float Percentile(float p) const; // Survival time at percentile p (0-1)
+};
+
+// ----------- BatchSimulator -----------
+// Manages: many independent headless runs stepped in lockstep
+// Should Own:
+//   - Per-run state stored as structure-of-arrays across runs
+//   - Stepping 4 runs at a time with vector math (movement, bot decisions
+//     and wall tests), restarting a run as soon as it ends
+//   - Aggregating survival statistics per bot policy
+// Should Not:
+//   - Call raylib or touch Game (it re-implements the PhysicsEngine rules)
+class BatchSimulator {
+public:
+  BatchSimulator(const SimParams &params, int lanes, uint32_t seed);
+
+  // Lanes are assigned to policies round-robin in the order added
+  void AddPolicy(const BotPolicy &policy);
+
+  // Plays 'games' runs to completion, returns instance-ticks simulated
+  long long Run(long long games);
+
+  const std::vector<BotPolicy> &Policies() const { return policies; }
+  const std::vector<PolicyStats> &Stats() const { return stats; }
+
+private:
+  SimParams params;
+  int lanes; // Padded to a multiple of 4
+  uint32_t seed;
+  std::vector<BotPolicy> policies;
+  std::vector<PolicyStats> stats;
+
+  // Per-lane state
+  std::vector<float> posX, posY;
+  std::vector<float> dirX, dirY;
+  std::vector<float> speed;
+  std::vector<float> countdown;
+  std::vector<float> elapsed;
+  std::vector<float> lookahead;
+  std::vector<float> turnChance;
+  std::vector<float> reaction;
+  std::vector<float> turnWait; // Seconds until the bot may turn again
+  std::vector<uint32_t> rng;
+  std::vector<int32_t> turns;
+  std::vector<int> policyOf;
+  std::vector<char> retired; // No more runs to start on this lane
+
+  void ResetLane(int lane);
+  void FinishLane(int lane);
+  void StepBlock(int first, bool *ended); // ended[4] set per lane
+};
@@ -0,0 +1,182 @@
+// asset_bench.cpp
+//
+// Startup cost of loading assets as loose files (one open and decode per
+// file through raylib's loaders) against one mapped AssetPack.
+//
+//   1. write images (256x256 PNG) and sounds (1 s 16-bit mono WAV) to
+//      asset_bench_files/
+//   2. pack the same decoded assets into asset_bench_files/assets.pak
+//   3. load everything both ways and read every byte, cold (the files
+//      dropped from the page cache first) and warm; medians of the runs
+//
+// Usage: asset_bench [images] [sounds] [runs]
+
+#include "../asset_pack.h"
+#include "raylib.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const char *dir = "asset_bench_files";
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Reads every byte, as uploading or mixing the asset would
+static uint32_t Touch(const void *data, size_t bytes) {
+  const uint8_t *p = static_cast<const uint8_t *>(data);
+  uint32_t sum = 0;
+  for (size_t i = 0; i < bytes; i += 64)
+    sum += p[i];
+  return sum;
+}
+
+static void DropFromCache(const std::string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return;
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+static double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+int main(int argc, char **argv) {
+  int imageCount = argc > 1 ? atoi(argv[1]) : 64;
+  int soundCount = argc > 2 ? atoi(argv[2]) : 32;
+  int runs = argc > 3 ? atoi(argv[3]) : 5;
+  SetTraceLogLevel(LOG_WARNING);
+  mkdir(dir, 0755);
+
+  std::vector<std::string> images, sounds, files;
+  AssetPackWriter writer;
+  for (int i = 0; i < imageCount; ++i) {
+    std::string name = "image" + std::to_string(i) + ".png";
+    Image image = GenImagePerlinNoise(256, 256, i * 256, 0, 4.0f);
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    ExportImage(image, (std::string(dir) + "/" + name).c_str());
+    writer.AddImage(name.c_str(), image);
+    UnloadImage(image);
+    images.push_back(name);
+  }
+  const int sampleRate = 44100;
+  std::vector<short> samples(sampleRate);
+  for (int i = 0; i < soundCount; ++i) {
+    std::string name = "sound" + std::to_string(i) + ".wav";
+    float pitch = 220.0f + 20.0f * i;
+    for (int s = 0; s < sampleRate; ++s)
+      samples[s] = (short)(8000.0f * sinf(2.0f * PI * pitch * s / sampleRate));
+    Wave wave = {(unsigned int)sampleRate, (unsigned int)sampleRate, 16, 1,
+                 samples.data()};
+    ExportWave(wave, (std::string(dir) + "/" + name).c_str());
+    writer.AddWave(name.c_str(), wave);
+    sounds.push_back(name);
+  }
+  std::string packPath = std::string(dir) + "/assets.pak";
+  if (!writer.Write(packPath.c_str())) {
+    printf("asset_bench: can't write %s\n", packPath.c_str());
+    return 1;
+  }
+  for (const std::string &name : images)
+    files.push_back(std::string(dir) + "/" + name);
+  for (const std::string &name : sounds)
+    files.push_back(std::string(dir) + "/" + name);
+  sync(); // Dropping pages only works for clean ones
+
+  uint32_t checksum = 0;
+  auto loadLoose = [&]() {
+    for (const std::string &name : images) {
+      Image image = LoadImage((std::string(dir) + "/" + name).c_str());
+      checksum += Touch(image.data, (size_t)GetPixelDataSize(
+                                        image.width, image.height,
+                                        image.format));
+      UnloadImage(image);
+    }
+    for (const std::string &name : sounds) {
+      Wave wave = LoadWave((std::string(dir) + "/" + name).c_str());
+      checksum += Touch(wave.data, (size_t)wave.frameCount * wave.channels *
+                                       wave.sampleSize / 8);
+      UnloadWave(wave);
+    }
+  };
+  int packMissing = 0;
+  auto loadPack = [&]() {
+    AssetPack pack;
+    if (!pack.Open(packPath.c_str())) {
+      packMissing++;
+      return;
+    }
+    for (const std::string &name : images) {
+      Image image;
+      if (pack.GetImage(name.c_str(), image))
+        checksum += Touch(image.data, (size_t)GetPixelDataSize(
+                                          image.width, image.height,
+                                          image.format));
+      else
+        packMissing++;
+    }
+    for (const std::string &name : sounds) {
+      Wave wave;
+      if (pack.GetWave(name.c_str(), wave))
+        checksum += Touch(wave.data, (size_t)wave.frameCount *
+                                         wave.channels * wave.sampleSize / 8);
+      else
+        packMissing++;
+    }
+  };
+
+  std::vector<double> looseCold, looseWarm, packCold, packWarm;
+  for (int run = 0; run < runs; ++run) {
+    for (const std::string &file : files)
+      DropFromCache(file);
+    Clock::time_point start = Clock::now();
+    loadLoose();
+    looseCold.push_back(Seconds(start));
+    start = Clock::now();
+    loadLoose();
+    looseWarm.push_back(Seconds(start));
+
+    DropFromCache(packPath);
+    start = Clock::now();
+    loadPack();
+    packCold.push_back(Seconds(start));
+    start = Clock::now();
+    loadPack();
+    packWarm.push_back(Seconds(start));
+  }
+
+  struct stat packInfo;
+  stat(packPath.c_str(), &packInfo);
+  size_t looseBytes = 0;
+  for (const std::string &file : files) {
+    struct stat info;
+    if (stat(file.c_str(), &info) == 0)
+      looseBytes += (size_t)info.st_size;
+  }
+  printf("%d images, %d sounds: %zu loose files (%.1f MiB), "
+         "one pack (%.1f MiB)\n",
+         imageCount, soundCount, files.size(), looseBytes / 1048576.0,
+         packInfo.st_size / 1048576.0);
+  printf("             cold ms    warm ms\n");
+  printf("loose     %10.2f %10.2f\n", Median(looseCold) * 1e3,
+         Median(looseWarm) * 1e3);
+  printf("pack      %10.2f %10.2f\n", Median(packCold) * 1e3,
+         Median(packWarm) * 1e3);
+  if (packMissing)
+    printf("pack: %d lookups failed\n", packMissing);
+  printf("(checksum %u)\n", checksum);
+  return 0;
+}
@@ -0,0 +1,118 @@
+// capture_bench.cpp
+//
+// What recording costs the game loop: a headless Game played by a script
+// and rendered at 800x600, with and without a FrameCapture writing a Y4M
+// stream.
+//   software - the software rasterizer; capture copies its frame
+//   gl       - a hidden window; capture reads back through pixel buffer
+//              objects (skipped when no window opens)
+// For each: Render() per frame (median and 99th percentile), the
+// capture's own time on the game loop (mean and worst), the writer
+// thread's time per frame, and frames dropped because the ring was full.
+// 'paced' runs sleep out each 60 Hz frame like the game; 'flat out'
+// renders back to back, faster than any disk, to show the drops.
+//
+// Usage: capture_bench [frames] [file.y4m]
+
+#include "../capture.h"
+#include "../game.h"
+#include "../soft_raster.h"
+#include "raylib.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int captureWidth = 800;
+static const int captureHeight = 600;
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double Percentile(std::vector<double> values, double p) {
+  std::sort(values.begin(), values.end());
+  return values[(size_t)(p * (values.size() - 1))];
+}
+
+// Render() time per frame (seconds); the same script as layer_bench
+static std::vector<double> Play(Game &game, ScriptedInput &input, int frames,
+                                bool paced) {
+  const float dt = 1.0f / 60.0f;
+  std::vector<double> times;
+  Clock::time_point next = Clock::now();
+  for (int f = 0; f < frames; ++f) {
+    if (game.gameState.gameOver)
+      input.Press(KEY_R);
+    else if (f % 45 == 0)
+      input.Press(f % 90 ? KEY_LEFT : KEY_UP);
+    game.Step(dt);
+    input.Clear();
+    Clock::time_point start = Clock::now();
+    game.Render();
+    times.push_back(Seconds(start));
+    if (paced) {
+      next += std::chrono::microseconds(16667);
+      std::this_thread::sleep_until(next);
+    }
+  }
+  return times;
+}
+
+static void Run(const char *backend, const char *pace, bool paced,
+                SoftwareRasterizer *raster, const char *path, int frames) {
+  ScriptedInput input;
+  Game game(input, 12345u);
+  game.renderer.SetSoftwareTarget(raster);
+  FrameCapture capture;
+  if (path) {
+    if (!capture.Open(path, captureWidth, captureHeight, 60)) {
+      printf("capture_bench: can't write %s\n", path);
+      return;
+    }
+    game.renderer.SetCapture(&capture);
+  }
+  std::vector<double> times = Play(game, input, frames, paced);
+  game.renderer.SetCapture(nullptr);
+  capture.Close();
+
+  printf("%-8s %-8s %-4s %9.3f %9.3f", backend, pace, path ? "on" : "off",
+         Percentile(times, 0.5) * 1e3, Percentile(times, 0.99) * 1e3);
+  if (path)
+    printf(" %9.1f %9.1f %9.1f %7lld %7lld", capture.MeanCaptureMicroseconds(),
+           capture.MaxCaptureMicroseconds(), capture.MeanWriteMicroseconds(),
+           capture.Dropped(), capture.Written());
+  printf("\n");
+}
+
+int main(int argc, char **argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 600;
+  const char *path = argc > 2 ? argv[2] : "capture_bench.y4m";
+
+  SetTraceLogLevel(LOG_WARNING);
+  SetConfigFlags(FLAG_WINDOW_HIDDEN);
+  InitWindow(captureWidth, captureHeight, "capture_bench");
+  bool window = IsWindowReady();
+
+  printf("%d frames at %dx%d into %s\n", frames, captureWidth, captureHeight,
+         path);
+  printf("backend  pace     cap   ms p50    ms p99   cap us   cap max  "
+         "write us dropped written\n");
+  SoftwareRasterizer raster(captureWidth, captureHeight, 1);
+  Run("software", "paced", true, &raster, nullptr, frames);
+  Run("software", "paced", true, &raster, path, frames);
+  Run("software", "flat out", false, &raster, path, frames);
+  if (window) {
+    Run("gl", "paced", true, nullptr, nullptr, frames);
+    Run("gl", "paced", true, nullptr, path, frames);
+    Run("gl", "flat out", false, nullptr, path, frames);
+    CloseWindow();
+  } else {
+    printf("gl: no window (needs a display, or Xvfb)\n");
+  }
+  return 0;
+}
@@ -0,0 +1,102 @@
+// layer_bench.cpp
+//
+// What caching the static layers (layer_cache.h) saves: a headless Game
+// played by a script for 'frames' 60 Hz frames, rendered with the layer
+// cache on and off.
+//   redraws - per layer, how often its content was drawn into its texture
+//             against how often it went on screen
+//   fill    - per layer, pixels filled with the cache (redraws, texture
+//             clears, composites) against drawing the content every frame
+//   time    - median Render() per frame, cache on and off
+// Opens a hidden window. Run under Mesa's llvmpipe to measure without a
+// GPU:
+//   LIBGL_ALWAYS_SOFTWARE=1 GALLIUM_DRIVER=llvmpipe ./layer_bench
+//
+// Usage: layer_bench [frames]
+
+#include "../constants.h"
+#include "../game.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+// Render() time per frame (seconds); the same script every run, turning
+// now and then and restarting after every game over
+static std::vector<double> Play(Game &game, ScriptedInput &input,
+                                int frames) {
+  const float dt = 1.0f / 60.0f;
+  std::vector<double> times;
+  for (int f = 0; f < frames; ++f) {
+    if (game.gameState.gameOver)
+      input.Press(KEY_R);
+    else if (f % 45 == 0)
+      input.Press(f % 90 ? KEY_LEFT : KEY_UP);
+    game.Step(dt);
+    input.Clear();
+    Clock::time_point start = Clock::now();
+    game.Render();
+    times.push_back(Seconds(start));
+  }
+  return times;
+}
+
+static void PrintLayer(const char *name, const CachedLayer &layer,
+                       int frames) {
+  double cached = layer.RedrawPixels() + layer.CompositePixels();
+  double direct = layer.DirectPixels();
+  printf("%-12s %8lld %10lld %12.1f %12.1f %8.0f%%\n", name, layer.Redraws(),
+         layer.Composites(), cached / frames / 1000.0,
+         direct / frames / 1000.0,
+         direct > 0.0 ? (direct - cached) * 100.0 / direct : 0.0);
+}
+
+int main(int argc, char **argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 3600;
+
+  SetTraceLogLevel(LOG_WARNING);
+  SetConfigFlags(FLAG_WINDOW_HIDDEN);
+  InitWindow(screenWidth, screenHeight, "layer_bench");
+  if (!IsWindowReady()) {
+    printf("layer_bench: no window (needs a display, or Xvfb)\n");
+    return 1;
+  }
+
+  ScriptedInput cachedInput;
+  Game cachedGame(cachedInput, 12345u);
+  std::vector<double> cachedTimes = Play(cachedGame, cachedInput, frames);
+  int cachedCommands = cachedGame.renderer.Queue().Count();
+
+  ScriptedInput directInput;
+  Game directGame(directInput, 12345u);
+  directGame.renderer.SetLayerCaching(false);
+  std::vector<double> directTimes = Play(directGame, directInput, frames);
+  int directCommands = directGame.renderer.Queue().Count();
+
+  const Renderer &r = cachedGame.renderer;
+  printf("%d frames at %dx%d\n", frames, screenWidth, screenHeight);
+  printf("layer         redraws composites  kpx/frame    kpx/frame     fill\n");
+  printf("                                     cached       direct    saved\n");
+  PrintLayer("background", r.Background(), frames);
+  PrintLayer("hud chrome", r.HudChrome(), frames);
+  printf("commands in the last frame: %d cached, %d direct\n", cachedCommands,
+         directCommands);
+  printf("Render(), median: %.1f us cached, %.1f us direct\n",
+         Median(cachedTimes) * 1e6, Median(directTimes) * 1e6);
+  cachedGame.renderer.UnloadLayers();
+  directGame.renderer.UnloadLayers();
+  CloseWindow();
+  return 0;
+}
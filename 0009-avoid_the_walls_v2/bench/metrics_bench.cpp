@@ -0,0 +1,150 @@
+// metrics_bench.cpp
+//
+// What publishing live metrics costs the game loop, and whether scraping
+// them ever holds a frame up.
+//
+//   1. a headless Game stepped at 60 Hz (virtual clock), without and
+//      with PublishMetrics after every frame
+//   2. the same for about 2 s with a MetricsServer on a Unix socket and
+//      a client thread scraping it (100 times a second by default; 0
+//      scrapes back to back), then as long again unscraped
+//   3. PublishMetrics on its own, against a 60 Hz frame budget
+//
+// Usage: metrics_bench [frames] [rounds] [scrapes per second]
+
+#include "../game.h"
+#include "../metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct RunResult {
+  double nsPerFrame;
+  double p99Ns;
+  double maxNs;
+};
+
+// Restarts after every game over so the simulation keeps doing work
+static RunResult RunFrames(Game &game, ScriptedInput &input, int frames,
+                           bool publish) {
+  const float dt = 1.0f / 60.0f;
+  std::vector<double> times(frames);
+  double total = 0.0;
+  for (int f = 0; f < frames; ++f) {
+    Clock::time_point start = Clock::now();
+    if (game.gameState.gameOver)
+      input.Press(KEY_R);
+    game.Step(dt);
+    input.Clear();
+    if (publish)
+      game.PublishMetrics(game.simTime, game.simTime + 0.002);
+    times[f] = Seconds(start);
+    total += times[f];
+  }
+  std::sort(times.begin(), times.end());
+  return {total * 1e9 / frames, times[frames * 99 / 100] * 1e9,
+          times[frames - 1] * 1e9};
+}
+
+// Over several runs: summed means (divide by the count), worst p99 and max
+static void Accumulate(RunResult &into, const RunResult &run) {
+  into.nsPerFrame += run.nsPerFrame;
+  into.p99Ns = std::max(into.p99Ns, run.p99Ns);
+  into.maxNs = std::max(into.maxNs, run.maxNs);
+}
+
+static double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+int main(int argc, char **argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 200000;
+  int rounds = argc > 2 ? atoi(argv[2]) : 5;
+  double scrapeRate = argc > 3 ? atof(argv[3]) : 100.0;
+  const double frameBudgetNs = 1e9 / 60.0;
+
+  ScriptedInput input;
+  Game game(input, 12345u);
+
+  // 1. Without and with publishing, interleaved so drift hits both
+  std::vector<double> plain, published;
+  for (int r = 0; r < rounds; ++r) {
+    plain.push_back(RunFrames(game, input, frames, false).nsPerFrame);
+    published.push_back(RunFrames(game, input, frames, true).nsPerFrame);
+  }
+
+  // 2. Scraped while it runs
+  std::string endpoint = "unix:/tmp/metrics_bench_" +
+                         std::to_string((long long)getpid()) + ".sock";
+  MetricsServer server(game.metrics);
+  if (!server.Start(endpoint.c_str())) {
+    printf("metrics_bench: can't listen on %s\n", endpoint.c_str());
+    return 1;
+  }
+  std::atomic<bool> scraping(true);
+  std::atomic<long long> scrapes(0);
+  size_t jsonBytes = 0;
+  std::thread scraper([&]() {
+    std::string json;
+    while (scraping) {
+      if (ScrapeMetrics(endpoint.c_str(), json)) {
+        scrapes++;
+        jsonBytes = json.size();
+      }
+      if (scrapeRate > 0.0)
+        std::this_thread::sleep_for(
+            std::chrono::duration<double>(1.0 / scrapeRate));
+    }
+  });
+  Clock::time_point start = Clock::now();
+  int chunks = 0;
+  RunResult scraped = {0.0, 0.0, 0.0};
+  for (; Seconds(start) < 2.0; ++chunks) {
+    Accumulate(scraped, RunFrames(game, input, frames, true));
+  }
+  scraped.nsPerFrame /= chunks;
+  double scrapedSeconds = Seconds(start);
+  scraping = false;
+  scraper.join();
+  server.Stop();
+  RunResult quiet = {0.0, 0.0, 0.0};
+  for (int c = 0; c < chunks; ++c) {
+    Accumulate(quiet, RunFrames(game, input, frames, true));
+  }
+  quiet.nsPerFrame /= chunks;
+
+  // 3. Publishing alone
+  start = Clock::now();
+  for (int f = 0; f < frames; ++f) {
+    game.PublishMetrics(f / 60.0, f / 60.0 + 0.002);
+  }
+  double publishNs = Seconds(start) * 1e9 / frames;
+
+  double plainNs = Median(plain), publishedNs = Median(published);
+  printf("%d frames x %d rounds (headless Step at 60 Hz)\n", frames, rounds);
+  printf("step only            %8.1f ns/frame\n", plainNs);
+  printf("step + publish       %8.1f ns/frame (%+.1f ns)\n", publishedNs,
+         publishedNs - plainNs);
+  printf("publish alone        %8.1f ns/frame = %.5f%% of a 60 Hz frame\n",
+         publishNs, publishNs * 100.0 / frameBudgetNs);
+  printf("while scraped        %8.1f ns/frame, p99 %.0f ns, max %.0f ns\n",
+         scraped.nsPerFrame, scraped.p99Ns, scraped.maxNs);
+  printf("not scraped          %8.1f ns/frame, p99 %.0f ns, max %.0f ns\n",
+         quiet.nsPerFrame, quiet.p99Ns, quiet.maxNs);
+  printf("scrapes              %lld (%.0f/s, %zu bytes of JSON each)\n",
+         scrapes.load(), scrapes.load() / scrapedSeconds, jsonBytes);
+  return 0;
+}
@@ -0,0 +1,160 @@
+// raster_bench.cpp
+//
+// Frames per second of the software rasterizer (soft_raster.h) at
+// 800x600, for each thread count, with the SSE2 kernels on and off.
+//   game  - a headless Game played by a script, Render() into the
+//           rasterizer every frame (record, sort and rasterize)
+//   heavy - one fixed frame of 'shapes' translucent rectangles and
+//           circles with text over them, rasterized again and again
+// Every run of a scene must end on the same pixels: the hashes are
+// compared and a mismatch fails the benchmark. The last game frame is
+// written to raster_bench.png.
+//
+// Text needs raylib's default font, which InitWindow loads: the bench
+// opens a hidden window when it can and otherwise draws no text.
+//
+// Usage: raster_bench [frames] [shapes]
+
+#include "../game.h"
+#include "../soft_raster.h"
+#include "raylib.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int rasterWidth = 800;
+static const int rasterHeight = 600;
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+struct Run {
+  double seconds; // Median per frame
+  uint64_t hash;  // Of the last frame
+};
+
+// The same script as layer_bench: turning now and then, restarting
+// after every game over
+static Run PlayGame(SoftwareRasterizer &raster, int frames) {
+  const float dt = 1.0f / 60.0f;
+  ScriptedInput input;
+  Game game(input, 12345u);
+  game.renderer.SetSoftwareTarget(&raster);
+  std::vector<double> times;
+  for (int f = 0; f < frames; ++f) {
+    if (game.gameState.gameOver)
+      input.Press(KEY_R);
+    else if (f % 45 == 0)
+      input.Press(f % 90 ? KEY_LEFT : KEY_UP);
+    game.Step(dt);
+    input.Clear();
+    Clock::time_point start = Clock::now();
+    game.Render();
+    times.push_back(Seconds(start));
+  }
+  return Run{Median(times), raster.Hash()};
+}
+
+static void RecordHeavy(RenderQueue &queue, int shapes) {
+  std::mt19937 rng(7u);
+  std::uniform_real_distribution<float> x(-20.0f, (float)rasterWidth);
+  std::uniform_real_distribution<float> y(-20.0f, (float)rasterHeight);
+  std::uniform_real_distribution<float> size(4.0f, 60.0f);
+  queue.Clear();
+  for (int i = 0; i < shapes; ++i) {
+    Color color = {(unsigned char)(rng() & 0xFF),
+                   (unsigned char)(rng() & 0xFF),
+                   (unsigned char)(rng() & 0xFF),
+                   (unsigned char)(96 + rng() % 160)};
+    if (i % 2)
+      queue.PushRectangle(LayerWorld, (uint32_t)i,
+                          {x(rng), y(rng), size(rng), size(rng)}, color);
+    else
+      queue.PushCircle(LayerWorld, (uint32_t)i, {x(rng), y(rng)},
+                       size(rng) / 2.0f, color);
+  }
+  for (int line = 0; line < 20; ++line) {
+    queue.PushText(LayerHud, 0, "The quick brown fox jumps over the wall",
+                   10, 10 + line * 29, 10 + line % 3 * 10, WHITE);
+  }
+  queue.Sort();
+}
+
+static Run DrawHeavy(SoftwareRasterizer &raster, const RenderQueue &queue,
+                     int frames) {
+  std::vector<double> times;
+  for (int f = 0; f < frames; ++f) {
+    Clock::time_point start = Clock::now();
+    raster.Draw(queue, BLACK);
+    times.push_back(Seconds(start));
+  }
+  return Run{Median(times), raster.Hash()};
+}
+
+static void Print(const char *scene, int threads, bool simd, const Run &run) {
+  printf("%-6s %7d %5s %10.3f %8.0f  %016" PRIx64 "\n", scene, threads,
+         simd ? "on" : "off", run.seconds * 1e3, 1.0 / run.seconds,
+         run.hash);
+}
+
+int main(int argc, char **argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 600;
+  int shapes = argc > 2 ? atoi(argv[2]) : 2000;
+
+  SetTraceLogLevel(LOG_WARNING);
+  SetConfigFlags(FLAG_WINDOW_HIDDEN);
+  InitWindow(rasterWidth, rasterHeight, "raster_bench");
+  bool window = IsWindowReady();
+
+  std::vector<int> threadCounts = {1, 2, 4};
+  int cores = (int)std::thread::hardware_concurrency();
+  if (cores > 4)
+    threadCounts.push_back(cores);
+
+  RenderQueue heavy;
+  RecordHeavy(heavy, shapes);
+
+  printf("%dx%d, %d frames, %d heavy shapes, %d cores, text %s\n",
+         rasterWidth, rasterHeight, frames, shapes, cores,
+         window ? "on" : "off (no window)");
+  printf("scene  threads  simd   ms/frame      fps  hash\n");
+  uint64_t gameHash = 0, heavyHash = 0;
+  bool same = true;
+  bool first = true;
+  for (int threads : threadCounts) {
+    for (int simd = 1; simd >= 0; --simd) {
+      SoftwareRasterizer raster(rasterWidth, rasterHeight, threads);
+      raster.SetSimd(simd != 0);
+      Run game = PlayGame(raster, frames);
+      Print("game", threads, simd, game);
+      if (first)
+        raster.ExportPng("raster_bench.png");
+      Run run = DrawHeavy(raster, heavy, frames);
+      Print("heavy", threads, simd, run);
+      if (first) {
+        gameHash = game.hash;
+        heavyHash = run.hash;
+        first = false;
+      }
+      same = same && game.hash == gameHash && run.hash == heavyHash;
+    }
+  }
+  printf("pixels %s across thread counts and kernels\n",
+         same ? "identical" : "DIFFER");
+  if (window)
+    CloseWindow();
+  return same ? 0 : 1;
+}
@@ -0,0 +1,222 @@
+// render_bench.cpp
+//
+// One RenderQueue frame of 100k commands, recorded in a shuffled order:
+// rectangles, circles, text and sprites from four textures, spread over
+// the layers and an isometric-style depth (screen y).
+//   record  - pushing every command into the queue
+//   sort    - the queue's radix sort against std::stable_sort on the
+//             same keys (the two must agree item for item)
+//   batches - shader/texture changes rlgl would flush, unsorted vs sorted
+//   submit  - drawing the frame both ways in a hidden window
+// Run under software GL to take the GPU out of it:
+//   LIBGL_ALWAYS_SOFTWARE=1 ./render_bench
+//
+// Usage: render_bench [commands] [runs]
+
+#include "../render_queue.h"
+#include "raylib.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int screenW = 800;
+static const int screenH = 600;
+static const int textureCount = 4;
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double Median(std::vector<double> &times) {
+  std::sort(times.begin(), times.end());
+  return times[times.size() / 2];
+}
+
+// What one command draws, picked up front so recording only pushes
+struct Planned {
+  int kind; // RenderPrimitive
+  RenderLayer layer;
+  float x, y;
+  int texture;
+  Color color;
+};
+
+static std::vector<Planned> Plan(int count) {
+  std::mt19937 rng(11u);
+  std::uniform_real_distribution<float> x(0.0f, (float)screenW);
+  std::uniform_real_distribution<float> y(0.0f, (float)screenH);
+  std::uniform_int_distribution<int> percent(0, 99);
+  std::vector<Planned> plan(count);
+  for (Planned &p : plan) {
+    int roll = percent(rng);
+    p.kind = roll < 40   ? PrimitiveRectangle
+             : roll < 70 ? PrimitiveCircle
+             : roll < 80 ? PrimitiveText
+                         : PrimitiveTexture;
+    // Mostly world, some background and HUD, a little overlay
+    int layerRoll = percent(rng);
+    p.layer = layerRoll < 10   ? LayerBackground
+              : layerRoll < 85 ? LayerWorld
+              : layerRoll < 97 ? LayerHud
+                               : LayerOverlay;
+    p.x = x(rng);
+    p.y = y(rng);
+    p.texture = (int)(rng() % textureCount);
+    p.color = Color{(unsigned char)(rng() & 0xFF),
+                    (unsigned char)(rng() & 0xFF),
+                    (unsigned char)(rng() & 0xFF), 255};
+  }
+  return plan;
+}
+
+static void Record(RenderQueue &queue, const std::vector<Planned> &plan,
+                   const Texture2D *textures) {
+  queue.Clear();
+  for (const Planned &p : plan) {
+    // Only the world is depth sorted; flat layers keep push order
+    uint32_t depth = p.layer == LayerWorld ? (uint32_t)p.y : 0;
+    switch (p.kind) {
+    case PrimitiveRectangle:
+      queue.PushRectangle(p.layer, depth, {p.x, p.y, 6.0f, 6.0f}, p.color);
+      break;
+    case PrimitiveCircle:
+      queue.PushCircle(p.layer, depth, {p.x, p.y}, 3.0f, p.color);
+      break;
+    case PrimitiveText:
+      queue.PushText(p.layer, depth, "42", (int)p.x, (int)p.y, 10, p.color);
+      break;
+    default: {
+      const Texture2D &t = textures[p.texture];
+      queue.PushTexture(p.layer, depth, t,
+                        {0.0f, 0.0f, (float)t.width, (float)t.height},
+                        {p.x, p.y, 8.0f, 8.0f}, WHITE);
+      break;
+    }
+    }
+  }
+}
+
+// The keys as the queue recorded them, to sort outside of it
+static std::vector<RenderSortItem> Items(const std::vector<Planned> &plan,
+                                         const Texture2D *textures) {
+  std::vector<RenderSortItem> items;
+  for (size_t i = 0; i < plan.size(); ++i) {
+    const Planned &p = plan[i];
+    uint32_t depth = p.layer == LayerWorld ? (uint32_t)p.y : 0;
+    uint16_t texture = p.kind == PrimitiveTexture
+                           ? (uint16_t)textures[p.texture].id
+                       : p.kind == PrimitiveText ? renderFontTexture
+                                                 : renderShapesTexture;
+    items.push_back({MakeRenderKey(p.layer, depth, 0, texture,
+                                   (RenderPrimitive)p.kind),
+                     (uint32_t)i});
+  }
+  return items;
+}
+
+int main(int argc, char **argv) {
+  int count = argc > 1 ? atoi(argv[1]) : 100000;
+  int runs = argc > 2 ? atoi(argv[2]) : 21;
+
+  SetTraceLogLevel(LOG_WARNING);
+  SetConfigFlags(FLAG_WINDOW_HIDDEN);
+  InitWindow(screenW, screenH, "render_bench");
+  bool window = IsWindowReady();
+  Texture2D textures[textureCount] = {};
+  const Color tints[textureCount] = {RED, GREEN, BLUE, YELLOW};
+  for (int t = 0; t < textureCount; ++t) {
+    Image image = GenImageColor(16, 16, tints[t]);
+    textures[t] = window ? LoadTextureFromImage(image) : Texture2D{};
+    textures[t].id = window ? textures[t].id : (unsigned)(t + 2);
+    textures[t].width = textures[t].height = 16;
+    UnloadImage(image);
+  }
+
+  std::vector<Planned> plan = Plan(count);
+  RenderQueue queue;
+  queue.Reserve(count, count * 3);
+
+  // Record
+  std::vector<double> recordTimes;
+  for (int r = 0; r < runs; ++r) {
+    Clock::time_point start = Clock::now();
+    Record(queue, plan, textures);
+    recordTimes.push_back(Seconds(start));
+  }
+  int unsortedBreaks = queue.BatchBreaks();
+
+  // Sort: the queue's own, then both sorts on the bare keys
+  std::vector<double> queueTimes, radixTimes, stableTimes;
+  std::vector<RenderSortItem> keys = Items(plan, textures);
+  std::vector<RenderSortItem> work, scratch(keys.size()), stable;
+  bool same = true;
+  for (int r = 0; r < runs; ++r) {
+    Record(queue, plan, textures);
+    Clock::time_point start = Clock::now();
+    queue.Sort();
+    queueTimes.push_back(Seconds(start));
+
+    work = keys;
+    start = Clock::now();
+    RenderSortItem *sorted =
+        RadixSortRenderItems(work.data(), scratch.data(), work.size());
+    radixTimes.push_back(Seconds(start));
+
+    stable = keys;
+    start = Clock::now();
+    std::stable_sort(stable.begin(), stable.end(),
+                     [](const RenderSortItem &a, const RenderSortItem &b) {
+                       return a.key < b.key;
+                     });
+    stableTimes.push_back(Seconds(start));
+    for (size_t i = 0; i < stable.size() && same; ++i)
+      same = sorted[i].key == stable[i].key &&
+             sorted[i].command == stable[i].command;
+  }
+  int sortedBreaks = queue.BatchBreaks();
+
+  printf("%d commands, 4 layers, %d textures (median of %d runs)\n", count,
+         textureCount, runs);
+  printf("record                 %8.0f us\n", Median(recordTimes) * 1e6);
+  printf("sort, RenderQueue      %8.0f us\n", Median(queueTimes) * 1e6);
+  printf("sort, radix (keys)     %8.0f us\n", Median(radixTimes) * 1e6);
+  printf("sort, std::stable_sort %8.0f us\n", Median(stableTimes) * 1e6);
+  printf("radix == stable_sort:  %s\n", same ? "yes" : "NO");
+  printf("batch breaks           %8d unsorted, %d sorted\n", unsortedBreaks,
+         sortedBreaks);
+
+  // Submit, each way, a frame at a time
+  if (window) {
+    std::vector<double> unsortedTimes, sortedTimes;
+    for (int r = 0; r < runs; ++r) {
+      Record(queue, plan, textures);
+      Clock::time_point start = Clock::now();
+      BeginDrawing();
+      ClearBackground(BLACK);
+      queue.Submit();
+      EndDrawing();
+      unsortedTimes.push_back(Seconds(start));
+
+      queue.Sort();
+      start = Clock::now();
+      BeginDrawing();
+      ClearBackground(BLACK);
+      queue.Submit();
+      EndDrawing();
+      sortedTimes.push_back(Seconds(start));
+    }
+    printf("submit, unsorted       %8.0f us\n", Median(unsortedTimes) * 1e6);
+    printf("submit, sorted         %8.0f us\n", Median(sortedTimes) * 1e6);
+    for (const Texture2D &t : textures)
+      UnloadTexture(t);
+    CloseWindow();
+  } else {
+    printf("submit: no window (needs a display, or Xvfb)\n");
+  }
+  return same ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+// sequence_bench.cpp
+//
+// 100k coroutine sequences suspended at once on a SequenceRunner, against
+// the same behaviour written as per-frame polled flags.
+//
+//   1. start 100k sequences: each waits a random delay, then every fourth
+//      one also waits for a "wave" signal, and loops
+//   2. run the clock at 60 Hz for 60 s, raising the wave every 5 s
+//   3. stop them all where they wait
+//   4. park 100k sequences on a signal that is never raised: ticks should
+//      cost nothing; then raise it once
+//
+// Usage: sequence_bench [sequences] [seconds]
+
+#include "../sequence.h"
+#include "../timer_wheel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static uint32_t rngState = 12345u;
+
+static float Random01() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return (rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static long long resumes = 0;
+
+static Sequence Wanderer(SequenceRunner &runner, Signal &wave, int id,
+                         float span) {
+  for (;;) {
+    co_await runner.Delay(0.5f + Random01() * span);
+    resumes++;
+    if (id % 4 == 0) {
+      co_await wave;
+      resumes++;
+    }
+  }
+}
+
+static Sequence Parked(SequenceRunner &runner, Signal &never) {
+  co_await never;
+  resumes++;
+}
+
+// The polled version: what GameState-style flags cost per frame
+struct PolledTask {
+  float remaining;
+  bool waitingForWave;
+};
+
+static void PrintTicks(const char *name, std::vector<double> &times) {
+  double total = 0.0;
+  for (double t : times)
+    total += t;
+  std::sort(times.begin(), times.end());
+  printf("%-10s %8.3f ms/tick mean, p99 %.3f ms\n", name,
+         total * 1e3 / times.size(), times[times.size() * 99 / 100] * 1e3);
+}
+
+int main(int argc, char **argv) {
+  int count = argc > 1 ? atoi(argv[1]) : 100000;
+  float seconds = argc > 2 ? (float)atof(argv[2]) : 60.0f;
+  const double tickSeconds = 1.0 / 60.0;
+  const float span = 4.0f; // Delays are 0.5 s to 4.5 s
+  int ticks = (int)(seconds * 60.0f);
+  int waveTicks = 5 * 60;
+
+  TimerWheel wheel(1000, count);
+  Signal wave;
+  SequenceRunner runner(wheel);
+
+  // 1. Start
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < count; ++i) {
+    runner.Start(Wanderer(runner, wave, i, span));
+  }
+  double startSeconds = Seconds(start);
+  size_t startReserved = runner.Pool().ReservedBytes();
+
+  // 2. Run
+  std::vector<double> tickTimes(ticks);
+  double runSeconds = 0.0;
+  for (int t = 0; t < ticks; ++t) {
+    start = Clock::now();
+    wheel.Advance((t + 1) * tickSeconds);
+    if ((t + 1) % waveTicks == 0)
+      wave.Raise();
+    tickTimes[t] = Seconds(start);
+    runSeconds += tickTimes[t];
+  }
+  long long runResumes = resumes;
+
+  // The same behaviour as polled flags
+  std::vector<PolledTask> polled(count);
+  for (int i = 0; i < count; ++i)
+    polled[i] = {0.5f + Random01() * span, false};
+  std::vector<double> pollTimes(ticks);
+  for (int t = 0; t < ticks; ++t) {
+    start = Clock::now();
+    bool waveNow = (t + 1) % waveTicks == 0;
+    for (int i = 0; i < count; ++i) {
+      PolledTask &task = polled[i];
+      if (task.waitingForWave) {
+        if (!waveNow)
+          continue;
+        task.waitingForWave = false;
+        task.remaining = 0.5f + Random01() * span;
+        continue;
+      }
+      task.remaining -= (float)tickSeconds;
+      if (task.remaining <= 0.0f) {
+        if (i % 4 == 0)
+          task.waitingForWave = true;
+        else
+          task.remaining = 0.5f + Random01() * span;
+      }
+    }
+    pollTimes[t] = Seconds(start);
+  }
+
+  // 3. Stop
+  int running = runner.Count();
+  start = Clock::now();
+  runner.Clear();
+  double stopSeconds = Seconds(start);
+
+  // 4. Park
+  Signal never;
+  for (int i = 0; i < count; ++i) {
+    runner.Start(Parked(runner, never));
+  }
+  std::vector<double> idleTimes(ticks);
+  double idleBase = wheel.Now();
+  for (int t = 0; t < ticks; ++t) {
+    start = Clock::now();
+    wheel.Advance(idleBase + (t + 1) * tickSeconds);
+    idleTimes[t] = Seconds(start);
+  }
+  resumes = 0;
+  start = Clock::now();
+  never.Raise();
+  double raiseSeconds = Seconds(start);
+
+  const FramePool &pool = runner.Pool();
+  printf("%d sequences, %d ticks at 60 Hz\n", count, ticks);
+  printf("start      %6.1f ns/sequence (frame from the pool, run to first "
+         "wait)\n",
+         startSeconds * 1e9 / count);
+  PrintTicks("running", tickTimes);
+  printf("           %lld resumes (%.1f ns each), %d suspended\n",
+         runResumes, runResumes ? runSeconds * 1e9 / runResumes : 0.0,
+         running);
+  PrintTicks("polling", pollTimes);
+  PrintTicks("parked", idleTimes);
+  printf("raise      %6.1f ns/resume, %lld resumed\n",
+         resumes ? raiseSeconds * 1e9 / resumes : 0.0, resumes);
+  printf("stop       %6.1f ns/sequence\n", stopSeconds * 1e9 / running);
+  printf("pool       %lld frames, %lld from the heap, %.1f MiB reserved "
+         "(%.0f bytes per running sequence)\n",
+         pool.Allocations(), pool.HeapAllocations(),
+         pool.ReservedBytes() / (1024.0 * 1024.0),
+         (double)startReserved / count);
+  return 0;
+}
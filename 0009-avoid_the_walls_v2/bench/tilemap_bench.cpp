@@ -0,0 +1,251 @@
+// tilemap_bench.cpp
+//
+// Swept collision and memory in a 1,000,000 x 1,000 tile world (16 px
+// tiles) made on demand from a terrain function: rolling ground, caves
+// and floating platforms.
+//   scroll  - a 800x600 camera runs along the ground for 'frames'
+//             frames, 'queries' swept boxes per frame around it (boxes
+//             8-48 px, moves up to 64 px each way)
+//   random  - the same queries anywhere in the world: nearly every one
+//             loads a chunk
+// Each query is also answered by a tile-by-tile reference sweep (same
+// rules, one IsSolid per tile instead of the bitmasks) and the two must
+// agree.
+// Reported: queries per second for both, tiles tested per query, chunk
+// loads and evictions, and resident memory against the whole world.
+//
+// Usage: tilemap_bench [frames] [queries]
+
+#include "../tilemap.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sys/resource.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int worldWidth = 1000000;
+static const int worldHeight = 1000;
+static const float tileSize = 16.0f;
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static uint32_t Hash(uint32_t x, uint32_t y) {
+  uint32_t h = x * 0x9E3779B1u ^ y * 0x85EBCA77u;
+  h ^= h >> 15;
+  h *= 0x2C1B3C6Du;
+  h ^= h >> 12;
+  return h;
+}
+
+// Ground row of a column: two octaves of smoothed value noise
+static int GroundRow(int x) {
+  auto Octave = [](int x, int period, int amplitude) {
+    int cell = x / period;
+    float t = (float)(x % period) / period;
+    t = t * t * (3.0f - 2.0f * t);
+    float a = (float)(Hash(cell, 1) % 1000) / 1000.0f;
+    float b = (float)(Hash(cell + 1, 1) % 1000) / 1000.0f;
+    return (int)((a + (b - a) * t) * amplitude);
+  };
+  return 600 + Octave(x, 256, 240) + Octave(x, 24, 20);
+}
+
+static bool TerrainSolid(int x, int y) {
+  int ground = GroundRow(x);
+  if (y >= ground) {
+    // Caves: open pockets in 8x8 cells below the surface
+    bool cave = y > ground + 12 && Hash(x / 8, y / 8) % 5 == 0;
+    return !cave;
+  }
+  // Floating platforms: a 12-tile ledge in some 32x16 cells
+  int cellX = x / 32, cellY = y / 16;
+  uint32_t h = Hash(cellX, cellY + 7919);
+  return h % 3 == 0 && y % 16 == 0 && x % 32 < 12 && y < ground - 4;
+}
+
+static void MakeChunk(void *context, int chunkX, int chunkY, uint8_t *tiles) {
+  for (int y = 0; y < TileChunk::size; ++y) {
+    for (int x = 0; x < TileChunk::size; ++x) {
+      int worldX = chunkX * TileChunk::size + x;
+      int worldY = chunkY * TileChunk::size + y;
+      if (worldX < worldWidth && worldY < worldHeight)
+        tiles[y * TileChunk::size + x] = TerrainSolid(worldX, worldY);
+    }
+  }
+}
+
+// The reference: the same sweep, one IsSolid per tile
+static bool Blocked(TileMap &map, int x0, int x1, int y0, int y1,
+                    long long &tested) {
+  for (int y = y0; y <= y1; ++y) {
+    for (int x = x0; x <= x1; ++x) {
+      tested++;
+      if (map.IsSolid(x, y))
+        return true;
+    }
+  }
+  return false;
+}
+
+static TileSweep ReferenceSweep(TileMap &map, const WorldBox &box, double dx,
+                                double dy, long long &tested) {
+  const double e = 1e-7, s = tileSize;
+  TileSweep r = {box.x, box.y, false, false};
+  int top = (int)floor(box.y / s + e);
+  int bottom = (int)ceil((box.y + box.height) / s - e) - 1;
+  if (dx > 0.0) {
+    double right = box.x + box.width;
+    for (int x = (int)ceil(right / s - e);
+         x <= (int)ceil((right + dx) / s - e) - 1 && !r.hitX; ++x)
+      if (Blocked(map, x, x, top, bottom, tested)) {
+        r.hitX = true;
+        r.x += x * s - right;
+      }
+  } else if (dx < 0.0) {
+    for (int x = (int)floor(box.x / s + e) - 1;
+         x >= (int)floor((box.x + dx) / s + e) && !r.hitX; --x)
+      if (Blocked(map, x, x, top, bottom, tested)) {
+        r.hitX = true;
+        r.x += (x + 1) * s - box.x;
+      }
+  }
+  if (!r.hitX)
+    r.x += dx;
+  int left = (int)floor(r.x / s + e);
+  int right = (int)ceil((r.x + box.width) / s - e) - 1;
+  if (dy > 0.0) {
+    double bottomEdge = box.y + box.height;
+    for (int y = (int)ceil(bottomEdge / s - e);
+         y <= (int)ceil((bottomEdge + dy) / s - e) - 1 && !r.hitY; ++y)
+      if (Blocked(map, left, right, y, y, tested)) {
+        r.hitY = true;
+        r.y += y * s - bottomEdge;
+      }
+  } else if (dy < 0.0) {
+    for (int y = (int)floor(box.y / s + e) - 1;
+         y >= (int)floor((box.y + dy) / s + e) && !r.hitY; --y)
+      if (Blocked(map, left, right, y, y, tested)) {
+        r.hitY = true;
+        r.y += (y + 1) * s - box.y;
+      }
+  }
+  if (!r.hitY)
+    r.y += dy;
+  return r;
+}
+
+struct Query {
+  WorldBox box;
+  double dx, dy;
+};
+
+struct Result {
+  double seconds, referenceSeconds;
+  long long queries, tested, referenceTested, mismatches, hits;
+};
+
+// Random boxes in 'area' that start in the open
+static void MakeQueries(TileMap &map, std::mt19937 &rng, const WorldBox &area,
+                        int count, std::vector<Query> &queries) {
+  std::uniform_real_distribution<double> x(area.x, area.x + area.width);
+  std::uniform_real_distribution<double> y(area.y, area.y + area.height);
+  std::uniform_real_distribution<double> size(8.0, 48.0);
+  std::uniform_real_distribution<double> move(-64.0, 64.0);
+  queries.clear();
+  while ((int)queries.size() < count) {
+    Query q = {{x(rng), y(rng), size(rng), size(rng)}, move(rng), move(rng)};
+    if (!map.Overlaps(q.box))
+      queries.push_back(q);
+  }
+}
+
+static void RunQueries(TileMap &map, const std::vector<Query> &queries,
+                       Result &result) {
+  long long before = map.TilesTested();
+  std::vector<TileSweep> swept(queries.size());
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < queries.size(); ++i) {
+    swept[i] = map.Sweep(queries[i].box, queries[i].dx, queries[i].dy);
+  }
+  result.seconds += Seconds(start);
+  result.tested += map.TilesTested() - before;
+
+  start = Clock::now();
+  for (size_t i = 0; i < queries.size(); ++i) {
+    const Query &q = queries[i];
+    TileSweep r =
+        ReferenceSweep(map, q.box, q.dx, q.dy, result.referenceTested);
+    if (r.hitX != swept[i].hitX || r.hitY != swept[i].hitY ||
+        fabs(r.x - swept[i].x) > 1e-6 || fabs(r.y - swept[i].y) > 1e-6)
+      result.mismatches++;
+    result.hits += swept[i].hitX || swept[i].hitY;
+  }
+  result.referenceSeconds += Seconds(start);
+  result.queries += (long long)queries.size();
+}
+
+static void Print(const char *name, const Result &r, const TileMap &map) {
+  printf("%-7s %10.2f %10.2f %8.1f %8.1f %6.0f%% %9lld %9lld %5lld\n", name,
+         r.queries / r.seconds / 1e6, r.queries / r.referenceSeconds / 1e6,
+         (double)r.tested / r.queries, (double)r.referenceTested / r.queries,
+         r.hits * 100.0 / r.queries, map.Loads(), map.Evictions(),
+         r.mismatches);
+}
+
+int main(int argc, char **argv) {
+  int frames = argc > 1 ? atoi(argv[1]) : 20000;
+  int perFrame = argc > 2 ? atoi(argv[2]) : 500;
+
+  std::mt19937 rng(3u);
+  std::vector<Query> queries;
+  printf("%dx%d tiles of %.0f px, %d frames x %d queries\n", worldWidth,
+         worldHeight, tileSize, frames, perFrame);
+  printf("        Mquery/s   Mquery/s  tiles/q  tiles/q   hit     chunk"
+         "     chunk  mis-\n");
+  printf("         bitmask  per tile  bitmask per tile           loads"
+         " evictions match\n");
+
+  // Scrolling: the camera crosses the world (800 px a frame by default)
+  TileMap scroll(worldWidth, worldHeight, tileSize, MakeChunk, nullptr);
+  Result scrolled = {};
+  double step = (double)worldWidth * tileSize / frames;
+  for (int f = 0; f < frames; ++f) {
+    double cameraX = f * step;
+    int column = (int)(cameraX / tileSize) + 25;
+    WorldBox view = {cameraX, GroundRow(column) * tileSize - 400.0, 800.0,
+                     600.0};
+    scroll.Focus(view, 256.0);
+    MakeQueries(scroll, rng, view, perFrame, queries);
+    RunQueries(scroll, queries, scrolled);
+  }
+  Print("scroll", scrolled, scroll);
+
+  // Random: anywhere in the world
+  TileMap anywhere(worldWidth, worldHeight, tileSize, MakeChunk, nullptr);
+  Result random = {};
+  WorldBox world = {0.0, 0.0, worldWidth * (double)tileSize - 48.0,
+                    worldHeight * (double)tileSize - 48.0};
+  for (int f = 0; f < frames / 100; ++f) {
+    MakeQueries(anywhere, rng, world, perFrame, queries);
+    RunQueries(anywhere, queries, random);
+  }
+  Print("random", random, anywhere);
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  double whole = (double)worldWidth * worldHeight *
+                 (sizeof(TileChunk) / (double)(TileChunk::size *
+                                               TileChunk::size));
+  printf("resident: %d chunks, %.0f KiB (scroll map); %.0f KiB (random "
+         "map); peak RSS %ld KiB\n",
+         scroll.Resident(), scroll.ResidentBytes() / 1024.0,
+         anywhere.ResidentBytes() / 1024.0, usage.ru_maxrss);
+  printf("the whole world as chunks: %.0f MiB\n", whole / (1024 * 1024));
+  return scrolled.mismatches + random.mismatches ? 1 : 0;
+}
@@ -0,0 +1,125 @@
+// timer_bench.cpp
+//
+// TimerWheel with 1M outstanding timers against polling 1M countdown
+// floats every frame (how GameState handles its countdown by hand).
+//
+//   1. schedule 1M timers, delays spread over 60 s
+//   2. cancel a random quarter of them
+//   3. steady state: every expiry schedules a replacement, so 1M timers
+//      stay outstanding while the clock runs at 60 Hz for 60 s
+//
+// Usage: timer_bench [timers] [seconds]
+
+#include "../timer_wheel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static uint32_t rngState = 12345u;
+
+static float Random01() {
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return (rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Context {
+  TimerWheel *wheel;
+  float span; // Delay range for replacements (seconds)
+  long long fired;
+};
+
+static void Rearm(void *contextPtr, uint64_t data) {
+  Context *context = static_cast<Context *>(contextPtr);
+  context->fired++;
+  context->wheel->Schedule(Random01() * context->span, Rearm, context, data);
+}
+
+int main(int argc, char **argv) {
+  int count = argc > 1 ? atoi(argv[1]) : 1000000;
+  float seconds = argc > 2 ? (float)atof(argv[2]) : 60.0f;
+  const double tickSeconds = 1.0 / 60.0;
+  int ticks = (int)(seconds * 60.0f);
+
+  TimerWheel wheel(1000, count);
+  Context context = {&wheel, seconds, 0};
+  std::vector<TimerHandle> handles(count);
+
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < count; ++i) {
+    handles[i] = wheel.Schedule(Random01() * seconds, Rearm, &context, i);
+  }
+  double scheduleSeconds = Seconds(start);
+
+  std::vector<int> order(count);
+  for (int i = 0; i < count; ++i)
+    order[i] = i;
+  for (int i = count - 1; i > 0; --i)
+    std::swap(order[i], order[(int)(Random01() * (i + 1)) % (i + 1)]);
+  int cancels = count / 4;
+  start = Clock::now();
+  for (int i = 0; i < cancels; ++i) {
+    wheel.Cancel(handles[order[i]]);
+  }
+  double cancelSeconds = Seconds(start);
+  for (int i = 0; i < cancels; ++i) {
+    handles[order[i]] = wheel.Schedule(Random01() * seconds, Rearm, &context,
+                                       order[i]);
+  }
+
+  std::vector<double> tickTimes(ticks);
+  for (int t = 0; t < ticks; ++t) {
+    start = Clock::now();
+    wheel.Advance((t + 1) * tickSeconds);
+    tickTimes[t] = Seconds(start);
+  }
+
+  // Polling: one float per timer, decremented and tested every frame
+  std::vector<float> remaining(count);
+  for (int i = 0; i < count; ++i)
+    remaining[i] = Random01() * seconds;
+  long long polledFired = 0;
+  std::vector<double> pollTimes(ticks);
+  for (int t = 0; t < ticks; ++t) {
+    start = Clock::now();
+    for (int i = 0; i < count; ++i) {
+      remaining[i] -= (float)tickSeconds;
+      if (remaining[i] <= 0.0f) {
+        remaining[i] = Random01() * seconds; // Same rearm as the wheel
+        polledFired++;
+      }
+    }
+    pollTimes[t] = Seconds(start);
+  }
+
+  double wheelTotal = 0.0, pollTotal = 0.0;
+  for (int t = 0; t < ticks; ++t) {
+    wheelTotal += tickTimes[t];
+    pollTotal += pollTimes[t];
+  }
+  std::sort(tickTimes.begin(), tickTimes.end());
+  std::sort(pollTimes.begin(), pollTimes.end());
+
+  printf("%d timers, %d ticks at 60 Hz\n", count, ticks);
+  printf("schedule   %6.1f ns/timer\n", scheduleSeconds * 1e9 / count);
+  printf("cancel     %6.1f ns/timer\n", cancelSeconds * 1e9 / cancels);
+  printf("wheel      %8.3f ms/tick mean, p99 %.3f ms, %lld fired "
+         "(%.1f ns each),\n           %d outstanding\n",
+         wheelTotal * 1e3 / ticks, tickTimes[ticks * 99 / 100] * 1e3,
+         context.fired,
+         context.fired ? wheelTotal * 1e9 / context.fired : 0.0,
+         wheel.Count());
+  printf("polling    %8.3f ms/tick mean, p99 %.3f ms, %lld fired\n",
+         pollTotal * 1e3 / ticks, pollTimes[ticks * 99 / 100] * 1e3,
+         polledFired);
+  return 0;
+}
@@ -0,0 +1,126 @@
+// trace_bench.cpp
+//
+// What a Trace() call costs on the game thread, with the log closed and
+// with it open and flushing to a file.
+//
+//   1. Trace() with the log closed (one relaxed load)
+//   2. Trace() into an open log, in bursts of 'burst' events with a
+//      short pause between them so the flush thread keeps up (a 60 Hz
+//      game writes a few events a frame, far fewer than this)
+//   3. back to back with no pause, to show where the rings overflow
+//   4. a headless Game stepped at 60 Hz, untraced and traced
+// then reads the file back and checks every written record is there.
+//
+// Usage: trace_bench [events] [burst] [frames]
+
+#include "../game.h"
+#include "../trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double Median(std::vector<double> values) {
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+// ns per event over 'count' events, as the game would write them
+static double TraceEvents(int count, uint64_t &tick) {
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < count; ++i, ++tick) {
+    Trace(TraceStep, tick, 400.0f + (float)(i & 63), 300.0f, 220.0f, i & 3,
+          (unsigned)i);
+  }
+  return Seconds(start) * 1e9 / count;
+}
+
+// ns per Step, restarting after every game over
+static double StepFrames(Game &game, ScriptedInput &input, int frames) {
+  const float dt = 1.0f / 60.0f;
+  Clock::time_point start = Clock::now();
+  for (int f = 0; f < frames; ++f) {
+    if (game.gameState.gameOver)
+      input.Press(KEY_R);
+    else if (f % 45 == 0)
+      input.Press(f % 90 ? KEY_LEFT : KEY_UP);
+    game.Step(dt);
+    input.Clear();
+  }
+  return Seconds(start) * 1e9 / frames;
+}
+
+int main(int argc, char **argv) {
+  int events = argc > 1 ? atoi(argv[1]) : 2000000;
+  int burst = argc > 2 ? atoi(argv[2]) : 4096;
+  int frames = argc > 3 ? atoi(argv[3]) : 200000;
+  const double budgetNs = 20.0;
+  std::string path =
+      "/tmp/trace_bench_" + std::to_string((long long)getpid()) + ".bin";
+  TraceFile &log = GameTrace();
+  uint64_t tick = 0;
+
+  // 1. Closed
+  double closedNs = TraceEvents(events, tick);
+
+  // 2. Open, paced bursts
+  if (!log.Open(path.c_str())) {
+    printf("trace_bench: can't write %s\n", path.c_str());
+    return 1;
+  }
+  TraceEvents(burst, tick); // Takes this thread's ring
+  std::vector<double> bursts;
+  for (int done = 0; done < events; done += burst) {
+    std::this_thread::sleep_for(
+        std::chrono::milliseconds(TraceFile::flushMs * 2));
+    bursts.push_back(TraceEvents(burst, tick));
+  }
+  long long pacedDropped = log.Dropped();
+
+  // 3. Open, back to back
+  double floodNs = TraceEvents(events, tick);
+  long long floodDropped = log.Dropped() - pacedDropped;
+
+  // 4. The game, untraced then traced (the log is still open)
+  ScriptedInput input;
+  Game game(input, 12345u);
+  traceEnabled.store(false);
+  double stepPlainNs = StepFrames(game, input, frames);
+  traceEnabled.store(true);
+  double stepTracedNs = StepFrames(game, input, frames);
+
+  log.Close();
+  long long written = log.Written();
+  struct stat info;
+  long long onDisk = stat(path.c_str(), &info) == 0
+                         ? (long long)((info.st_size - sizeof(TraceFileHeader)) /
+                                       sizeof(TraceRecord))
+                         : -1;
+  unlink(path.c_str());
+
+  double burstNs = Median(bursts);
+  printf("%d events, bursts of %d, %d frames\n", events, burst, frames);
+  printf("log closed           %6.2f ns/event\n", closedNs);
+  printf("log open, paced      %6.2f ns/event (budget %.0f ns: %s)\n",
+         burstNs, budgetNs, burstNs < budgetNs ? "ok" : "OVER");
+  printf("log open, flooded    %6.2f ns/event, %lld of %d dropped\n", floodNs,
+         floodDropped, events);
+  printf("step untraced        %6.1f ns/frame\n", stepPlainNs);
+  printf("step traced          %6.1f ns/frame (%+.1f ns)\n", stepTracedNs,
+         stepTracedNs - stepPlainNs);
+  printf("records              %lld written, %lld in the file, %lld dropped "
+         "while paced\n",
+         written, onDisk, pacedDropped);
+  return written == onDisk ? 0 : 1;
+}
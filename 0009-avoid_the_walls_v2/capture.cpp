@@ -0,0 +1,329 @@
+// capture.cpp
+
+#include "capture.h"
+#include "rlgl.h"
+#include <algorithm>
+#include <cstring>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifndef PLATFORM_WEB
+#define GL_GLEXT_PROTOTYPES
+#include <GL/gl.h>
+#include <GL/glext.h>
+#endif
+
+// Full range BT.601 (Y4M's C420jpeg), 16.16 fixed point
+static inline uint8_t LumaOf(const uint8_t *p) {
+  return (uint8_t)((19595 * p[0] + 38470 * p[1] + 7471 * p[2] + 32768) >> 16);
+}
+
+// ----------- FrameCapture -----------
+
+FrameCapture::FrameCapture()
+    : open(false), file(nullptr), pattern(), width(0), height(0), slots(),
+      writeIndex(0), readIndex(0), filled(0), stopping(false), encoded(),
+      lastWritten(-1), pbos{}, pboFrame{}, pboNext(0), pboReady(false),
+      frames(0), written(0), dropped(0), repeated(0), captureSeconds(0.0),
+      maxCapture(0.0), writeSeconds(0.0) {}
+
+FrameCapture::~FrameCapture() { Close(); }
+
+bool FrameCapture::Open(const char *path, int w, int h, int fps,
+                        int ringFrames) {
+#ifdef PLATFORM_WEB
+  (void)path, (void)w, (void)h, (void)fps, (void)ringFrames;
+  return false; // No threads for the writer
+#else
+  Close();
+  size_t length = strlen(path);
+  bool y4m = length >= 4 && strcmp(path + length - 4, ".y4m") == 0;
+  if (y4m) {
+    file = fopen(path, "wb");
+    if (!file)
+      return false;
+    // 'Ip': progressive, 'A1:1': square pixels
+    fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", w, h, fps);
+  } else {
+    pattern = path;
+  }
+  width = w;
+  height = h;
+
+  // Touch every page now, not on the first captured frame
+  slots.resize(std::max(ringFrames, 1));
+  for (Slot &slot : slots) {
+    slot.rgba.assign((size_t)w * h * 4, 0);
+    slot.bottomUp = false;
+    slot.frame = 0;
+  }
+  int chromaW = (w + 1) / 2, chromaH = (h + 1) / 2;
+  encoded.assign(y4m ? (size_t)w * h + 2 * (size_t)chromaW * chromaH
+                     : (size_t)w * h * 3,
+                 0);
+  writeIndex = readIndex = filled = 0;
+  lastWritten = -1;
+  for (long long &frame : pboFrame) {
+    frame = -1;
+  }
+  pboNext = 0;
+  frames = dropped = 0;
+  written = repeated = 0;
+  captureSeconds = maxCapture = writeSeconds = 0.0;
+
+  stopping = false;
+  open = true;
+  thread = std::thread(&FrameCapture::Write, this);
+#ifdef __linux__
+  // Only when a core is idle: waking the writer must not preempt the
+  // game loop, and a game that keeps every core busy drops frames
+  // rather than slowing down
+  sched_param param = {};
+  pthread_setschedparam(thread.native_handle(), SCHED_IDLE, &param);
+#endif
+  return true;
+#endif
+}
+
+void FrameCapture::Close() {
+  if (!open)
+    return;
+#ifndef PLATFORM_WEB
+  if (pboReady) {
+    // The last readbacks, oldest first; without a context they are gone
+    for (int i = 0; i < readbackDepth; ++i) {
+      int pbo = (pboNext + i) % readbackDepth;
+      if (pboFrame[pbo] < 0)
+        continue;
+      if (IsWindowReady())
+        Collect(pbo);
+      else
+        dropped++;
+      pboFrame[pbo] = -1;
+    }
+    if (IsWindowReady())
+      glDeleteBuffers(readbackDepth, pbos);
+    pboReady = false;
+  }
+#endif
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+  thread.join(); // It writes everything queued first
+  RepeatUntil(frames); // Drops at the very end too
+  if (file) {
+    fclose(file);
+    file = nullptr;
+  }
+  pattern.clear();
+  open = false;
+}
+
+void FrameCapture::Submit(const Color *pixels, int w, int h) {
+  if (!open)
+    return;
+  Clock::time_point start = Clock::now();
+  long long frame = frames++;
+  if (w != width || h != height)
+    dropped++;
+  else
+    Push((const uint8_t *)pixels, false, frame);
+  Timed(start);
+}
+
+void FrameCapture::ReadFramebuffer() {
+#ifndef PLATFORM_WEB
+  if (!open)
+    return;
+  Clock::time_point start = Clock::now();
+  long long frame = frames++;
+  if (GetScreenWidth() != width || GetScreenHeight() != height) {
+    dropped++;
+    Timed(start);
+    return;
+  }
+  rlDrawRenderBatchActive(); // Everything drawn so far reaches the GPU
+  if (!pboReady) {
+    glGenBuffers(readbackDepth, pbos);
+    for (unsigned int pbo : pbos) {
+      glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+      glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 4,
+                   nullptr, GL_STREAM_READ);
+    }
+    pboReady = true;
+  }
+  // The buffer about to be reused holds the frame from readbackDepth
+  // frames ago: finished by now, so mapping it doesn't wait on the GPU
+  int pbo = pboNext;
+  if (pboFrame[pbo] >= 0)
+    Collect(pbo);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[pbo]);
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  pboFrame[pbo] = frame;
+  pboNext = (pboNext + 1) % readbackDepth;
+  Timed(start);
+#endif
+}
+
+void FrameCapture::Collect(int pbo) {
+#ifndef PLATFORM_WEB
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[pbo]);
+  const uint8_t *mapped =
+      (const uint8_t *)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+  if (mapped) {
+    Push(mapped, true, pboFrame[pbo]);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  } else {
+    dropped++;
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+}
+
+void FrameCapture::Push(const uint8_t *rgba, bool bottomUp, long long frame) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (filled == (int)slots.size()) {
+      dropped++; // The writer is behind: keep the game running instead
+      return;
+    }
+  }
+  // The writer never touches a slot until it is counted in 'filled'
+  Slot &slot = slots[writeIndex];
+  memcpy(slot.rgba.data(), rgba, slot.rgba.size());
+  slot.bottomUp = bottomUp;
+  slot.frame = frame;
+  writeIndex = (writeIndex + 1) % (int)slots.size();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    filled++;
+  }
+  wake.notify_one();
+}
+
+void FrameCapture::Timed(Clock::time_point start) {
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  captureSeconds += seconds;
+  maxCapture = std::max(maxCapture, seconds);
+}
+
+double FrameCapture::MeanCaptureMicroseconds() const {
+  return frames > 0 ? captureSeconds / frames * 1e6 : 0.0;
+}
+
+double FrameCapture::MeanWriteMicroseconds() const {
+  long long slotsWritten = written.load() - repeated.load();
+  return slotsWritten > 0 ? writeSeconds / slotsWritten * 1e6 : 0.0;
+}
+
+void FrameCapture::Write() {
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [this]() { return stopping || filled > 0; });
+      if (filled == 0)
+        return; // Stopping, and nothing left
+    }
+    const Slot &slot = slots[readIndex];
+    Clock::time_point start = Clock::now();
+    if (file)
+      WriteY4m(slot);
+    else
+      WritePpm(slot);
+    writeSeconds +=
+        std::chrono::duration<double>(Clock::now() - start).count();
+    lastWritten = slot.frame;
+    readIndex = (readIndex + 1) % (int)slots.size();
+    std::lock_guard<std::mutex> lock(mutex);
+    filled--;
+  }
+}
+
+void FrameCapture::RepeatUntil(long long frame) {
+  // Y4M has no timestamps: a dropped frame is filled with the one before
+  // it ('encoded' still holds it), so the clip runs at the game's pace
+  if (!file || lastWritten < 0)
+    return;
+  for (long long gap = lastWritten + 1; gap < frame; ++gap) {
+    fputs("FRAME\n", file);
+    fwrite(encoded.data(), 1, encoded.size(), file);
+    written++;
+    repeated++;
+  }
+  lastWritten = std::max(lastWritten, frame - 1);
+}
+
+void FrameCapture::WriteY4m(const Slot &slot) {
+  RepeatUntil(slot.frame);
+
+  int chromaW = (width + 1) / 2, chromaH = (height + 1) / 2;
+  uint8_t *lumaPlane = encoded.data();
+  uint8_t *cbPlane = lumaPlane + (size_t)width * height;
+  uint8_t *crPlane = cbPlane + (size_t)chromaW * chromaH;
+  size_t stride = (size_t)width * 4;
+  auto Row = [&](int y) {
+    return slot.rgba.data() + (slot.bottomUp ? height - 1 - y : y) * stride;
+  };
+  for (int cy = 0; cy < chromaH; ++cy) {
+    int y0 = cy * 2, y1 = std::min(y0 + 1, height - 1);
+    const uint8_t *top = Row(y0), *bottom = Row(y1);
+    uint8_t *lumaTop = lumaPlane + (size_t)y0 * width;
+    uint8_t *lumaBottom = lumaPlane + (size_t)y1 * width;
+    for (int cx = 0; cx < chromaW; ++cx) {
+      int x0 = cx * 2, x1 = std::min(x0 + 1, width - 1);
+      const uint8_t *p[4] = {top + x0 * 4, top + x1 * 4, bottom + x0 * 4,
+                             bottom + x1 * 4};
+      lumaTop[x0] = LumaOf(p[0]);
+      lumaTop[x1] = LumaOf(p[1]);
+      lumaBottom[x0] = LumaOf(p[2]);
+      lumaBottom[x1] = LumaOf(p[3]);
+      // Chroma of the 2x2 block's average: sums of four, so >> 18
+      int r = p[0][0] + p[1][0] + p[2][0] + p[3][0];
+      int g = p[0][1] + p[1][1] + p[2][1] + p[3][1];
+      int b = p[0][2] + p[1][2] + p[2][2] + p[3][2];
+      int half = 1 << 17;
+      cbPlane[(size_t)cy * chromaW + cx] = (uint8_t)std::clamp(
+          (-11059 * r - 21709 * g + 32768 * b + (128 << 18) + half) >> 18, 0,
+          255);
+      crPlane[(size_t)cy * chromaW + cx] = (uint8_t)std::clamp(
+          (32768 * r - 27439 * g - 5329 * b + (128 << 18) + half) >> 18, 0,
+          255);
+    }
+  }
+  fputs("FRAME\n", file);
+  fwrite(encoded.data(), 1, encoded.size(), file);
+  written++;
+}
+
+void FrameCapture::WritePpm(const Slot &slot) {
+  // Numbered by frame, so a drop shows as a missing number
+  char name[512];
+  snprintf(name, sizeof(name), pattern.c_str(), (int)slot.frame);
+  FILE *out = fopen(name, "wb");
+  if (!out)
+    return;
+  uint8_t *rgb = encoded.data();
+  for (int y = 0; y < height; ++y) {
+    const uint8_t *row =
+        slot.rgba.data() +
+        (size_t)(slot.bottomUp ? height - 1 - y : y) * width * 4;
+    for (int x = 0; x < width; ++x) {
+      rgb[0] = row[0];
+      rgb[1] = row[1];
+      rgb[2] = row[2];
+      rgb += 3;
+      row += 4;
+    }
+  }
+  fprintf(out, "P6\n%d %d\n255\n", width, height);
+  fwrite(encoded.data(), 1, encoded.size(), out);
+  fclose(out);
+  written++;
+}
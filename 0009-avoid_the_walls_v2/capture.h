@@ -0,0 +1,123 @@
+// capture.h
+
+#pragma once
+
+#include "raylib.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ----------- FrameCapture -----------
+// Manages: recording the frames the Renderer draws to disk without
+// stalling the game loop
+// Should Own:
+//   - A ring of frame buffers allocated (and touched) when capture opens,
+//     so capturing a frame never allocates or faults in a page
+//   - Reading frames back: from the software rasterizer, a copy; under
+//     OpenGL, glReadPixels into a pixel buffer object that is mapped
+//     readbackDepth frames later, when the GPU has long finished it
+//   - A writer thread that encodes and writes what the ring holds
+//   - Dropped frame accounting: a frame that finds the ring full is
+//     dropped and counted, and the Y4M stream repeats the frame before
+//     it, so the clip keeps real time
+// Should Not:
+//   - Decide what to draw or when a frame begins and ends (the Renderer)
+//   - Make the game loop wait for the disk
+class FrameCapture {
+public:
+  static const int defaultRingFrames = 8; // 15 MB at 800x600
+  static const int readbackDepth = 3;     // Pixel buffer objects in flight
+
+  FrameCapture();
+  ~FrameCapture(); // Closes
+  FrameCapture(const FrameCapture &) = delete;
+  FrameCapture &operator=(const FrameCapture &) = delete;
+
+  // A path ending in ".y4m" is one YUV4MPEG2 stream (4:2:0, full range
+  // BT.601, 'fps' frames per second); anything else is a printf pattern
+  // with one %d for the frame number, one binary PPM per frame. False if
+  // the file can't be created or the platform has no threads (web).
+  bool Open(const char *path, int width, int height, int fps,
+            int ringFrames = defaultRingFrames);
+  // Writes the frames still queued. Call it on the render thread while
+  // the window is open to keep the last readbackDepth - 1 GL frames;
+  // after CloseWindow they are dropped.
+  void Close();
+  bool IsOpen() const { return open; }
+
+  // One software frame, top row first (SoftwareRasterizer::Pixels)
+  void Submit(const Color *pixels, int width, int height);
+  // One OpenGL frame: flushes raylib's batch and starts reading the
+  // back buffer. Call it after the frame's draws, before EndDrawing.
+  void ReadFramebuffer();
+
+  // Frames offered; written (repeats included); dropped (ring full, or
+  // the wrong size); Y4M repeats written in place of dropped frames
+  long long Frames() const { return frames; }
+  long long Written() const { return written.load(); }
+  long long Dropped() const { return dropped; }
+  long long Repeated() const { return repeated.load(); }
+  // Render thread time per frame, microseconds
+  double MeanCaptureMicroseconds() const;
+  double MaxCaptureMicroseconds() const { return maxCapture * 1e6; }
+  // Writer thread time per frame (convert and write), microseconds;
+  // read it after Close
+  double MeanWriteMicroseconds() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Slot {
+    std::vector<uint8_t> rgba;
+    bool bottomUp;   // GL rows come bottom row first
+    long long frame; // Its number among the frames offered
+  };
+
+  bool open;
+  FILE *file;          // The Y4M stream
+  std::string pattern; // PPM file names, when not a stream
+  int width;
+  int height;
+
+  std::vector<Slot> slots;
+  int writeIndex; // Render thread only
+  int readIndex;  // Writer thread only
+  int filled;     // Under 'mutex'
+  std::mutex mutex;
+  std::condition_variable wake;
+  bool stopping;
+  std::thread thread;
+
+  // Writer thread buffers
+  std::vector<uint8_t> encoded;
+  long long lastWritten;
+
+  // Readback
+  unsigned int pbos[readbackDepth];
+  long long pboFrame[readbackDepth]; // -1: empty
+  int pboNext;
+  bool pboReady;
+
+  long long frames;
+  std::atomic<long long> written;
+  long long dropped;
+  std::atomic<long long> repeated;
+  double captureSeconds;
+  double maxCapture;
+  double writeSeconds;
+
+  // Copies one frame into the ring, or counts it dropped
+  void Push(const uint8_t *rgba, bool bottomUp, long long frame);
+  void Collect(int pbo); // Maps a finished readback and pushes it
+  void Timed(Clock::time_point start);
+  void Write();
+  void RepeatUntil(long long frame); // Y4M: fills drops before 'frame'
+  void WriteY4m(const Slot &slot);
+  void WritePpm(const Slot &slot);
+};
@@ -5,4 +5,33 @@
 constexpr const char *gameTitle = "Avoid the Walls V2";
 
 const int screenWidth = 800;
-const int screenHeight = 600;
\ No newline at end of file
+const int screenHeight = 600;
+
+// Tuning values shared by the game and the batch playtest simulator
+const float playerSize = 50.0f;        // Player square side (px)
+const float playerStartSpeed = 200.0f; // px/sec after a reset
+const float speedPerTurn = 20.0f;      // px/sec added on every turn
+const float countdownSeconds = 3.0f;   // Countdown before each run
+
+// Input timing
+const double maxFrameGap = 0.25;       // Longer frames restart the sim clock
+const double inputPollSeconds = 0.001; // Desktop input polls between frames
+
+// Game timer resolution: 16 ticks per 60 Hz frame, so a fixed-step game's
+// timers always fire on the same frame however its clock was started
+const int timerTicksPerSecond = 960;
+
+// Pre-decoded assets (see pack/); loose files are the fallback
+constexpr const char *assetPackPath = "assets.pak";
+
+// Live metrics: set to "unix:/path" or "tcp:port" to serve them (see
+// metrics/ for the client); unset, no server thread is started
+constexpr const char *metricsEndpointVariable = "AVOID_THE_WALLS_METRICS";
+
+// Gameplay trace: set to a file path to record one (see trace/ for the
+// decoder); unset, Trace() returns after a single load
+constexpr const char *traceFileVariable = "AVOID_THE_WALLS_TRACE";
+
+// Frame capture: set to "clip.y4m" for a Y4M stream, or a pattern like
+// "frame_%05d.ppm" for one PPM per frame; unset, nothing is read back
+constexpr const char *captureFileVariable = "AVOID_THE_WALLS_CAPTURE";
@@ -8,18 +8,36 @@
 void RunPlatformLoop(void (*MainLoop)(void *gamePtr), void *gamePtr) {
   InitWindow(screenWidth, screenHeight, gameTitle);
   SetExitKey(0); // Disable default ESC behavior
-  SetTargetFPS(60);
 
-  while (!WindowShouldClose()) {
+  // No SetTargetFPS: rather than letting EndDrawing sleep out the rest of
+  // the frame, the loop waits in short steps and polls input in between,
+  // so key presses are timestamped to within inputPollSeconds
+  const double framePeriod = 1.0 / 60.0;
+  double nextFrame = GetTime();
+
+  Game *game = reinterpret_cast<Game *>(gamePtr);
 
-    Game *game = reinterpret_cast<Game *>(gamePtr);
+  while (!WindowShouldClose()) {
 
     if (game->gameState.shutdownRequested) {
       break;
     }
 
     MainLoop(game);
+    game->CaptureInput(GetTime()); // Presses polled by EndDrawing
+
+    nextFrame += framePeriod;
+    if (GetTime() > nextFrame) {
+      nextFrame = GetTime(); // Running late: don't try to catch up
+    }
+    while (GetTime() < nextFrame) {
+      WaitTime(inputPollSeconds);
+      PollInputEvents();
+      game->CaptureInput(GetTime());
+    }
   }
 
+  // The Game outlives the window: its GPU resources go while it's open
+  game->renderer.UnloadLayers();
   CloseWindow();
 }
@@ -1,92 +1,230 @@
 // game.cpp
 
 #include "game.h"
+#include "asset_pack.h"
+#include "constants.h"
 #include "entity.h"
 #include "raylib.h"
-#include <cmath>  // Include for ceilf usage
-#include <cstdio> // Include for snprintf usage
+#include <algorithm> // Include for std::min usage
+#include <cmath>     // Include for ceilf usage
+#include <cstdio>    // Include for snprintf usage
+#include <cstdlib>   // Include for std::rand usage
 
 // ----------- GameState -----------
 
 GameState::GameState()
     : gameOver(false), shutdownRequested(false), resetRequested(false),
-      elapsedTime(0.0f), countdownActive(true), countdownTime(3.0f) {}
+      elapsedTime(0.0f), countdownActive(true),
+      countdownTime(countdownSeconds) {}
 
-// ----------- InputHandler -----------
+// ----------- InputEventQueue -----------
 
-InputHandler::InputHandler() {}
+InputEventQueue::InputEventQueue() : events{}, head(0), tail(0), dropped(0) {}
 
-void InputHandler::HandleInput(GameState &state, EntityManager &entities) {
-  Vector2 direction = entities.player.moveDir;
-  if (IsKeyPressed(KEY_W) || IsKeyPressed(KEY_UP)) {
-    direction = {0, -1};
-  } else if (IsKeyPressed(KEY_S) || IsKeyPressed(KEY_DOWN)) {
-    direction = {0, 1};
-  } else if (IsKeyPressed(KEY_A) || IsKeyPressed(KEY_LEFT)) {
-    direction = {-1, 0};
-  } else if (IsKeyPressed(KEY_D) || IsKeyPressed(KEY_RIGHT)) {
-    direction = {1, 0};
+void InputEventQueue::Push(int key, double time) {
+  if (head - tail == (uint32_t)capacity) {
+    dropped++; // Full: keep the older presses, they happened first
+    return;
   }
-  entities.SetPlayerMoveDirection(direction);
+  events[head % capacity] = {key, time};
+  head++;
+}
 
-  if (IsKeyPressed(KEY_Q)) {
-    state.shutdownRequested = true;
+bool InputEventQueue::Pop(double until, InputEvent &event) {
+  if (head == tail || events[tail % capacity].time > until)
+    return false;
+  event = events[tail % capacity];
+  tail++;
+  return true;
+}
+
+// ----------- KeyboardInput -----------
+
+void KeyboardInput::Poll(InputEventQueue &queue, double now) {
+  // raylib queues every press since its last PollInputEvents, in order
+  for (int key = GetKeyPressed(); key != 0; key = GetKeyPressed()) {
+    queue.Push(key, now);
+  }
+}
+
+// ----------- ScriptedInput -----------
+
+ScriptedInput::ScriptedInput() : pressed{}, count(0), polled(0) {}
+
+void ScriptedInput::Press(int key) { Press(key, -1.0); }
+
+void ScriptedInput::Press(int key, double time) {
+  if (count < 16) {
+    pressed[count++] = {key, time};
+  }
+}
+
+void ScriptedInput::Clear() {
+  count = 0;
+  polled = 0;
+}
+
+bool ScriptedInput::IsKeyPressed(int key) const {
+  for (int i = 0; i < count; ++i) {
+    if (pressed[i].key == key)
+      return true;
+  }
+  return false;
+}
+
+void ScriptedInput::Poll(InputEventQueue &queue, double now) {
+  for (; polled < count; ++polled) {
+    const InputEvent &event = pressed[polled];
+    queue.Push(event.key, event.time < 0.0 ? now : event.time);
+  }
+}
+
+// ----------- InputStats -----------
+
+void InputStats::Record(double latency) {
+  applied++;
+  totalLatency += latency;
+  if (latency > maxLatency)
+    maxLatency = latency;
+  int bin = (int)(latency * 2000.0);
+  histogram[bin < 99 ? bin : 99]++;
+}
+
+double InputStats::Percentile(float p) const {
+  long long wanted = (long long)(p * applied);
+  long long seen = 0;
+  for (int bin = 0; bin < 100; ++bin) {
+    seen += histogram[bin];
+    if (seen > wanted)
+      return bin < 99 ? (bin + 1) * 0.0005 : maxLatency;
   }
-  if (IsKeyPressed(KEY_R)) {
+  return maxLatency;
+}
+
+// ----------- InputHandler -----------
+
+InputHandler::InputHandler(InputSource &source) : source(&source) {}
+
+void InputHandler::Capture(double now) { source->Poll(queue, now); }
+
+bool InputHandler::NextEvent(double until, InputEvent &event) {
+  return queue.Pop(until, event);
+}
+
+void InputHandler::Apply(const InputEvent &event, double simTime,
+                         GameState &state, EntityManager &entities) {
+  switch (event.key) {
+  case KEY_W:
+  case KEY_UP:
+    entities.SetPlayerMoveDirection({0, -1});
+    break;
+  case KEY_S:
+  case KEY_DOWN:
+    entities.SetPlayerMoveDirection({0, 1});
+    break;
+  case KEY_A:
+  case KEY_LEFT:
+    entities.SetPlayerMoveDirection({-1, 0});
+    break;
+  case KEY_D:
+  case KEY_RIGHT:
+    entities.SetPlayerMoveDirection({1, 0});
+    break;
+  case KEY_Q:
+    state.shutdownRequested = true;
+    break;
+  case KEY_R:
     state.resetRequested = true;
+    break;
+  default:
+    return; // Not a game key, not counted
   }
-};
+  stats.Record(simTime > event.time ? simTime - event.time : 0.0);
+}
 
 // ----------- AudioManager -----------
 
-AudioManager::AudioManager() {
-  InitAudioDevice();             // Initialize audio device
-  sound = LoadSound("beep.wav"); // Load a beep sound
+AudioManager::AudioManager(bool enabled) : enabled(enabled), sound{} {
+  if (!enabled)
+    return;
+  InitAudioDevice(); // Initialize audio device
+
+  // The pack holds the beep already decoded; LoadSoundFromWave copies it
+  // into the audio buffer, so the pack can close again right away
+  AssetPack pack;
+  Wave wave;
+  if (pack.Open(assetPackPath) && pack.GetWave("beep.wav", wave)) {
+    sound = LoadSoundFromWave(wave);
+  } else {
+    sound = LoadSound("beep.wav"); // Load a beep sound
+  }
 }
 
 void AudioManager::PlayBeep() {
-  PlaySound(sound); // Load and play a beep sound
+  if (enabled)
+    PlaySound(sound); // Load and play a beep sound
 }
 
 AudioManager::~AudioManager() {
+  if (!enabled)
+    return;
   UnloadSound(sound); // Unload the sound
   CloseAudioDevice(); // Close the audio device
 }
 
 // ----------- PhysicsEngine -----------
 
-PhysicsEngine::PhysicsEngine() {}
+PhysicsEngine::PhysicsEngine() : tileMap(nullptr), hitWall(4) {}
 
 void PhysicsEngine::Update(GameState &state, EntityManager &entities,
                            float deltaTime) {
   // Move the player continuously in its current direction
   // and check for collision with the screen edges
   Player &player = entities.player;
+  float dx = player.moveDir.x * player.speed * deltaTime;
+  float dy = player.moveDir.y * player.speed * deltaTime;
+
+  if (tileMap) {
+    // Stopped by the first solid tile on the way; outside the map is
+    // solid, so the map's edges are walls too
+    WorldBox box = {player.position.x, player.position.y,
+                    player.bounds.width, player.bounds.height};
+    TileSweep moved = tileMap->Sweep(box, dx, dy);
+    player.position = {(float)moved.x, (float)moved.y};
+    player.bounds.x = player.position.x;
+    player.bounds.y = player.position.y;
+    hitWall = TraceWall(moved.hitX, moved.hitY, dx, dy);
+    if (moved.hitX || moved.hitY)
+      state.gameOver = true;
+    return;
+  }
 
   // Move player
-  player.position.x += player.moveDir.x * player.speed * deltaTime;
-  player.position.y += player.moveDir.y * player.speed * deltaTime;
+  player.position.x += dx;
+  player.position.y += dy;
   player.bounds.x = player.position.x;
   player.bounds.y = player.position.y;
 
-  // Get screen size (from raylib)
-  int screenW = GetScreenWidth();
-  int screenH = GetScreenHeight();
-
-  // Check for collision with screen edges
-  if (player.position.x < 0 ||
-      player.position.x + player.bounds.width > screenW ||
-      player.position.y < 0 ||
-      player.position.y + player.bounds.height > screenH) {
+  // Check for collision with screen edges (the window is fixed at the
+  // constants.h size, so headless games need no window to ask)
+  bool hitX = player.position.x < 0 ||
+              player.position.x + player.bounds.width > screenWidth;
+  bool hitY = player.position.y < 0 ||
+              player.position.y + player.bounds.height > screenHeight;
+  hitWall = TraceWall(hitX, hitY, dx, dy);
+  if (hitX || hitY) {
     state.gameOver = true; // Game over if player hits the edge
   }
 }
 
 // ----------- EntityManager -----------
 
-EntityManager::EntityManager()
-    : player(100, 100, 50, 50, 200.0f) // Initialize member player
-{}
+EntityManager::EntityManager(uint32_t seed)
+    : player(100, 100, playerSize, playerSize,
+             playerStartSpeed), // Initialize member player
+      rngState(seed ? seed : 1) {
+  ResetPlayer(); // Start centered; needs no window, see ResetPlayer
+}
 
 void EntityManager::Update(GameState &state, float deltaTime) {
   player.Update(deltaTime);
@@ -94,18 +232,19 @@ void EntityManager::Update(GameState &state, float deltaTime) {
 
 void EntityManager::SetPlayerMoveDirection(Vector2 direction) {
   if (direction.x != player.moveDir.x || direction.y != player.moveDir.y) {
-    player.speed += 20.0f; // Increase speed on every turn
+    player.speed += speedPerTurn; // Increase speed on every turn
   }
   player.moveDir = direction;
 }
 
 void EntityManager::ResetPlayer() {
-  int screenW = GetScreenWidth();
-  int screenH = GetScreenHeight();
-  player.position = {(float)screenW / 2 - player.bounds.width / 2,
-                     (float)screenH / 2 - player.bounds.height / 2};
+  player.position = {(float)screenWidth / 2 - player.bounds.width / 2,
+                     (float)screenHeight / 2 - player.bounds.height / 2};
   // Pick a random direction: 0=up, 1=down, 2=left, 3=right
-  int dir = GetRandomValue(0, 3);
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  int dir = rngState % 4;
   switch (dir) {
   case 0:
     player.moveDir = {0, -1};
@@ -120,85 +259,268 @@ void EntityManager::ResetPlayer() {
     player.moveDir = {1, 0};
     break;
   }
-  player.speed = 200.0f; // Reset speed to default
+  player.speed = playerStartSpeed; // Reset speed to default
   player.bounds.x = player.position.x;
   player.bounds.y = player.position.y;
 }
 
 // ----------- Renderer -----------
 
+// HUD panel, in screen pixels; the labels live in it, the values are
+// drawn over it every frame
+static const Rectangle hudPanel = {10, 10, 300, 52};
+static const int hudLabelSize = 10;
+static const int hudValueSize = 20;
+static const int hudSpeedX = 20;
+static const int hudTimeX = 170;
+static const float tileSize = 40.0f;
+static const float wallWidth = 4.0f;
+
 // Note to AI: Window is already initialized in platform loop
-Renderer::Renderer() {}
+Renderer::Renderer()
+    : queue(), cacheLayers(true), software(nullptr), capture(nullptr),
+      tileMap(nullptr), background(LayerBackground, 0),
+      hudChrome(LayerHud, 0) {}
+
+void Renderer::SetTileMap(TileMap *map) {
+  tileMap = map;
+  background.MarkDirty();
+}
 
-void Renderer::Render(const EntityManager &entities, const GameState &state) {
-  BeginDrawing();
-  ClearBackground(BLACK);
+void Renderer::UnloadLayers() {
+  background.Unload();
+  hudChrome.Unload();
+}
 
-  // HUD: Speed (mph) and Timer
-  float mph = entities.player.speed *
-              0.0621371f; // 1 px/sec = 0.0621371 mph (arbitrary scale)
-  char hud[64];
-  snprintf(hud, sizeof(hud), "Speed: %.1f mph   Time: %.2f s", mph,
-           state.elapsedTime);
-  DrawText(hud, 20, 20, 20, WHITE);
+void Renderer::RecordBackground(RenderQueue &queue, int screenW,
+                                int screenH) {
+  // Floor: a checkerboard of dark tiles
+  const Color tileA = {18, 18, 26, 255};
+  const Color tileB = {24, 24, 34, 255};
+  int columns = (int)ceilf(screenW / tileSize);
+  int rows = (int)ceilf(screenH / tileSize);
+  for (int row = 0; row < rows; ++row) {
+    for (int column = 0; column < columns; ++column) {
+      queue.PushRectangle(
+          LayerBackground, 0,
+          {column * tileSize, row * tileSize, tileSize, tileSize},
+          (row + column) % 2 ? tileB : tileA);
+    }
+  }
+  const Color wall = {150, 30, 30, 255};
+  if (tileMap) {
+    // The walls are the map's solid tiles; the screen shows its top left
+    float size = tileMap->TileSize();
+    int mapColumns =
+        std::min((int)ceilf(screenW / size), tileMap->WidthTiles());
+    int mapRows = std::min((int)ceilf(screenH / size), tileMap->HeightTiles());
+    for (int y = 0; y < mapRows; ++y) {
+      for (int x = 0; x < mapColumns; ++x) {
+        if (tileMap->IsSolid(x, y))
+          queue.PushRectangle(LayerBackground, 1,
+                              {x * size, y * size, size, size}, wall);
+      }
+    }
+    return;
+  }
+  // The walls are the window's edges
+  float w = (float)screenW, h = (float)screenH;
+  queue.PushRectangle(LayerBackground, 1, {0, 0, w, wallWidth}, wall);
+  queue.PushRectangle(LayerBackground, 1, {0, h - wallWidth, w, wallWidth},
+                      wall);
+  queue.PushRectangle(LayerBackground, 1, {0, 0, wallWidth, h}, wall);
+  queue.PushRectangle(LayerBackground, 1, {w - wallWidth, 0, wallWidth, h},
+                      wall);
+}
 
+void Renderer::RecordHudChrome(RenderQueue &queue) {
+  // Opaque: blended into the texture and then onto the frame, a
+  // translucent panel would come out thinner than drawn
+  queue.PushRectangle(LayerHud, 0, hudPanel, Color{0, 0, 0, 255});
+  queue.PushText(LayerHud, 0, "SPEED", hudSpeedX, 14, hudLabelSize, GRAY);
+  queue.PushText(LayerHud, 0, "TIME", hudTimeX, 14, hudLabelSize, GRAY);
+}
+
+void Renderer::RecordOverlay(RenderQueue &queue, const GameState &state,
+                             int screenW, int screenH) {
   if (state.countdownActive) {
-    int screenW = GetScreenWidth();
-    int screenH = GetScreenHeight();
     int number = (int)ceilf(state.countdownTime);
     if (number > 0) {
       char numStr[16];
       snprintf(numStr, sizeof(numStr), "%d", number);
       int fontSize = 120;
-      DrawText(numStr, screenW / 2 - MeasureText(numStr, fontSize) / 2,
-               screenH / 2 - fontSize / 2, fontSize, YELLOW);
+      queue.PushText(LayerOverlay, 0, numStr,
+                     screenW / 2 - TextWidth(numStr, fontSize) / 2,
+                     screenH / 2 - fontSize / 2, fontSize, YELLOW);
     }
-    EndDrawing();
-    return;
-  }
-
-  if (state.gameOver) {
-    int screenW = GetScreenWidth();
-    int screenH = GetScreenHeight();
+  } else if (state.gameOver) {
     const char *msg = "GAME OVER";
     const char *prompt = "Press R to Restart";
     int fontSize = 40;
     int promptSize = 20;
-    DrawText(msg, screenW / 2 - MeasureText(msg, fontSize) / 2,
-             screenH / 2 - fontSize, fontSize, RED);
-    DrawText(prompt, screenW / 2 - MeasureText(prompt, promptSize) / 2,
-             screenH / 2 + 10, promptSize, WHITE);
+    queue.PushText(LayerOverlay, 0, msg,
+                   screenW / 2 - TextWidth(msg, fontSize) / 2,
+                   screenH / 2 - fontSize, fontSize, RED);
+    queue.PushText(LayerOverlay, 0, prompt,
+                   screenW / 2 - TextWidth(prompt, promptSize) / 2,
+                   screenH / 2 + 10, promptSize, WHITE);
+  }
+}
+
+int Renderer::TextWidth(const char *text, int fontSize) {
+  return software ? software->MeasureText(text, fontSize)
+                  : MeasureText(text, fontSize);
+}
+
+void Renderer::Render(const EntityManager &entities, const GameState &state) {
+  // Recorded in whatever order is convenient; the queue's keys decide
+  // what ends up on top
+  queue.Clear();
+  int screenW = software ? software->Width() : GetScreenWidth();
+  int screenH = software ? software->Height() : GetScreenHeight();
+  Rectangle screen = {0, 0, (float)screenW, (float)screenH};
+
+  if (cacheLayers && !software) {
+    // Redraws go to their own textures, before the frame begins
+    if (background.NeedsRedraw(screen)) {
+      RecordBackground(background.Record(), screenW, screenH);
+      background.Redraw();
+    }
+    if (hudChrome.NeedsRedraw(hudPanel)) {
+      RecordHudChrome(hudChrome.Record());
+      hudChrome.Redraw();
+    }
+    background.Composite(queue);
+    hudChrome.Composite(queue);
   } else {
-    entities.player.Draw(); // Draw the player entity
+    RecordBackground(queue, screenW, screenH);
+    RecordHudChrome(queue);
   }
 
+  // Every frame: the overlay, the HUD values over the panel, the player
+  RecordOverlay(queue, state, screenW, screenH);
+  // 1 px/sec = 0.0621371 mph (arbitrary scale)
+  float mph = entities.player.speed * 0.0621371f;
+  char value[32];
+  snprintf(value, sizeof(value), "%.1f mph", mph);
+  queue.PushText(LayerHud, 1, value, hudSpeedX, 28, hudValueSize, WHITE);
+  snprintf(value, sizeof(value), "%.2f s", state.elapsedTime);
+  queue.PushText(LayerHud, 1, value, hudTimeX, 28, hudValueSize, WHITE);
+
+  if (!state.countdownActive && !state.gameOver) {
+    const Player &player = entities.player;
+    queue.PushRectangle(LayerWorld, 0,
+                        {player.position.x, player.position.y,
+                         player.bounds.width, player.bounds.height},
+                        YELLOW);
+  }
+
+  queue.Sort();
+  if (software) {
+    software->Draw(queue, BLACK);
+    if (capture)
+      capture->Submit(software->Pixels(), software->Width(),
+                      software->Height());
+    return;
+  }
+  BeginDrawing();
+  ClearBackground(BLACK);
+  queue.Submit();
+  if (capture)
+    capture->ReadFramebuffer();
   EndDrawing();
 }
 
 // ----------- Game -----------
 
 Game::Game()
-    : gameState(), inputHandler(), audioManager(), physicsEngine(),
-      entityManager(), renderer() {}
+    : keyboard(), gameState(), inputHandler(keyboard), audioManager(true),
+      physicsEngine(), entityManager((uint32_t)std::rand()), renderer(),
+      timers(timerTicksPerSecond), gameOverSignal(), sequences(timers),
+      round(), timerClock(0.0), simTime(0.0), tickCount(0), metrics(),
+      lastFrameStart(-1.0) {
+  StartCountdown(countdownSeconds);
+}
+
+Game::Game(InputSource &input, uint32_t seed)
+    : keyboard(), gameState(), inputHandler(input), audioManager(false),
+      physicsEngine(), entityManager(seed), renderer(),
+      timers(timerTicksPerSecond), gameOverSignal(), sequences(timers),
+      round(), timerClock(0.0), simTime(0.0), tickCount(0), metrics(),
+      lastFrameStart(-1.0) {
+  StartCountdown(countdownSeconds);
+}
+
+// One round, from the countdown to the game over. Update only reads
+// the flags this sets; it never polls for the next step.
+static Sequence RoundSequence(SequenceRunner &runner, Game &game,
+                              float countdown) {
+  GameState &state = game.gameState;
+  Trace(TraceRoundStart, game.tickCount, countdown);
+  state.countdownActive = countdown > 0.0f;
+  state.countdownTime = countdown > 0.0f ? countdown : 0.0f;
+  co_await runner.Delay(countdown); // Update shows what's left
+  state.countdownActive = false;
+  state.countdownTime = 0.0f;
+  Trace(TraceCountdownEnd, game.tickCount);
+
+  if (!state.gameOver) { // Netcode may start a round that already ended
+    co_await game.gameOverSignal;
+    game.audioManager.PlayBeep();
+  }
+  Trace(TraceGameOver, game.tickCount, state.elapsedTime);
+}
+
+void Game::StartCountdown(float seconds) {
+  sequences.Stop(round);
+  round = sequences.Start(RoundSequence(sequences, *this, seconds));
+}
+
+void Game::SyncRoundState(float countdownLeft, bool gameOver) {
+  bool counting = countdownLeft > 0.0f;
+  bool samePhase =
+      counting == gameState.countdownActive && gameOver == gameState.gameOver;
+  // A rewind can land earlier in the same countdown: the wait must move
+  if (samePhase && counting)
+    samePhase = fabs(sequences.WaitLeft(round) - countdownLeft) <
+                0.5 / timerTicksPerSecond;
+  gameState.gameOver = gameOver;
+  if (!samePhase)
+    StartCountdown(countdownLeft);
+  else if (counting)
+    gameState.countdownTime = countdownLeft;
+}
 
-void Game::HandleInput() { inputHandler.HandleInput(gameState, entityManager); }
+// Where the player was stopped, and on which side: a screen edge or,
+// with a TileMap, whatever tile the sweep ran into
+static void TraceWallHitEvent(uint64_t tick, const Player &player,
+                              int wall) {
+  Trace(TraceWallHit, tick, player.position.x, player.position.y,
+        player.speed, TraceDirection(player.moveDir.x, player.moveDir.y),
+        wall);
+}
+
+void Game::CaptureInput(double now) { inputHandler.Capture(now); }
 
 void Game::Update(float deltaTime) {
   if (gameState.resetRequested) {
     entityManager.ResetPlayer();
+    const Player &player = entityManager.player;
+    Trace(TraceReset, tickCount, player.position.x, player.position.y,
+          TraceDirection(player.moveDir.x, player.moveDir.y));
     gameState.shutdownRequested = false;
     gameState.resetRequested = false;
     gameState.gameOver = false;
     gameState.elapsedTime = 0.0f; // Reset timer
-    gameState.countdownActive = true;
-    gameState.countdownTime = 3.0f;
-  }
-  if (gameState.countdownActive) {
-    gameState.countdownTime -= deltaTime;
-    if (gameState.countdownTime <= 0.0f) {
-      gameState.countdownActive = false;
-      gameState.countdownTime = 0.0f;
-    }
+    StartCountdown(countdownSeconds);
+  }
+
+  bool countingDown = gameState.countdownActive;
+  timerClock += deltaTime;
+  timers.Advance(timerClock); // Resumes sequences whose wait is over
+  if (countingDown) {
+    if (gameState.countdownActive)
+      gameState.countdownTime = (float)sequences.WaitLeft(round);
     // Don't update timer or physics/entities during countdown
     return;
   }
@@ -206,19 +528,81 @@ void Game::Update(float deltaTime) {
     gameState.elapsedTime += deltaTime;
     physicsEngine.Update(gameState, entityManager, deltaTime);
     entityManager.Update(gameState, deltaTime);
+    if (gameState.gameOver) {
+      TraceWallHitEvent(tickCount, entityManager.player,
+                        physicsEngine.HitWall());
+      gameOverSignal.Raise(); // The round sequence takes it from here
+    }
   }
 }
 
 void Game::Render() { renderer.Render(entityManager, gameState); }
 
+void Game::Step(float deltaTime) {
+  // Presses not stamped yet (scripted ones) count as the start of the tick
+  inputHandler.Capture(simTime);
+
+  double tickEnd = simTime + deltaTime;
+  double cursor = simTime;
+  InputEvent event;
+  while (inputHandler.NextEvent(tickEnd, event)) {
+    // Simulate up to the moment of the press, then apply it there
+    if (event.time > cursor) {
+      Update((float)(event.time - cursor));
+      cursor = event.time;
+    }
+    inputHandler.Apply(event, cursor, gameState, entityManager);
+    const Player &player = entityManager.player;
+    Trace(TraceInput, tickCount, event.key,
+          (unsigned)((cursor - event.time) * 1e6), player.speed,
+          TraceDirection(player.moveDir.x, player.moveDir.y));
+  }
+  Update((float)(tickEnd - cursor));
+  simTime = tickEnd;
+
+  const Player &player = entityManager.player;
+  Trace(TraceStep, tickCount, player.position.x, player.position.y,
+        player.speed, TraceDirection(player.moveDir.x, player.moveDir.y),
+        (unsigned)(simTime * 1000.0));
+  tickCount++;
+}
+
 void Game::Run() {
-  // Ensure player is centered after window is created (only on first frame)
-  static bool initialized = false;
-  if (!initialized) {
-    entityManager.ResetPlayer();
-    initialized = true;
+  double now = GetTime();
+  // First frame, or the window stalled (dragged, debugger): restart the
+  // simulation clock instead of simulating the whole gap
+  if (now - simTime > maxFrameGap) {
+    simTime = now - GetFrameTime();
   }
-  HandleInput();
-  Update(GetFrameTime());
+  CaptureInput(now);
+  Step((float)(now - simTime));
   Render();
+  PublishMetrics(now, GetTime());
+}
+
+void Game::PublishMetrics(double frameStart, double frameEnd) {
+  if (lastFrameStart >= 0.0)
+    metrics.frameInterval.Record(frameStart - lastFrameStart);
+  lastFrameStart = frameStart;
+  metrics.frameWork.Record(frameEnd - frameStart);
+  MetricAdd(metrics.frames, (uint64_t)1);
+
+  MetricSet(metrics.entities, (uint32_t)entityManager.Count());
+  MetricSet(metrics.gameOver, (uint32_t)gameState.gameOver);
+  MetricSet(metrics.elapsedSeconds, gameState.elapsedTime);
+  MetricSet(metrics.playerSpeed, entityManager.player.speed);
+
+  const InputStats &stats = inputHandler.Stats();
+  MetricSet(metrics.inputsApplied, (uint64_t)stats.applied);
+  MetricSet(metrics.inputsDropped, (uint64_t)inputHandler.Queue().Dropped());
+  MetricSet(metrics.inputLatencyMeanUs,
+            (uint32_t)(stats.applied ? stats.totalLatency * 1e6 / stats.applied
+                                     : 0.0));
+
+  MetricSet(metrics.timersPending, (uint32_t)timers.Count());
+  MetricSet(metrics.timersFired, (uint64_t)timers.Fired());
+  MetricSet(metrics.sequencesRunning, (uint32_t)sequences.Count());
+  MetricSet(metrics.framePoolAllocations,
+            (uint64_t)sequences.Pool().Allocations());
+  MetricSet(metrics.framePoolBytes, (uint64_t)sequences.Pool().ReservedBytes());
 }
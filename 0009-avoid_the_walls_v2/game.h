@@ -2,8 +2,18 @@
 
 #pragma once
 
+#include "capture.h"
 #include "entity.h"
+#include "layer_cache.h"
+#include "metrics.h"
 #include "raylib.h"
+#include "render_queue.h"
+#include "sequence.h"
+#include "soft_raster.h"
+#include "tilemap.h"
+#include "timer_wheel.h"
+#include "trace.h"
+#include <cstdint>
 
 // ----------- GameState -----------
 // Manages: overall game status flags
@@ -35,10 +45,11 @@ public:
 class AudioManager {
 public:
   void PlayBeep(); // Example: play a simple beep sound
-  AudioManager();
+  explicit AudioManager(bool enabled); // Disabled: no device, no loading
   ~AudioManager();
 
 private:
+  bool enabled;
   Sound sound;
 };
 
@@ -55,31 +66,141 @@ class EntityManager {
 public:
   Player player;
   void Update(GameState &state, float deltaTime);
-  EntityManager();
+  explicit EntityManager(uint32_t seed);
 
   void SetPlayerMoveDirection(Vector2 direction);
   void ResetPlayer(); // Add this method
+  int Count() const { return 1; } // Just the player so far
+
+  // Lets netcode and replays carry the restart direction sequence
+  uint32_t RandomState() const { return rngState; }
+  void SetRandomState(uint32_t state) { rngState = state ? state : 1; }
+
+private:
+  uint32_t rngState; // Per-game xorshift, so sessions don't share raylib's RNG
+};
+
+// ----------- InputEvent -----------
+// One key press and when it happened (seconds on the simulation clock)
+struct InputEvent {
+  int key;
+  double time;
+};
+
+// ----------- InputEventQueue -----------
+// Manages: key presses waiting for the simulation, oldest first
+// Should Own:
+//   - A fixed ring of events (no allocation while playing)
+//   - Counting presses dropped because the ring was full
+// Should Not:
+//   - Interpret keys
+class InputEventQueue {
+public:
+  InputEventQueue();
+  void Push(int key, double time);
+  bool Pop(double until, InputEvent &event); // Oldest event at or before until
+  int Count() const { return (int)(head - tail); }
+  long long Dropped() const { return dropped; }
+
+private:
+  static const int capacity = 64; // Power of two
+  InputEvent events[capacity];
+  uint32_t head; // Next slot to write
+  uint32_t tail; // Oldest unread slot
+  long long dropped;
+};
+
+// ----------- InputSource -----------
+// Manages: where key presses come from
+// Should Own:
+//   - Handing over every press since the last poll, in order
+// Should Not:
+//   - Know about game state or entities
+class InputSource {
+public:
+  virtual ~InputSource() {}
+  // Presses without a better timestamp are stamped 'now'
+  virtual void Poll(InputEventQueue &queue, double now) = 0;
+};
+
+// ----------- KeyboardInput -----------
+// The real keyboard through raylib's key-pressed queue (needs an open
+// window). Presses are stamped with the poll time, so polling more often
+// than once a frame gives finer timestamps.
+class KeyboardInput : public InputSource {
+public:
+  void Poll(InputEventQueue &queue, double now) override;
+};
+
+// ----------- ScriptedInput -----------
+// Key presses pushed by code (bots, the session host, benchmarks); a
+// press is handed over on the next poll and stays visible to
+// IsKeyPressed() until Clear()
+class ScriptedInput : public InputSource {
+public:
+  ScriptedInput();
+  void Press(int key);              // Happens at the next poll
+  void Press(int key, double time); // Happens at 'time' (simulation clock)
+  void Clear();
+  bool IsKeyPressed(int key) const;
+  void Poll(InputEventQueue &queue, double now) override;
+
+private:
+  InputEvent pressed[16]; // Extra presses are dropped
+  int count;
+  int polled; // Presses already handed over
+};
+
+// ----------- InputStats -----------
+// Input-to-simulation latency: how long after its timestamp each press
+// took effect in the simulation
+struct InputStats {
+  long long applied = 0;
+  double totalLatency = 0.0; // Seconds
+  double maxLatency = 0.0;
+  int histogram[100] = {}; // 0.5 ms bins, the last one holds the rest
+
+  void Record(double latency);
+  double Percentile(float p) const; // Seconds (bin upper edge)
 };
 
 // ----------- InputHandler -----------
 // Manages: user input handling
 // Should Own:
 //   - Mapping input keys/buttons to actions
-//   - Detecting key presses or mouse input
+//   - Collecting timestamped key presses (through an InputSource) into a
+//     ring, so several presses in one frame are all kept
+//   - Latency statistics
 // Should Not:
 //   - Update entities
 //   - Play sounds
 class InputHandler {
 public:
-  void HandleInput(GameState &state, EntityManager &entities);
-  InputHandler();
+  explicit InputHandler(InputSource &source);
+
+  void Capture(double now); // Pulls new presses from the source
+  // Oldest press at or before 'until'; false when there is none
+  bool NextEvent(double until, InputEvent &event);
+  // Acts on one press; 'simTime' is when the simulation applies it
+  void Apply(const InputEvent &event, double simTime, GameState &state,
+             EntityManager &entities);
+
+  const InputEventQueue &Queue() const { return queue; }
+  const InputStats &Stats() const { return stats; }
+
+private:
+  InputSource *source;
+  InputEventQueue queue;
+  InputStats stats;
 };
 
 // ----------- PhysicsEngine -----------
 // Manages: movement and physical simulation
 // Should Own:
 //   - Updating positions, velocities, forces
-//   - (Later) Handling collisions, gravity, friction
+//   - Collisions: with the window's edges, or with a TileMap's solid
+//     tiles (swept, so no speed passes through a wall)
+//   - (Later) Gravity, friction
 // Should Not:
 //   - Render entities
 //   - Handle user input
@@ -87,13 +208,28 @@ class PhysicsEngine {
 public:
   void Update(GameState &state, EntityManager &entities, float deltaTime);
   PhysicsEngine();
+  // The player collides with 'map' (nullptr: the window's edges) and
+  // stops against the tile it hits. Not owned.
+  void SetTileMap(TileMap *map) { tileMap = map; }
+  // Side of the player that hit in the last Update, as a trace wall
+  // argument (see TraceWall); 4 when nothing was hit
+  int HitWall() const { return hitWall; }
+
+private:
+  TileMap *tileMap;
+  int hitWall;
 };
 
 // ----------- Renderer -----------
 // Manages: drawing to the screen
 // Should Own:
 //   - Drawing entities, backgrounds, UI
-//   - Managing the render order if necessary
+//   - Managing the render order (records into a RenderQueue, sorted by
+//     layer and depth before anything is drawn)
+//   - Caching what rarely changes (the playfield, the HUD panel) in
+//     CachedLayers
+//   - Where the frame goes: the window, or a SoftwareRasterizer
+//   - Handing finished frames to a FrameCapture, when recording
 // Should Not:
 //   - Update game logic or entity states
 //   - Handle input or play sounds
@@ -101,6 +237,41 @@ class Renderer {
 public:
   void Render(const EntityManager &entities, const GameState &state);
   Renderer();
+  const RenderQueue &Queue() const { return queue; } // Last frame's
+
+  // Off: every layer is recorded into the frame again every frame
+  void SetLayerCaching(bool enabled) { cacheLayers = enabled; }
+  const CachedLayer &Background() const { return background; }
+  const CachedLayer &HudChrome() const { return hudChrome; }
+  // Frames go into 'target' instead of the window (nullptr: back to the
+  // window). Its size is the screen's; layers aren't cached, since their
+  // textures would live on the GPU. Not owned.
+  void SetSoftwareTarget(SoftwareRasterizer *target) { software = target; }
+  // Every frame also goes to 'capture' (nullptr: stop). Not owned.
+  void SetCapture(FrameCapture *target) { capture = target; }
+  // The background shows the map's solid tiles under the screen
+  // (nullptr: the window's edges are the walls). Not owned.
+  void SetTileMap(TileMap *map);
+  // Frees the cached layers' textures; call it before CloseWindow
+  void UnloadLayers();
+
+private:
+  RenderQueue queue;
+  bool cacheLayers;
+  SoftwareRasterizer *software;
+  FrameCapture *capture;
+  TileMap *tileMap;
+  CachedLayer background; // Floor tiles and the walls
+  CachedLayer hudChrome;  // HUD panel and its labels
+
+  void RecordBackground(RenderQueue &queue, int screenW, int screenH);
+  static void RecordHudChrome(RenderQueue &queue);
+  // Countdown number or game over text: a few glyphs that change every
+  // second, cheaper to draw than to composite, so never cached
+  void RecordOverlay(RenderQueue &queue, const GameState &state,
+                     int screenW, int screenH);
+  // MeasureText with the font the frame will be drawn with
+  int TextWidth(const char *text, int fontSize);
 };
 
 // ----------- Game -----------
@@ -114,16 +285,44 @@ public:
 //   subsystems)
 class Game {
 public:
+  KeyboardInput keyboard; // Input for the windowed game
   GameState gameState;
   InputHandler inputHandler;
   AudioManager audioManager;
   PhysicsEngine physicsEngine;
   EntityManager entityManager;
   Renderer renderer;
+  TimerWheel timers;        // Game timers, on Update's clock (1/960 s)
+  Signal gameOverSignal;    // Raised when the player hits a wall
+  SequenceRunner sequences; // Scripted flows, resumed by timers and signals
+  SequenceHandle round;     // Countdown, play, game over
+  double timerClock;        // Seconds simulated by Update
+
+  double simTime;     // Simulation clock (seconds), input is stamped on it
+  uint64_t tickCount; // Steps taken, the tick in trace records
+
+  GameMetrics metrics;   // Published every frame, see MetricsServer
+  double lastFrameStart; // For the frame interval, < 0 before the first
 
-  Game();
-  void HandleInput();
+  Game(); // Keyboard, audio, seeded from std::rand()
+  // Headless: no audio and no window needed as long as Render() isn't called
+  Game(InputSource &input, uint32_t seed);
+  void CaptureInput(double now); // May be called many times per frame
+  // Restarts the round sequence with 'seconds' of countdown left (0 ends
+  // the countdown right away)
+  void StartCountdown(float seconds);
+  // Takes the round's state from elsewhere (a netcode snapshot): the
+  // sequence restarts only when the phase changes (countdown, play, game
+  // over) or a countdown's time left disagrees, so applying the state a
+  // tick already has costs nothing
+  void SyncRoundState(float countdownLeft, bool gameOver);
   void Update(float deltaTime);
   void Render();
-  void Run();
+  // Advances the simulation clock by deltaTime, applying each press at
+  // its own timestamp within the tick; traces the presses, wall hits and
+  // where the player ended up (see trace.h)
+  void Step(float deltaTime);
+  void Run(); // Step up to GetTime(), then render
+  // Copies this frame's numbers into 'metrics' (game thread only)
+  void PublishMetrics(double frameStart, double frameEnd);
 };
@@ -0,0 +1,74 @@
+// host.cpp
+//
+// Headless session host for Avoid the Walls: runs many bot-driven games on a
+// worker pool and reports per-session tick latency and sessions per core.
+//
+// Usage: host [sessions] [workers] [ticksPerSession] [sliceTicks] [paced]
+//   paced = 1 holds every round to the 60 Hz virtual clock (a real server);
+//   paced = 0 (default) runs as fast as possible to measure capacity
+
+#include "../session_host.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+// Median and worst of one latency column across sessions
+static void PrintSpread(const char *label, std::vector<uint32_t> values) {
+  if (values.empty())
+    return;
+  std::sort(values.begin(), values.end());
+  printf("  %-12s median %8.1f us   worst %8.1f us\n", label,
+         values[values.size() / 2] / 1000.0, values.back() / 1000.0);
+}
+
+int main(int argc, char **argv) {
+  HostConfig config;
+  unsigned int cores = std::thread::hardware_concurrency();
+  config.workers = cores ? (int)cores : 4;
+  if (argc > 1)
+    config.sessions = atoi(argv[1]);
+  if (argc > 2)
+    config.workers = atoi(argv[2]);
+  if (argc > 3)
+    config.ticksPerSession = atoi(argv[3]);
+  if (argc > 4)
+    config.sliceTicks = atoi(argv[4]);
+  if (argc > 5)
+    config.paced = atoi(argv[5]) != 0;
+
+  printf("%d sessions, %d workers, %d ticks each, %d-tick slices, %s\n",
+         config.sessions, config.workers, config.ticksPerSession,
+         config.sliceTicks, config.paced ? "paced at 60 Hz" : "unpaced");
+
+  SessionHost host(config);
+  HostReport report = host.Run();
+
+  std::vector<uint32_t> p50, p99, worst, lateP99, lateWorst;
+  long long games = 0;
+  for (const SessionReport &s : report.sessions) {
+    p50.push_back(s.serviceP50);
+    p99.push_back(s.serviceP99);
+    worst.push_back(s.serviceMax);
+    lateP99.push_back(s.lateP99);
+    lateWorst.push_back(s.lateMax);
+    games += s.games;
+  }
+
+  printf("per-session tick time:\n");
+  PrintSpread("p50", p50);
+  PrintSpread("p99", p99);
+  PrintSpread("max", worst);
+  if (config.paced) {
+    printf("per-session lateness behind the virtual clock:\n");
+    PrintSpread("p99", lateP99);
+    PrintSpread("max", lateWorst);
+  }
+  printf("%lld ticks, %lld games over, %.3f s wall, %.3f s busy\n",
+         report.totalTicks, games, report.wallSeconds, report.busySeconds);
+  printf("%.1f M ticks/s, %.0f sessions per core at %.0f Hz\n",
+         report.wallSeconds > 0 ? report.totalTicks / report.wallSeconds / 1e6
+                                : 0.0,
+         report.sessionsPerCore, config.tickRate);
+  return 0;
+}
@@ -0,0 +1,93 @@
+// layer_cache.cpp
+
+#include "layer_cache.h"
+#include <cmath>
+
+// ----------- CachedLayer -----------
+
+CachedLayer::CachedLayer(RenderLayer layer, uint32_t depth)
+    : layer(layer), depth(depth), target(), loaded(false), dirty(true),
+      area(), used(), content(), contentPixels(0.0), redraws(0),
+      composites(0), redrawPixels(0.0), compositePixels(0.0),
+      directPixels(0.0) {}
+
+CachedLayer::~CachedLayer() {
+  // After CloseWindow the context is gone, and the texture with it
+  if (IsWindowReady()) {
+    Unload();
+  }
+}
+
+void CachedLayer::Unload() {
+  if (loaded) {
+    UnloadRenderTexture(target);
+    loaded = false;
+  }
+  dirty = true;
+}
+
+bool CachedLayer::NeedsRedraw(Rectangle newArea) {
+  if (newArea.x != area.x || newArea.y != area.y ||
+      newArea.width != area.width || newArea.height != area.height) {
+    if (loaded &&
+        (newArea.width != area.width || newArea.height != area.height)) {
+      UnloadRenderTexture(target);
+      loaded = false;
+    }
+    area = newArea;
+    dirty = true;
+  }
+  return dirty;
+}
+
+RenderQueue &CachedLayer::Record() {
+  content.Clear();
+  return content;
+}
+
+void CachedLayer::Redraw() {
+  if (!loaded) {
+    target = LoadRenderTexture((int)area.width, (int)area.height);
+    loaded = true;
+  }
+  // The content is recorded in screen pixels; shift it into the texture
+  Camera2D camera = {};
+  camera.target = {area.x, area.y};
+  camera.zoom = 1.0f;
+  content.Sort();
+  BeginTextureMode(target);
+  ClearBackground(BLANK);
+  BeginMode2D(camera);
+  content.Submit();
+  EndMode2D();
+  EndTextureMode();
+
+  // Only what the content covers goes on screen each frame
+  Rectangle b = content.Bounds();
+  float left = fmaxf(floorf(b.x), area.x);
+  float top = fmaxf(floorf(b.y), area.y);
+  float right = fminf(ceilf(b.x + b.width), area.x + area.width);
+  float bottom = fminf(ceilf(b.y + b.height), area.y + area.height);
+  used = right > left && bottom > top
+             ? Rectangle{left, top, right - left, bottom - top}
+             : Rectangle{0.0f, 0.0f, 0.0f, 0.0f};
+
+  contentPixels = content.FillPixels();
+  redrawPixels += area.width * area.height + contentPixels;
+  redraws++;
+  dirty = false;
+}
+
+void CachedLayer::Composite(RenderQueue &frame) {
+  if (used.width <= 0.0f)
+    return;
+  // Render textures come out upside down: take the rows from the bottom
+  // and flip them
+  float x = used.x - area.x;
+  float y = area.height - (used.y - area.y) - used.height;
+  frame.PushTexture(layer, depth, target.texture,
+                    {x, y, used.width, -used.height}, used, WHITE);
+  compositePixels += used.width * used.height;
+  directPixels += contentPixels;
+  composites++;
+}
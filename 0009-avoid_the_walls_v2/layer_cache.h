@@ -0,0 +1,68 @@
+// layer_cache.h
+
+#pragma once
+
+#include "raylib.h"
+#include "render_queue.h"
+
+// ----------- CachedLayer -----------
+// Manages: content that rarely changes, drawn once into its own
+// RenderTexture2D and put on screen as a single textured quad
+// Should Own:
+//   - The texture (loaded on the first redraw, so a headless Game never
+//     touches the GPU, and unloaded while the window is still open) and
+//     the queue its content is recorded into
+//   - Knowing when a redraw is due: marked dirty, or moved or resized
+//   - Redraw and fill counts, to show what the cache saves
+// Should Not:
+//   - Decide what goes on the layer (the Renderer records it)
+//   - Begin or end the frame
+class CachedLayer {
+public:
+  CachedLayer(RenderLayer layer, uint32_t depth);
+  ~CachedLayer(); // Unloads, if the window is still open
+
+  CachedLayer(const CachedLayer &) = delete;
+  CachedLayer &operator=(const CachedLayer &) = delete;
+
+  void MarkDirty() { dirty = true; }
+  // Frees the texture (before CloseWindow: it needs the GL context); the
+  // next redraw loads it again
+  void Unload();
+  // True when the content must be recorded again for a layer that may
+  // draw anywhere in 'area' (screen pixels, the texture's size): then
+  // record into Record() and call Redraw()
+  bool NeedsRedraw(Rectangle area);
+  RenderQueue &Record(); // Cleared, for this redraw's commands
+  // Draws what was recorded into the texture (outside BeginDrawing)
+  void Redraw();
+  // Pushes the part of the texture the content covers onto the frame,
+  // at the layer's place in the order; nothing when it's empty
+  void Composite(RenderQueue &frame);
+
+  long long Redraws() const { return redraws; }
+  long long Composites() const { return composites; }
+  // Pixels filled: drawing the content at each redraw (and clearing the
+  // texture), compositing it every frame, and what drawing the content
+  // straight onto the frame every frame would have filled instead
+  double RedrawPixels() const { return redrawPixels; }
+  double CompositePixels() const { return compositePixels; }
+  double DirectPixels() const { return directPixels; }
+
+private:
+  RenderLayer layer;
+  uint32_t depth;
+  RenderTexture2D target;
+  bool loaded;
+  bool dirty;
+  Rectangle area; // Where the texture goes on screen
+  Rectangle used; // The part of 'area' the content covers
+  RenderQueue content;
+  double contentPixels; // Fill of the last recorded content
+
+  long long redraws;
+  long long composites;
+  double redrawPixels;
+  double compositePixels;
+  double directPixels;
+};
@@ -1,7 +1,10 @@
 // main.cpp
 
+#include "constants.h"
 #include "game.h"
 #include "loop.h"
+#include "metrics.h"
+#include "trace.h"
 #include <cassert>
 #include <cstdlib>
 #include <ctime>
@@ -18,11 +21,42 @@ int main() {
   // Seed random number generator
   std::srand(std::time(nullptr));
 
+  // Optional binary trace, flushed on its own thread (opened first
+  // so it has the first countdown)
+  if (const char *path = std::getenv(traceFileVariable)) {
+    GameTrace().Open(path);
+  }
+
   // Create game instance
   Game game;
 
+  // Optional live metrics, read on their own thread
+  MetricsServer metricsServer(game.metrics);
+  if (const char *endpoint = std::getenv(metricsEndpointVariable)) {
+    metricsServer.Start(endpoint);
+  }
+
+  // Optional frame capture, written on its own thread
+  FrameCapture capture;
+  if (const char *path = std::getenv(captureFileVariable)) {
+    if (capture.Open(path, screenWidth, screenHeight, 60)) {
+      game.renderer.SetCapture(&capture);
+    }
+  }
+
   // Run the main loop (platform handles window, etc)
   RunPlatformLoop(MainLoop, &game);
+  GameTrace().Close();
+  if (capture.IsOpen()) {
+    game.renderer.SetCapture(nullptr);
+    capture.Close();
+    TraceLog(LOG_INFO,
+             "CAPTURE: %lld frames, %lld written (%lld repeats), %lld "
+             "dropped, %.0f us/frame (max %.0f) on the game loop",
+             capture.Frames(), capture.Written(), capture.Repeated(),
+             capture.Dropped(), capture.MeanCaptureMicroseconds(),
+             capture.MaxCaptureMicroseconds());
+  }
 
   return 0;
 }
\ No newline at end of file
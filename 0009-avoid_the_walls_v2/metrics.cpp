@@ -0,0 +1,255 @@
+// metrics.cpp
+
+#include "metrics.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if !defined(PLATFORM_WEB) && !defined(_WIN32)
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define METRICS_SOCKETS
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS: SO_NOSIGPIPE is set on the socket instead
+#endif
+#endif
+
+static void Append(std::string &out, const char *format, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length > 0)
+    out.append(buffer, length < (int)sizeof(buffer) ? length
+                                                    : sizeof(buffer) - 1);
+}
+
+template <typename T> static T Read(const std::atomic<T> &value) {
+  return value.load(std::memory_order_relaxed);
+}
+
+// ----------- MetricsHistogram -----------
+
+void MetricsHistogram::Record(double seconds) {
+  uint64_t ns = seconds > 0.0 ? (uint64_t)(seconds * 1e9) : 0;
+  uint64_t bin = ns / binNs;
+  MetricAdd(bins[bin < (uint64_t)binCount ? bin : binCount - 1], 1u);
+  MetricAdd(totalNs, ns);
+  if (ns > Read(maxNs))
+    MetricSet(maxNs, ns);
+}
+
+void MetricsHistogram::WriteJson(std::string &out) const {
+  // Copy first so the summary and the bins agree with each other
+  uint32_t copy[binCount];
+  uint64_t count = 0;
+  int used = 0;
+  for (int i = 0; i < binCount; ++i) {
+    copy[i] = Read(bins[i]);
+    count += copy[i];
+    if (copy[i])
+      used = i + 1;
+  }
+  double maxMs = Read(maxNs) / 1e6;
+  auto percentile = [&](double p) {
+    uint64_t wanted = (uint64_t)(p * count), seen = 0;
+    for (int i = 0; i < binCount - 1; ++i) {
+      seen += copy[i];
+      if (seen > wanted) // Bin upper edge, but never past the maximum
+        return std::min((i + 1) * (binNs / 1e6), maxMs);
+    }
+    return maxMs;
+  };
+  Append(out,
+         "{\"count\":%llu,\"mean_ms\":%.3f,\"p50_ms\":%.2f,\"p99_ms\":%.2f,"
+         "\"max_ms\":%.3f,",
+         (unsigned long long)count,
+         count ? Read(totalNs) / 1e6 / count : 0.0, percentile(0.50),
+         percentile(0.99), maxMs);
+  Append(out, "\"bin_ms\":%.2f,\"bins\":[", binNs / 1e6);
+  for (int i = 0; i < used; ++i) {
+    Append(out, i ? ",%u" : "%u", copy[i]);
+  }
+  out += "]}";
+}
+
+// ----------- GameMetrics -----------
+
+void GameMetrics::WriteJson(std::string &out) const {
+  Append(out, "{\"frames\":%llu,\"frame_interval\":",
+         (unsigned long long)Read(frames));
+  frameInterval.WriteJson(out);
+  out += ",\"frame_work\":";
+  frameWork.WriteJson(out);
+  Append(out,
+         ",\"entities\":%u,\"game_over\":%s,\"elapsed_s\":%.2f,"
+         "\"player_speed\":%.1f,",
+         Read(entities), Read(gameOver) ? "true" : "false",
+         Read(elapsedSeconds), Read(playerSpeed));
+  Append(out,
+         "\"input\":{\"applied\":%llu,\"dropped\":%llu,"
+         "\"latency_mean_ms\":%.2f},",
+         (unsigned long long)Read(inputsApplied),
+         (unsigned long long)Read(inputsDropped),
+         Read(inputLatencyMeanUs) / 1000.0);
+  Append(out, "\"timers\":{\"pending\":%u,\"fired\":%llu},",
+         Read(timersPending), (unsigned long long)Read(timersFired));
+  Append(out,
+         "\"sequences\":{\"running\":%u,\"frame_allocations\":%llu,"
+         "\"frame_pool_bytes\":%llu}}\n",
+         Read(sequencesRunning),
+         (unsigned long long)Read(framePoolAllocations),
+         (unsigned long long)Read(framePoolBytes));
+}
+
+// ----------- MetricsServer -----------
+
+#ifdef METRICS_SOCKETS
+// "unix:/path" (or a bare path) and "tcp:port"; -1 when malformed
+static int OpenEndpoint(const char *endpoint, bool listening,
+                        std::string &unixPath) {
+  if (strncmp(endpoint, "tcp:", 4) == 0) {
+    int port = atoi(endpoint + 4);
+    if (port <= 0 || port > 65535)
+      return -1;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+      return -1;
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t)port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Local only
+    int yes = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+    bool ok = listening
+                  ? bind(fd, (sockaddr *)&address, sizeof(address)) == 0 &&
+                        listen(fd, 8) == 0
+                  : connect(fd, (sockaddr *)&address, sizeof(address)) == 0;
+    if (!ok) {
+      close(fd);
+      return -1;
+    }
+    return fd;
+  }
+
+  const char *path =
+      strncmp(endpoint, "unix:", 5) == 0 ? endpoint + 5 : endpoint;
+  sockaddr_un address = {};
+  if (!*path || strlen(path) >= sizeof(address.sun_path))
+    return -1;
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, path);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+  if (listening)
+    unlink(path); // A previous run that crashed leaves the file behind
+  bool ok = listening
+                ? bind(fd, (sockaddr *)&address, sizeof(address)) == 0 &&
+                      listen(fd, 8) == 0
+                : connect(fd, (sockaddr *)&address, sizeof(address)) == 0;
+  if (!ok) {
+    close(fd);
+    return -1;
+  }
+  if (listening)
+    unixPath = path;
+  return fd;
+}
+#endif
+
+MetricsServer::MetricsServer(const GameMetrics &metrics)
+    : metrics(&metrics), listenFd(-1), running(false), served(0) {}
+
+MetricsServer::~MetricsServer() { Stop(); }
+
+bool MetricsServer::Start(const char *endpoint) {
+#ifdef METRICS_SOCKETS
+  Stop();
+  listenFd = OpenEndpoint(endpoint, true, unixPath);
+  if (listenFd < 0)
+    return false;
+  running = true;
+  thread = std::thread(&MetricsServer::Serve, this);
+  return true;
+#else
+  (void)endpoint;
+  return false;
+#endif
+}
+
+void MetricsServer::Stop() {
+#ifdef METRICS_SOCKETS
+  if (!running)
+    return;
+  running = false;
+  thread.join(); // Serve polls with a timeout, so it notices quickly
+  close(listenFd);
+  listenFd = -1;
+  if (!unixPath.empty()) {
+    unlink(unixPath.c_str());
+    unixPath.clear();
+  }
+#endif
+}
+
+void MetricsServer::Serve() {
+#ifdef METRICS_SOCKETS
+  std::string json;
+  json.reserve(4096);
+  while (running) {
+    pollfd waiting = {listenFd, POLLIN, 0};
+    if (poll(&waiting, 1, 100) <= 0)
+      continue;
+    int client = accept(listenFd, nullptr, nullptr);
+    if (client < 0)
+      continue;
+    // A client that stops reading can only hold up this thread, and only
+    // for a second
+    timeval timeout = {1, 0};
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+    int yes = 1;
+    setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes));
+#endif
+    json.clear();
+    metrics->WriteJson(json);
+    size_t sent = 0;
+    while (sent < json.size()) {
+      ssize_t n = send(client, json.data() + sent, json.size() - sent,
+                       MSG_NOSIGNAL);
+      if (n <= 0)
+        break;
+      sent += (size_t)n;
+    }
+    close(client);
+    served++;
+  }
+#endif
+}
+
+bool ScrapeMetrics(const char *endpoint, std::string &out) {
+  out.clear();
+#ifdef METRICS_SOCKETS
+  std::string unused;
+  int fd = OpenEndpoint(endpoint, false, unused);
+  if (fd < 0)
+    return false;
+  char buffer[4096];
+  ssize_t n;
+  while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+    out.append(buffer, (size_t)n);
+  }
+  close(fd);
+  return !out.empty();
+#else
+  (void)endpoint;
+  return false;
+#endif
+}
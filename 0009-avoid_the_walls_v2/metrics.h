@@ -0,0 +1,102 @@
+// metrics.h
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Metrics have one writer (the game thread) and any number of readers.
+// The writer never uses a locked read-modify-write: a relaxed load and
+// store is all a single writer needs, and readers only ever see whole
+// values (a scrape may mix two frames, never a torn number).
+template <typename T> inline void MetricAdd(std::atomic<T> &value, T by) {
+  value.store(value.load(std::memory_order_relaxed) + by,
+              std::memory_order_relaxed);
+}
+
+template <typename T> inline void MetricSet(std::atomic<T> &value, T to) {
+  value.store(to, std::memory_order_relaxed);
+}
+
+// ----------- MetricsHistogram -----------
+// Durations in 0.25 ms bins up to 50 ms (the last bin holds the rest)
+struct MetricsHistogram {
+  static const int binCount = 200;
+  static const uint64_t binNs = 250000;
+
+  std::atomic<uint32_t> bins[binCount]; // C++20 atomics start at zero
+  std::atomic<uint64_t> totalNs{0};
+  std::atomic<uint64_t> maxNs{0};
+
+  void Record(double seconds); // Writer only
+  void WriteJson(std::string &out) const;
+};
+
+// ----------- GameMetrics -----------
+// Manages: what the game loop publishes once per frame
+// Should Own:
+//   - Counters, gauges and frame time histograms as relaxed atomics
+// Should Not:
+//   - Block, allocate or know about sockets (MetricsServer reads it)
+//   - Be written by more than one thread
+struct GameMetrics {
+  std::atomic<uint64_t> frames{0};
+  MetricsHistogram frameInterval; // Start of one frame to the next
+  MetricsHistogram frameWork;     // Input, simulation and rendering
+
+  std::atomic<uint32_t> entities{0};
+  std::atomic<uint32_t> gameOver{0};
+  std::atomic<float> elapsedSeconds{0.0f};
+  std::atomic<float> playerSpeed{0.0f};
+
+  std::atomic<uint64_t> inputsApplied{0};
+  std::atomic<uint64_t> inputsDropped{0};
+  std::atomic<uint32_t> inputLatencyMeanUs{0};
+
+  std::atomic<uint32_t> timersPending{0};
+  std::atomic<uint64_t> timersFired{0};
+  std::atomic<uint32_t> sequencesRunning{0};
+  std::atomic<uint64_t> framePoolAllocations{0};
+  std::atomic<uint64_t> framePoolBytes{0};
+
+  void WriteJson(std::string &out) const; // Any thread
+};
+
+// ----------- MetricsServer -----------
+// Manages: a background thread that serves GameMetrics as JSON
+// Should Own:
+//   - The listening socket: a Unix domain socket ("unix:/path") or
+//     localhost TCP ("tcp:port")
+//   - One JSON document per connection, then closing it
+// Should Not:
+//   - Ever make the game thread wait (it only reads the atomics)
+//   - Listen on anything but the local machine
+class MetricsServer {
+public:
+  explicit MetricsServer(const GameMetrics &metrics);
+  ~MetricsServer(); // Stops the thread
+  MetricsServer(const MetricsServer &) = delete;
+  MetricsServer &operator=(const MetricsServer &) = delete;
+
+  // False if the endpoint is malformed, taken, or the platform has no
+  // sockets (web)
+  bool Start(const char *endpoint);
+  void Stop();
+  long long Served() const { return served.load(); }
+
+private:
+  const GameMetrics *metrics;
+  int listenFd;
+  std::string unixPath; // Removed again on Stop
+  std::atomic<bool> running;
+  std::atomic<long long> served;
+  std::thread thread;
+
+  void Serve();
+};
+
+// Connects to a MetricsServer endpoint and reads its JSON into 'out';
+// false if nothing answers
+bool ScrapeMetrics(const char *endpoint, std::string &out);
@@ -0,0 +1,49 @@
+// metrics_client.cpp
+//
+// Prints a running game's live metrics (the JSON its MetricsServer
+// serves). Start the game with AVOID_THE_WALLS_METRICS set, then:
+//
+// Usage: metrics_client [endpoint] [-w seconds]
+//   endpoint    "unix:/path" or "tcp:port"; defaults to the variable
+//   -w seconds  keep scraping at that interval
+
+#include "../constants.h"
+#include "../metrics.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+int main(int argc, char **argv) {
+  const char *endpoint = std::getenv(metricsEndpointVariable);
+  double interval = 0.0;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+      interval = atof(argv[++i]);
+    } else {
+      endpoint = argv[i];
+    }
+  }
+  if (!endpoint) {
+    printf("usage: metrics_client [unix:/path | tcp:port] [-w seconds]\n"
+           "       (or set %s)\n",
+           metricsEndpointVariable);
+    return 1;
+  }
+
+  std::string json;
+  do {
+    if (!ScrapeMetrics(endpoint, json)) {
+      printf("metrics_client: nothing answers at %s\n", endpoint);
+      return 1;
+    }
+    fputs(json.c_str(), stdout);
+    fflush(stdout);
+    if (interval > 0.0) {
+      std::this_thread::sleep_for(std::chrono::duration<double>(interval));
+    }
+  } while (interval > 0.0);
+  return 0;
+}
@@ -0,0 +1,574 @@
+// net.cpp
+
+#include "net.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+static const float netTickSeconds = 1.0f / 60.0f; // Both sides step at 60 Hz
+
+enum PacketType : uint8_t { PacketInput = 1, PacketSnapshot = 2 };
+
+static double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+uint8_t ReadNetKeys(const ScriptedInput &input) {
+  uint8_t keys = 0;
+  if (input.IsKeyPressed(KEY_W))
+    keys |= NetKeyUp;
+  if (input.IsKeyPressed(KEY_S))
+    keys |= NetKeyDown;
+  if (input.IsKeyPressed(KEY_A))
+    keys |= NetKeyLeft;
+  if (input.IsKeyPressed(KEY_D))
+    keys |= NetKeyRight;
+  if (input.IsKeyPressed(KEY_R))
+    keys |= NetKeyRestart;
+  return keys;
+}
+
+static void PressNetKeys(ScriptedInput &input, uint8_t keys) {
+  if (keys & NetKeyUp)
+    input.Press(KEY_W);
+  if (keys & NetKeyDown)
+    input.Press(KEY_S);
+  if (keys & NetKeyLeft)
+    input.Press(KEY_A);
+  if (keys & NetKeyRight)
+    input.Press(KEY_D);
+  if (keys & NetKeyRestart)
+    input.Press(KEY_R);
+}
+
+// ----------- BitWriter / BitReader -----------
+
+BitWriter::BitWriter(uint8_t *buffer, int capacity)
+    : buffer(buffer), capacity(capacity), bytes(0), scratch(0),
+      scratchBits(0), overflow(false) {}
+
+void BitWriter::Write(uint32_t value, int bits) {
+  uint64_t mask = bits == 32 ? 0xFFFFFFFFull : ((1ull << bits) - 1);
+  scratch |= ((uint64_t)value & mask) << scratchBits;
+  scratchBits += bits;
+  while (scratchBits >= 8) {
+    if (bytes < capacity) {
+      buffer[bytes++] = (uint8_t)scratch;
+    } else {
+      overflow = true;
+    }
+    scratch >>= 8;
+    scratchBits -= 8;
+  }
+}
+
+void BitWriter::WriteSigned(int32_t value) {
+  // Zigzag keeps small negative numbers small: 0, -1, 1, -2, ... -> 0, 1, 2
+  uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+  int length = zigzag ? 32 - __builtin_clz(zigzag) : 0;
+  Write(length, 6);
+  if (length)
+    Write(zigzag, length);
+}
+
+int BitWriter::Flush() {
+  if (scratchBits > 0)
+    Write(0, 8 - scratchBits);
+  return overflow ? 0 : bytes;
+}
+
+BitReader::BitReader(const uint8_t *buffer, int size)
+    : buffer(buffer), size(size), bytes(0), scratch(0), scratchBits(0),
+      overflow(false) {}
+
+uint32_t BitReader::Read(int bits) {
+  while (scratchBits < bits) {
+    if (bytes >= size) {
+      overflow = true;
+      return 0;
+    }
+    scratch |= (uint64_t)buffer[bytes++] << scratchBits;
+    scratchBits += 8;
+  }
+  uint64_t mask = bits == 32 ? 0xFFFFFFFFull : ((1ull << bits) - 1);
+  uint32_t value = (uint32_t)(scratch & mask);
+  scratch >>= bits;
+  scratchBits -= bits;
+  return value;
+}
+
+int32_t BitReader::ReadSigned() {
+  int length = (int)Read(6);
+  if (length > 32) {
+    overflow = true;
+    return 0;
+  }
+  uint32_t zigzag = length ? Read(length) : 0;
+  return (int32_t)((zigzag >> 1) ^ (0u - (zigzag & 1)));
+}
+
+// ----------- NetPlayer -----------
+
+static const Vector2 netDirections[4] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}};
+
+static int32_t Quantize(float value, float unitsPerOne) {
+  return (int32_t)lroundf(value * unitsPerOne);
+}
+
+NetPlayer CapturePlayer(const Game &game) {
+  const Player &player = game.entityManager.player;
+  const GameState &state = game.gameState;
+  NetPlayer s{};
+  s.x = Quantize(player.position.x, 256.0f);
+  s.y = Quantize(player.position.y, 256.0f);
+  s.speed = Quantize(player.speed, 4.0f);
+  s.dir = player.moveDir.y < 0   ? 0
+          : player.moveDir.y > 0 ? 1
+          : player.moveDir.x < 0 ? 2
+                                 : 3;
+  s.flags = NetFlagActive;
+  if (state.gameOver)
+    s.flags |= NetFlagGameOver;
+  if (state.countdownActive)
+    s.flags |= NetFlagCountdown;
+  s.countdown = Quantize(state.countdownTime, 960.0f);
+  s.elapsed = Quantize(state.elapsedTime, 960.0f);
+  s.rng = game.entityManager.RandomState();
+  return s;
+}
+
+void ApplyPlayer(const NetPlayer &s, Game &game) {
+  Player &player = game.entityManager.player;
+  GameState &state = game.gameState;
+  player.position = {s.x / 256.0f, s.y / 256.0f};
+  player.bounds.x = player.position.x;
+  player.bounds.y = player.position.y;
+  player.speed = s.speed / 4.0f;
+  player.moveDir = netDirections[s.dir & 3];
+  game.SyncRoundState(s.flags & NetFlagCountdown ? s.countdown / 960.0f : 0.0f,
+                      (s.flags & NetFlagGameOver) != 0);
+  state.elapsedTime = s.elapsed / 960.0f;
+  game.entityManager.SetRandomState(s.rng);
+}
+
+bool SamePlayer(const NetPlayer &a, const NetPlayer &b) {
+  return a.x == b.x && a.y == b.y && a.speed == b.speed && a.dir == b.dir &&
+         a.flags == b.flags && a.countdown == b.countdown &&
+         a.elapsed == b.elapsed && a.rng == b.rng;
+}
+
+// ----------- Snapshot -----------
+
+// Each field: one "changed" bit, then the new value (or its difference
+// from the baseline, which is small for values that move every tick)
+static void WriteDiff(BitWriter &w, int32_t value, int32_t base) {
+  w.Write(value != base, 1);
+  if (value != base)
+    w.WriteSigned((int32_t)((uint32_t)value - (uint32_t)base));
+}
+
+static int32_t ReadDiff(BitReader &r, int32_t base) {
+  if (!r.Read(1))
+    return base;
+  return (int32_t)((uint32_t)base + (uint32_t)r.ReadSigned());
+}
+
+static void EncodePlayer(BitWriter &w, const NetPlayer &p,
+                         const NetPlayer &b) {
+  bool changed = !SamePlayer(p, b) || p.lastInput != b.lastInput;
+  w.Write(changed, 1);
+  if (!changed)
+    return;
+  WriteDiff(w, p.x, b.x);
+  WriteDiff(w, p.y, b.y);
+  WriteDiff(w, p.speed, b.speed);
+  w.Write(p.dir, 2);
+  w.Write(p.flags, 3);
+  WriteDiff(w, p.countdown, b.countdown);
+  WriteDiff(w, p.elapsed, b.elapsed);
+  w.Write(p.rng != b.rng, 1);
+  if (p.rng != b.rng)
+    w.Write(p.rng, 32);
+  WriteDiff(w, (int32_t)p.lastInput, (int32_t)b.lastInput);
+}
+
+static void DecodePlayer(BitReader &r, NetPlayer &p, const NetPlayer &b) {
+  p = b;
+  if (!r.Read(1))
+    return;
+  p.x = ReadDiff(r, b.x);
+  p.y = ReadDiff(r, b.y);
+  p.speed = ReadDiff(r, b.speed);
+  p.dir = (uint8_t)r.Read(2);
+  p.flags = (uint8_t)r.Read(3);
+  p.countdown = ReadDiff(r, b.countdown);
+  p.elapsed = ReadDiff(r, b.elapsed);
+  if (r.Read(1))
+    p.rng = r.Read(32);
+  p.lastInput = (uint32_t)ReadDiff(r, (int32_t)b.lastInput);
+}
+
+int EncodeSnapshot(const Snapshot &snapshot, const Snapshot *baseline,
+                   uint8_t *out, int capacity) {
+  static const Snapshot empty{};
+  const Snapshot &base = baseline ? *baseline : empty;
+  BitWriter w(out, capacity);
+  w.Write(PacketSnapshot, 8);
+  w.Write(snapshot.tick, 32);
+  w.Write(baseline ? baseline->tick : 0, 32); // 0: no baseline
+  for (int i = 0; i < maxNetClients; ++i) {
+    EncodePlayer(w, snapshot.players[i], base.players[i]);
+  }
+  return w.Flush();
+}
+
+bool DecodeSnapshot(const uint8_t *data, int size, const Snapshot *baselines,
+                    Snapshot &out) {
+  static const Snapshot empty{};
+  BitReader r(data, size);
+  if (r.Read(8) != PacketSnapshot)
+    return false;
+  uint32_t tick = r.Read(32);
+  uint32_t baseTick = r.Read(32);
+  const Snapshot *base = &empty;
+  if (baseTick) {
+    base = &baselines[baseTick % snapshotHistory];
+    if (base->tick != baseTick)
+      return false; // Baseline already overwritten
+  }
+  Snapshot decoded;
+  decoded.tick = tick;
+  for (int i = 0; i < maxNetClients; ++i) {
+    DecodePlayer(r, decoded.players[i], base->players[i]);
+  }
+  if (r.Overflowed())
+    return false;
+  out = decoded;
+  return true;
+}
+
+// ----------- UdpSocket -----------
+
+sockaddr_in LoopbackAddress(uint16_t port) {
+  sockaddr_in address;
+  std::memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  return address;
+}
+
+UdpSocket::UdpSocket() : fd(-1), port(0) {}
+
+UdpSocket::~UdpSocket() {
+  if (fd >= 0)
+    close(fd);
+}
+
+bool UdpSocket::Open(uint16_t wantedPort) {
+  fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0)
+    return false;
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+
+  sockaddr_in address = LoopbackAddress(wantedPort);
+  if (bind(fd, (sockaddr *)&address, sizeof(address)) != 0)
+    return false;
+  socklen_t length = sizeof(address);
+  getsockname(fd, (sockaddr *)&address, &length);
+  port = ntohs(address.sin_port);
+  return true;
+}
+
+bool UdpSocket::Send(const sockaddr_in &to, const uint8_t *data, int size) {
+  return sendto(fd, data, size, 0, (const sockaddr *)&to, sizeof(to)) ==
+         size;
+}
+
+int UdpSocket::Receive(sockaddr_in &from, uint8_t *data, int capacity) {
+  socklen_t length = sizeof(from);
+  ssize_t size = recvfrom(fd, data, capacity, 0, (sockaddr *)&from, &length);
+  return size < 0 ? -1 : (int)size;
+}
+
+// ----------- LinkSimulator -----------
+
+LinkSimulator::LinkSimulator(UdpSocket &socket,
+                             const LinkConditions &conditions, uint32_t seed)
+    : socket(&socket), conditions(conditions), rng(seed ? seed : 1),
+      bytesSent(0), packetsSent(0), packetsLost(0) {
+  pending.reserve(64);
+}
+
+float LinkSimulator::Random01() {
+  rng ^= rng << 13;
+  rng ^= rng >> 17;
+  rng ^= rng << 5;
+  return (rng >> 8) * (1.0f / 16777216.0f);
+}
+
+void LinkSimulator::Send(const sockaddr_in &to, const uint8_t *data, int size,
+                         double now) {
+  if (size <= 0 || size > maxPacketSize)
+    return;
+  bytesSent += size;
+  packetsSent++;
+  if (Random01() * 100.0f < conditions.lossPercent) {
+    packetsLost++;
+    return;
+  }
+  pending.emplace_back();
+  Pending &packet = pending.back();
+  packet.due =
+      now + (conditions.latencyMs + Random01() * conditions.jitterMs) / 1000.0;
+  packet.to = to;
+  packet.size = size;
+  std::memcpy(packet.data, data, size);
+}
+
+void LinkSimulator::Flush(double now) {
+  size_t kept = 0;
+  for (size_t i = 0; i < pending.size(); ++i) {
+    if (pending[i].due <= now) {
+      socket->Send(pending[i].to, pending[i].data, pending[i].size);
+    } else {
+      if (kept != i)
+        pending[kept] = pending[i];
+      kept++;
+    }
+  }
+  pending.resize(kept);
+}
+
+// ----------- NetServer -----------
+
+NetServer::NetServer(const LinkConditions &conditions, int snapshotInterval,
+                     uint32_t seed)
+    : socket(), link(socket, conditions, seed),
+      snapshotInterval(snapshotInterval > 0 ? snapshotInterval : 1), tick(0),
+      history{}, snapshotsSent(0), deltaSnapshots(0), encodeSeconds(0.0) {}
+
+bool NetServer::Open(uint16_t port) { return socket.Open(port); }
+
+long long NetServer::BytesSentTo(int client) const {
+  return clients[client] ? clients[client]->bytesSent : 0;
+}
+
+void NetServer::Receive() {
+  uint8_t data[maxPacketSize];
+  sockaddr_in from;
+  int size;
+  while ((size = socket.Receive(from, data, sizeof(data))) >= 0) {
+    BitReader r(data, size);
+    if (r.Read(8) != PacketInput)
+      continue;
+    int id = (int)r.Read(8);
+    uint32_t ack = r.Read(32);
+    uint32_t newest = r.Read(32);
+    int count = (int)r.Read(8);
+    if (r.Overflowed() || id >= maxNetClients || count > inputRedundancy)
+      continue;
+
+    if (!clients[id]) {
+      // First packet from this slot: it joins with a fresh game
+      clients[id].reset(new Client());
+      Client &joined = *clients[id];
+      joined.game.reset(new Game(joined.input, 0x9E3779B9u * (id + 1)));
+      joined.connected = true;
+    }
+    Client &client = *clients[id];
+    client.address = from;
+    if (ack > client.ackedTick && ack <= tick)
+      client.ackedTick = ack;
+
+    for (int k = 0; k < count; ++k) {
+      uint32_t inputTick = newest - k;
+      uint8_t keys = (uint8_t)r.Read(5);
+      if (r.Overflowed() || inputTick < client.nextInput ||
+          inputTick >= client.nextInput + inputHistory)
+        continue;
+      client.keys[inputTick % inputHistory] = keys;
+      client.keyTick[inputTick % inputHistory] = inputTick;
+    }
+  }
+}
+
+void NetServer::StepClient(Client &client) {
+  PressNetKeys(client.input, client.keys[client.nextInput % inputHistory]);
+  client.game->tickCount = client.nextInput; // Traces by input tick
+  client.game->Step(netTickSeconds);
+  client.input.Clear();
+  // Snap to wire units so the client's replay matches bit for bit
+  ApplyPlayer(CapturePlayer(*client.game), *client.game);
+  client.nextInput++;
+}
+
+void NetServer::Tick(double now) {
+  Receive();
+  tick++;
+
+  // Inputs are applied in client tick order; a late client simply stalls
+  // and then catches up a few ticks at a time
+  for (std::unique_ptr<Client> &client : clients) {
+    if (!client)
+      continue;
+    for (int n = 0; n < maxInputsPerTick; ++n) {
+      uint32_t next = client->nextInput;
+      if (client->keyTick[next % inputHistory] != next)
+        break;
+      StepClient(*client);
+    }
+  }
+
+  if (tick % snapshotInterval == 0)
+    SendSnapshots(now);
+  link.Flush(now);
+}
+
+void NetServer::SendSnapshots(double now) {
+  Snapshot &snapshot = history[tick % snapshotHistory];
+  snapshot.tick = tick;
+  for (int i = 0; i < maxNetClients; ++i) {
+    NetPlayer &player = snapshot.players[i];
+    player = NetPlayer{};
+    if (clients[i]) {
+      player = CapturePlayer(*clients[i]->game);
+      player.lastInput = clients[i]->nextInput - 1;
+    }
+  }
+
+  uint8_t data[maxPacketSize];
+  for (std::unique_ptr<Client> &client : clients) {
+    if (!client)
+      continue;
+    // Delta against the newest snapshot the client confirmed, if we still
+    // have it; otherwise send everything
+    const Snapshot *baseline = nullptr;
+    uint32_t acked = client->ackedTick;
+    if (acked && tick - acked < (uint32_t)snapshotHistory &&
+        history[acked % snapshotHistory].tick == acked)
+      baseline = &history[acked % snapshotHistory];
+
+    Clock::time_point start = Clock::now();
+    int size = EncodeSnapshot(snapshot, baseline, data, sizeof(data));
+    encodeSeconds += SecondsSince(start);
+    if (size == 0)
+      continue;
+
+    link.Send(client->address, data, size, now);
+    client->bytesSent += size;
+    snapshotsSent++;
+    if (baseline)
+      deltaSnapshots++;
+  }
+}
+
+// ----------- NetClient -----------
+
+NetClient::NetClient(int id, const LinkConditions &conditions, uint32_t seed)
+    : id(id), socket(), link(socket, conditions, seed), input(),
+      game(new Game(input, seed)), tick(0), keys{}, predicted{}, received{},
+      latest{}, synced(false), bytesReceived(0), snapshotsReceived(0),
+      mispredictions(0), decodeSeconds(0.0), reconcileSeconds(0.0) {}
+
+bool NetClient::Open(uint16_t serverPort) {
+  server = LoopbackAddress(serverPort);
+  return socket.Open(0);
+}
+
+void NetClient::Tick(uint8_t tickKeys, double now) {
+  Receive();
+  tick++;
+  keys[tick % inputHistory] = tickKeys;
+
+  // Resend the newest few inputs every time, so one lost packet costs
+  // nothing; the server drops the ones it already has
+  uint8_t data[maxPacketSize];
+  BitWriter w(data, sizeof(data));
+  int count = tick < (uint32_t)inputRedundancy ? (int)tick : inputRedundancy;
+  w.Write(PacketInput, 8);
+  w.Write(id, 8);
+  w.Write(latest.tick, 32);
+  w.Write(tick, 32);
+  w.Write(count, 8);
+  for (int k = 0; k < count; ++k) {
+    w.Write(keys[(tick - k) % inputHistory], 5);
+  }
+  link.Send(server, data, w.Flush(), now);
+
+  game->tickCount = tick; // Traces match the server's for the same input
+  Predict(tickKeys);
+  predicted[tick % inputHistory] = CapturePlayer(*game);
+  link.Flush(now);
+}
+
+void NetClient::Predict(uint8_t tickKeys) {
+  PressNetKeys(input, tickKeys);
+  game->Step(netTickSeconds);
+  input.Clear();
+  ApplyPlayer(CapturePlayer(*game), *game);
+}
+
+void NetClient::Receive() {
+  uint8_t data[maxPacketSize];
+  sockaddr_in from;
+  int size;
+  while ((size = socket.Receive(from, data, sizeof(data))) >= 0) {
+    bytesReceived += size;
+    Decode(data, size);
+  }
+}
+
+bool NetClient::Decode(const uint8_t *data, int size) {
+  Clock::time_point start = Clock::now();
+  Snapshot snapshot;
+  bool ok = DecodeSnapshot(data, size, received, snapshot);
+  decodeSeconds += SecondsSince(start);
+  if (!ok)
+    return false;
+
+  // Keep it as a future baseline unless a newer one owns the slot
+  Snapshot &slot = received[snapshot.tick % snapshotHistory];
+  if (snapshot.tick > slot.tick)
+    slot = snapshot;
+  snapshotsReceived++;
+
+  if (snapshot.tick > latest.tick) {
+    latest = snapshot;
+    start = Clock::now();
+    Reconcile(snapshot.players[id]);
+    reconcileSeconds += SecondsSince(start);
+  }
+  return true;
+}
+
+void NetClient::Reconcile(const NetPlayer &own) {
+  if (!(own.flags & NetFlagActive))
+    return;
+  uint32_t applied = own.lastInput;
+  if (applied > tick)
+    return; // Cannot happen unless packets are forged
+
+  if (synced && applied > 0 && tick - applied < (uint32_t)inputHistory &&
+      !SamePlayer(predicted[applied % inputHistory], own)) {
+    mispredictions++;
+  }
+
+  // Rewind to the server's state, then replay what it has not seen yet
+  ApplyPlayer(own, *game);
+  uint32_t first = applied + 1;
+  if (tick - applied >= (uint32_t)inputHistory)
+    first = tick - inputHistory + 1;
+  game->tickCount = first; // Replayed ticks trace again, under their number
+  for (uint32_t t = first; t <= tick; ++t) {
+    Predict(keys[t % inputHistory]);
+    predicted[t % inputHistory] = CapturePlayer(*game);
+  }
+  synced = true;
+}
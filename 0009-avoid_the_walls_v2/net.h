@@ -0,0 +1,269 @@
+// net.h
+
+#pragma once
+
+#include "game.h"
+#include <cstdint>
+#include <memory>
+#include <netinet/in.h>
+#include <vector>
+
+const int maxNetClients = 4;
+const int snapshotHistory = 64; // Snapshots kept as delta baselines
+const int inputHistory = 128;   // Client input ticks kept for replay
+const int inputRedundancy = 8;  // Newest inputs repeated in every packet
+const int maxPacketSize = 1200;
+const int maxInputsPerTick = 3; // Server catch-up after a late packet
+
+// Input bits, one byte per client tick
+enum NetKey : uint8_t {
+  NetKeyUp = 1 << 0,
+  NetKeyDown = 1 << 1,
+  NetKeyLeft = 1 << 2,
+  NetKeyRight = 1 << 3,
+  NetKeyRestart = 1 << 4,
+};
+
+uint8_t ReadNetKeys(const ScriptedInput &input); // Packs W/S/A/D/R presses
+
+// ----------- BitWriter / BitReader -----------
+// Packs values into a byte buffer with no padding between them
+class BitWriter {
+public:
+  BitWriter(uint8_t *buffer, int capacity);
+  void Write(uint32_t value, int bits); // 1-32 bits
+  void WriteSigned(int32_t value);      // Zigzag, 6-bit length, then bits
+  int Flush();                          // Returns bytes used
+  bool Overflowed() const { return overflow; }
+
+private:
+  uint8_t *buffer;
+  int capacity;
+  int bytes;
+  uint64_t scratch;
+  int scratchBits;
+  bool overflow;
+};
+
+class BitReader {
+public:
+  BitReader(const uint8_t *buffer, int size);
+  uint32_t Read(int bits);
+  int32_t ReadSigned();
+  bool Overflowed() const { return overflow; }
+
+private:
+  const uint8_t *buffer;
+  int size;
+  int bytes;
+  uint64_t scratch;
+  int scratchBits;
+  bool overflow;
+};
+
+// ----------- NetPlayer -----------
+// One player's game state in wire units. Both sides snap their simulation
+// to these units after every tick, so the client's prediction replays
+// exactly what the server computed.
+struct NetPlayer {
+  int32_t x, y;       // Position in 1/256 px
+  int32_t speed;      // px/sec in 1/4 units
+  uint8_t dir;        // 0 up, 1 down, 2 left, 3 right
+  uint8_t flags;      // NetFlag bits
+  int32_t countdown;  // Countdown left in 1/960 s
+  int32_t elapsed;    // Run time in 1/960 s
+  uint32_t rng;       // EntityManager random state (restart direction)
+  uint32_t lastInput; // Newest client input tick the server applied
+};
+
+enum NetFlag : uint8_t {
+  NetFlagActive = 1 << 0, // Slot has a connected client
+  NetFlagGameOver = 1 << 1,
+  NetFlagCountdown = 1 << 2,
+};
+
+NetPlayer CapturePlayer(const Game &game);
+void ApplyPlayer(const NetPlayer &state, Game &game);
+bool SamePlayer(const NetPlayer &a, const NetPlayer &b); // Ignores lastInput
+
+// ----------- Snapshot -----------
+struct Snapshot {
+  uint32_t tick;
+  NetPlayer players[maxNetClients];
+};
+
+// Writes 'snapshot' as changes against 'baseline' (nullptr = full state).
+// Returns the payload size, or 0 if it did not fit.
+int EncodeSnapshot(const Snapshot &snapshot, const Snapshot *baseline,
+                   uint8_t *out, int capacity);
+// Reads a snapshot packet; its baseline is looked up in 'baselines' (a ring
+// of snapshotHistory entries indexed by tick). False if the packet is
+// malformed or its baseline is gone.
+bool DecodeSnapshot(const uint8_t *data, int size, const Snapshot *baselines,
+                    Snapshot &out);
+
+// ----------- UdpSocket -----------
+// Manages: one non-blocking UDP socket on 127.0.0.1
+class UdpSocket {
+public:
+  UdpSocket();
+  ~UdpSocket();
+  UdpSocket(const UdpSocket &) = delete;
+  UdpSocket &operator=(const UdpSocket &) = delete;
+
+  bool Open(uint16_t port); // 0 picks a free port
+  uint16_t Port() const { return port; }
+  bool Send(const sockaddr_in &to, const uint8_t *data, int size);
+  int Receive(sockaddr_in &from, uint8_t *data, int capacity); // -1: none
+
+private:
+  int fd;
+  uint16_t port;
+};
+
+sockaddr_in LoopbackAddress(uint16_t port);
+
+// ----------- LinkSimulator -----------
+// Manages: outgoing packets delayed and dropped like a real network
+// Should Own:
+//   - Latency with jitter and random loss, on the caller's clock
+//   - Byte and packet counters for what the sender put on the wire
+// Should Not:
+//   - Reorder on purpose (jitter can still reorder, like the internet)
+struct LinkConditions {
+  float latencyMs = 0.0f; // One way
+  float jitterMs = 0.0f;  // Added uniformly in [0, jitterMs]
+  float lossPercent = 0.0f;
+};
+
+class LinkSimulator {
+public:
+  LinkSimulator(UdpSocket &socket, const LinkConditions &conditions,
+                uint32_t seed);
+  void Send(const sockaddr_in &to, const uint8_t *data, int size, double now);
+  void Flush(double now); // Puts every packet that is due on the socket
+
+  long long BytesSent() const { return bytesSent; }
+  long long PacketsSent() const { return packetsSent; }
+  long long PacketsLost() const { return packetsLost; }
+
+private:
+  struct Pending {
+    double due;
+    sockaddr_in to;
+    int size;
+    uint8_t data[maxPacketSize];
+  };
+
+  UdpSocket *socket;
+  LinkConditions conditions;
+  uint32_t rng;
+  std::vector<Pending> pending;
+  long long bytesSent;
+  long long packetsSent;
+  long long packetsLost;
+
+  float Random01();
+};
+
+// ----------- NetServer -----------
+// Manages: the authoritative simulation for every connected client
+// Should Own:
+//   - One headless Game per client slot, stepped once per received input
+//   - Snapshot history, per-client acknowledged baselines and delta sends
+//   - Encode timing and per-client bandwidth counters
+// Should Not:
+//   - Predict, render or read the keyboard
+class NetServer {
+public:
+  NetServer(const LinkConditions &link, int snapshotInterval, uint32_t seed);
+  bool Open(uint16_t port);
+  uint16_t Port() const { return socket.Port(); }
+
+  // Receives inputs, advances each client's game and sends snapshots
+  void Tick(double now);
+
+  long long BytesSentTo(int client) const;
+  long long SnapshotsSent() const { return snapshotsSent; }
+  long long DeltaSnapshots() const { return deltaSnapshots; }
+  double EncodeSeconds() const { return encodeSeconds; }
+  const LinkSimulator &Link() const { return link; }
+
+private:
+  struct Client {
+    bool connected = false;
+    sockaddr_in address;
+    ScriptedInput input;
+    std::unique_ptr<Game> game;
+    uint32_t nextInput = 1;       // Next client tick to apply
+    uint32_t ackedTick = 0;       // Newest snapshot the client has
+    uint8_t keys[inputHistory] = {}; // Received inputs by tick
+    uint32_t keyTick[inputHistory] = {};
+    long long bytesSent = 0;
+  };
+
+  UdpSocket socket;
+  LinkSimulator link;
+  int snapshotInterval;
+  uint32_t tick;
+  std::unique_ptr<Client> clients[maxNetClients];
+  Snapshot history[snapshotHistory];
+  long long snapshotsSent;
+  long long deltaSnapshots;
+  double encodeSeconds;
+
+  void Receive();
+  void StepClient(Client &client);
+  void SendSnapshots(double now);
+};
+
+// ----------- NetClient -----------
+// Manages: one player's connection, with client-side prediction
+// Should Own:
+//   - A predicted Game that applies local input right away
+//   - Input history, redundantly resent until the server applies it
+//   - Decoding snapshots against stored baselines and acknowledging them
+//   - Reconciling: rewind to the server state, replay unapplied inputs
+// Should Not:
+//   - Decide game outcomes (the server's snapshot always wins)
+class NetClient {
+public:
+  NetClient(int id, const LinkConditions &link, uint32_t seed);
+  bool Open(uint16_t serverPort);
+
+  // Receives snapshots, then sends and predicts this tick's keys
+  void Tick(uint8_t keys, double now);
+
+  const Game &Predicted() const { return *game; }
+  const Snapshot &Latest() const { return latest; }
+  long long BytesSent() const { return link.BytesSent(); }
+  long long BytesReceived() const { return bytesReceived; }
+  long long SnapshotsReceived() const { return snapshotsReceived; }
+  long long Mispredictions() const { return mispredictions; }
+  double DecodeSeconds() const { return decodeSeconds; }
+  double ReconcileSeconds() const { return reconcileSeconds; }
+
+private:
+  int id;
+  UdpSocket socket;
+  LinkSimulator link;
+  sockaddr_in server;
+  ScriptedInput input;
+  std::unique_ptr<Game> game;
+  uint32_t tick;
+  uint8_t keys[inputHistory];
+  NetPlayer predicted[inputHistory]; // State after each input tick
+  Snapshot received[snapshotHistory];
+  Snapshot latest;
+  bool synced; // Has applied at least one server state
+  long long bytesReceived;
+  long long snapshotsReceived;
+  long long mispredictions;
+  double decodeSeconds;
+  double reconcileSeconds;
+
+  void Receive();
+  bool Decode(const uint8_t *data, int size);
+  void Reconcile(const NetPlayer &own);
+  void Predict(uint8_t keys);
+};
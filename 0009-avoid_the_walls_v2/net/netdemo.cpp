@@ -0,0 +1,103 @@
+// netdemo.cpp
+//
+// Loopback netcode test for Avoid the Walls: one authoritative server and
+// several bot clients exchange real UDP packets on 127.0.0.1, with
+// simulated latency, jitter and loss, on a virtual 60 Hz clock (runs
+// faster than real time). Reports bandwidth per client, snapshot sizes,
+// CPU per snapshot and prediction errors.
+//
+// Usage: netdemo [seconds] [latencyMs] [jitterMs] [lossPercent]
+//                [snapshotInterval] [clients]
+
+#include "../net.h"
+#include "../session_host.h"
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char **argv) {
+  float seconds = argc > 1 ? (float)atof(argv[1]) : 60.0f;
+  LinkConditions link;
+  link.latencyMs = argc > 2 ? (float)atof(argv[2]) : 50.0f;
+  link.jitterMs = argc > 3 ? (float)atof(argv[3]) : 10.0f;
+  link.lossPercent = argc > 4 ? (float)atof(argv[4]) : 5.0f;
+  int interval = argc > 5 ? atoi(argv[5]) : 3;
+  int clientCount = argc > 6 ? atoi(argv[6]) : 2;
+  if (clientCount < 1 || clientCount > maxNetClients)
+    clientCount = 2;
+
+  NetServer server(link, interval, 1);
+  if (!server.Open(0)) {
+    fprintf(stderr, "netdemo: cannot open server socket\n");
+    return 1;
+  }
+
+  NetClient *clients[maxNetClients];
+  SessionBot *bots[maxNetClients];
+  ScriptedInput intents[maxNetClients];
+  for (int i = 0; i < clientCount; ++i) {
+    clients[i] = new NetClient(i, link, 1000 + i);
+    bots[i] = new SessionBot(0.2f + 0.1f * i);
+    if (!clients[i]->Open(server.Port())) {
+      fprintf(stderr, "netdemo: cannot open client socket\n");
+      return 1;
+    }
+  }
+
+  printf("%d clients, %.0f ms +0-%.0f ms one way, %.1f%% loss, "
+         "snapshot every %d ticks, %.0f s\n",
+         clientCount, link.latencyMs, link.jitterMs, link.lossPercent,
+         interval, seconds);
+
+  int ticks = (int)(seconds * 60.0f);
+  for (int t = 0; t < ticks; ++t) {
+    double now = t / 60.0;
+    for (int i = 0; i < clientCount; ++i) {
+      // The bot plays on the predicted game, like a player watching it
+      bots[i]->Think(clients[i]->Predicted(), intents[i]);
+      clients[i]->Tick(ReadNetKeys(intents[i]), now);
+      intents[i].Clear();
+    }
+    server.Tick(now);
+  }
+
+  printf("%-6s %10s %10s %9s %9s %12s\n", "client", "down kbps", "up kbps",
+         "snapshots", "avg bytes", "mispredicts");
+  long long received = 0;
+  double decodeSeconds = 0.0, reconcileSeconds = 0.0;
+  for (int i = 0; i < clientCount; ++i) {
+    NetClient &c = *clients[i];
+    long long down = server.BytesSentTo(i);
+    printf("%-6d %10.2f %10.2f %9lld %9.1f %12lld\n", i,
+           down * 8.0 / seconds / 1000.0,
+           c.BytesSent() * 8.0 / seconds / 1000.0,
+           c.SnapshotsReceived(),
+           c.SnapshotsReceived() ? (double)c.BytesReceived() /
+                                       c.SnapshotsReceived()
+                                 : 0.0,
+           c.Mispredictions());
+    received += c.SnapshotsReceived();
+    decodeSeconds += c.DecodeSeconds();
+    reconcileSeconds += c.ReconcileSeconds();
+  }
+
+  uint8_t scratch[maxPacketSize];
+  int fullBytes = EncodeSnapshot(clients[0]->Latest(), nullptr, scratch,
+                                 sizeof(scratch));
+  printf("full snapshot %d bytes; %lld of %lld sent as deltas; "
+         "%lld of %lld server packets lost\n",
+         fullBytes, server.DeltaSnapshots(), server.SnapshotsSent(),
+         server.Link().PacketsLost(), server.Link().PacketsSent());
+  printf("encode %.0f ns/snapshot, decode %.0f ns/snapshot, "
+         "reconcile %.0f ns/snapshot\n",
+         server.SnapshotsSent() ? server.EncodeSeconds() * 1e9 /
+                                      server.SnapshotsSent()
+                                : 0.0,
+         received ? decodeSeconds * 1e9 / received : 0.0,
+         received ? reconcileSeconds * 1e9 / received : 0.0);
+
+  for (int i = 0; i < clientCount; ++i) {
+    delete clients[i];
+    delete bots[i];
+  }
+  return 0;
+}
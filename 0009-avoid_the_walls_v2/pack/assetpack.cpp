@@ -0,0 +1,91 @@
+// assetpack.cpp
+//
+// Bundles sounds, images and fonts into one pack for AssetPack, decoded
+// ahead of time so the game only maps the file at startup.
+//
+// Usage: assetpack [-s fontSize] out.pak files...
+//   .wav .ogg .mp3 .flac .qoa        decoded PCM
+//   .png .bmp .tga .jpg .gif .qoi    RGBA8 pixels
+//   .ttf .otf                        ASCII glyphs baked into an atlas
+// Assets are named after the file (without its directory).
+
+#include "../asset_pack.h"
+#include "raylib.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char *BaseName(const char *path) {
+  const char *slash = strrchr(path, '/');
+  return slash ? slash + 1 : path;
+}
+
+static bool AddFile(AssetPackWriter &writer, const char *path,
+                    int fontSize) {
+  const char *name = BaseName(path);
+  if (IsFileExtension(path, ".wav;.ogg;.mp3;.flac;.qoa")) {
+    Wave wave = LoadWave(path);
+    bool added = writer.AddWave(name, wave);
+    UnloadWave(wave);
+    return added;
+  }
+  if (IsFileExtension(path, ".png;.bmp;.tga;.jpg;.gif;.qoi")) {
+    Image image = LoadImage(path);
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+    bool added = writer.AddImage(name, image);
+    UnloadImage(image);
+    return added;
+  }
+  if (IsFileExtension(path, ".ttf;.otf")) {
+    int dataSize = 0;
+    unsigned char *data = LoadFileData(path, &dataSize);
+    if (!data)
+      return false;
+    const int glyphCount = 95; // ASCII 32..126, what DrawText uses
+    GlyphInfo *glyphs = LoadFontData(data, dataSize, fontSize, nullptr,
+                                     glyphCount, FONT_DEFAULT);
+    bool added = false;
+    if (glyphs) {
+      Rectangle *recs = nullptr;
+      Image atlas =
+          GenImageFontAtlas(glyphs, &recs, glyphCount, fontSize, 4, 0);
+      added =
+          writer.AddFont(name, fontSize, glyphs, recs, glyphCount, atlas);
+      UnloadImage(atlas);
+      MemFree(recs);
+      UnloadFontData(glyphs, glyphCount);
+    }
+    UnloadFileData(data);
+    return added;
+  }
+  return false;
+}
+
+int main(int argc, char **argv) {
+  int fontSize = 32;
+  int first = 1;
+  if (argc > 2 && strcmp(argv[1], "-s") == 0) {
+    fontSize = atoi(argv[2]);
+    first = 3;
+  }
+  if (argc - first < 2 || fontSize <= 0) {
+    printf("usage: assetpack [-s fontSize] out.pak files...\n");
+    return 1;
+  }
+
+  SetTraceLogLevel(LOG_WARNING);
+  AssetPackWriter writer;
+  for (int i = first + 1; i < argc; ++i) {
+    if (!AddFile(writer, argv[i], fontSize)) {
+      printf("assetpack: can't add %s\n", argv[i]);
+      return 1;
+    }
+  }
+  if (!writer.Write(argv[first])) {
+    printf("assetpack: can't write %s\n", argv[first]);
+    return 1;
+  }
+  printf("%s: %d assets, %.1f KiB of payload\n", argv[first], writer.Count(),
+         writer.PayloadBytes() / 1024.0);
+  return 0;
+}
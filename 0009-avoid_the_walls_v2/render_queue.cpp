@@ -0,0 +1,244 @@
+// render_queue.cpp
+
+#include "render_queue.h"
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+RenderSortItem *RadixSortRenderItems(RenderSortItem *items,
+                                     RenderSortItem *scratch, size_t count) {
+  if (count < 64) {
+    // A HUD's worth: insertion sort, stable too, without the tables
+    for (size_t i = 1; i < count; ++i) {
+      RenderSortItem item = items[i];
+      size_t j = i;
+      for (; j > 0 && items[j - 1].key > item.key; --j)
+        items[j] = items[j - 1];
+      items[j] = item;
+    }
+    return items;
+  }
+
+  // Only bits that differ between keys need sorting on. Digits are up to
+  // 11 bits wide, each starting at the lowest varying bit the ones before
+  // it left, so a frame using a few layers, textures and depths sorts in
+  // a few passes.
+  uint64_t any = 0, all = ~(uint64_t)0;
+  for (size_t i = 0; i < count; ++i) {
+    any |= items[i].key;
+    all &= items[i].key;
+  }
+  uint64_t varying = any ^ all;
+  const int digitBits = 11;
+  const int maxPasses = (64 + digitBits - 1) / digitBits;
+  int shifts[maxPasses];
+  int passCount = 0;
+  while (varying) {
+    int shift = __builtin_ctzll(varying);
+    shifts[passCount++] = shift;
+    varying = shift + digitBits < 64 ? varying >> (shift + digitBits)
+                                           << (shift + digitBits)
+                                     : 0;
+  }
+
+  // Every digit's histogram in one pass over the keys
+  const uint64_t mask = (1u << digitBits) - 1;
+  static thread_local uint32_t counts[maxPasses][1 << digitBits];
+  memset(counts, 0, sizeof(counts[0]) * passCount);
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t key = items[i].key;
+    for (int p = 0; p < passCount; ++p) {
+      counts[p][(key >> shifts[p]) & mask]++;
+    }
+  }
+
+  RenderSortItem *from = items;
+  RenderSortItem *to = scratch;
+  for (int p = 0; p < passCount; ++p) {
+    uint32_t *bucket = counts[p];
+    uint32_t offset = 0;
+    for (int b = 0; b < (1 << digitBits); ++b) {
+      uint32_t n = bucket[b];
+      bucket[b] = offset;
+      offset += n;
+    }
+    int shift = shifts[p];
+    for (size_t i = 0; i < count; ++i) {
+      to[bucket[(from[i].key >> shift) & mask]++] = from[i];
+    }
+    std::swap(from, to);
+  }
+  return from;
+}
+
+// ----------- RenderQueue -----------
+
+RenderQueue::RenderQueue() : shaders{}, hasShader{} {}
+
+void RenderQueue::Clear() {
+  commands.clear();
+  items.clear();
+  text.clear();
+}
+
+void RenderQueue::Reserve(size_t commandCount, size_t textBytes) {
+  commands.reserve(commandCount);
+  items.reserve(commandCount);
+  scratch.reserve(commandCount);
+  text.reserve(textBytes);
+}
+
+void RenderQueue::Push(uint64_t key, const RenderCommand &command) {
+  items.push_back({key, (uint32_t)commands.size()});
+  commands.push_back(command);
+}
+
+void RenderQueue::PushRectangle(RenderLayer layer, uint32_t depth,
+                                Rectangle rect, Color color) {
+  RenderCommand command = {};
+  command.rect = rect;
+  command.color = color;
+  command.primitive = PrimitiveRectangle;
+  Push(MakeRenderKey(layer, depth, 0, renderShapesTexture, PrimitiveRectangle),
+       command);
+}
+
+void RenderQueue::PushCircle(RenderLayer layer, uint32_t depth,
+                             Vector2 centre, float radius, Color color) {
+  RenderCommand command = {};
+  command.rect = {centre.x, centre.y, radius, radius};
+  command.color = color;
+  command.primitive = PrimitiveCircle;
+  Push(MakeRenderKey(layer, depth, 0, renderShapesTexture, PrimitiveCircle),
+       command);
+}
+
+void RenderQueue::PushText(RenderLayer layer, uint32_t depth,
+                           const char *string, int x, int y, int fontSize,
+                           Color color) {
+  RenderCommand command = {};
+  command.rect = {(float)x, (float)y, 0.0f, (float)fontSize};
+  command.color = color;
+  command.text = (uint32_t)text.size();
+  command.primitive = PrimitiveText;
+  text.insert(text.end(), string, string + strlen(string) + 1);
+  Push(MakeRenderKey(layer, depth, 0, renderFontTexture, PrimitiveText),
+       command);
+}
+
+void RenderQueue::PushTexture(RenderLayer layer, uint32_t depth,
+                              Texture2D texture, Rectangle source,
+                              Rectangle dest, Color tint, uint8_t shader) {
+  RenderCommand command = {};
+  command.rect = dest;
+  command.source = source;
+  command.texture = texture;
+  command.color = tint;
+  command.primitive = PrimitiveTexture;
+  Push(MakeRenderKey(layer, depth, shader, (uint16_t)texture.id,
+                     PrimitiveTexture),
+       command);
+}
+
+void RenderQueue::SetShader(uint8_t slot, Shader shader) {
+  shaders[slot] = shader;
+  hasShader[slot] = slot != 0;
+}
+
+void RenderQueue::Sort() {
+  scratch.resize(items.size());
+  RenderSortItem *sorted =
+      RadixSortRenderItems(items.data(), scratch.data(), items.size());
+  if (sorted != items.data()) {
+    items.swap(scratch);
+  }
+}
+
+void RenderQueue::Submit() const {
+  int shader = 0;
+  for (const RenderSortItem &item : items) {
+    int wanted = (int)((item.key >> 24) & 0xFF);
+    if (wanted != shader) {
+      if (hasShader[shader])
+        EndShaderMode();
+      if (hasShader[wanted])
+        BeginShaderMode(shaders[wanted]);
+      shader = wanted;
+    }
+    const RenderCommand &c = commands[item.command];
+    switch (c.primitive) {
+    case PrimitiveRectangle:
+      DrawRectangleRec(c.rect, c.color);
+      break;
+    case PrimitiveCircle:
+      DrawCircleV({c.rect.x, c.rect.y}, c.rect.width, c.color);
+      break;
+    case PrimitiveText:
+      DrawText(&text[c.text], (int)c.rect.x, (int)c.rect.y, (int)c.rect.height,
+               c.color);
+      break;
+    case PrimitiveTexture:
+      DrawTexturePro(c.texture, c.source, c.rect, {0.0f, 0.0f}, 0.0f,
+                     c.color);
+      break;
+    }
+  }
+  if (hasShader[shader])
+    EndShaderMode();
+}
+
+int RenderQueue::BatchBreaks() const {
+  // Shader and texture, plus whether rlgl draws triangles (circles) or
+  // quads (the rest)
+  int breaks = 0;
+  uint64_t last = 0;
+  for (size_t i = 0; i < items.size(); ++i) {
+    uint64_t key = items[i].key;
+    uint64_t batch = ((key >> 8) & 0xFFFFFF) << 1 |
+                     (uint64_t)((key & 0xFF) == PrimitiveCircle);
+    if (i > 0 && batch != last)
+      breaks++;
+    last = batch;
+  }
+  return breaks;
+}
+
+// Screen area one command covers
+static Rectangle Footprint(const RenderCommand &c, const char *text) {
+  switch (c.primitive) {
+  case PrimitiveCircle:
+    return {c.rect.x - c.rect.width, c.rect.y - c.rect.width,
+            c.rect.width * 2.0f, c.rect.width * 2.0f};
+  case PrimitiveText:
+    return {c.rect.x, c.rect.y,
+            (float)MeasureText(text + c.text, (int)c.rect.height),
+            c.rect.height};
+  default:
+    return {c.rect.x, c.rect.y, fabsf(c.rect.width), fabsf(c.rect.height)};
+  }
+}
+
+double RenderQueue::FillPixels() const {
+  double pixels = 0.0;
+  for (const RenderCommand &c : commands) {
+    Rectangle r = Footprint(c, text.data());
+    // A circle fills pi/4 of its square
+    pixels += (double)r.width * r.height *
+              (c.primitive == PrimitiveCircle ? 0.78539816 : 1.0);
+  }
+  return pixels;
+}
+
+Rectangle RenderQueue::Bounds() const {
+  if (commands.empty())
+    return {0.0f, 0.0f, 0.0f, 0.0f};
+  float left = 1e30f, top = 1e30f, right = -1e30f, bottom = -1e30f;
+  for (const RenderCommand &c : commands) {
+    Rectangle r = Footprint(c, text.data());
+    left = fminf(left, r.x);
+    top = fminf(top, r.y);
+    right = fmaxf(right, r.x + r.width);
+    bottom = fmaxf(bottom, r.y + r.height);
+  }
+  return {left, top, right - left, bottom - top};
+}
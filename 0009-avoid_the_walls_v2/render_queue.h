@@ -0,0 +1,132 @@
+// render_queue.h
+
+#pragma once
+
+#include "raylib.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Draw order, back to front: the top byte of a sort key
+enum RenderLayer : uint8_t {
+  LayerBackground = 0,
+  LayerWorld = 1,
+  LayerHud = 2,
+  LayerOverlay = 3, // Countdown, game over
+};
+
+// What a command draws. The key's lowest byte, so with the same texture
+// the shapes that rlgl draws as quads still end up next to each other.
+enum RenderPrimitive : uint8_t {
+  PrimitiveRectangle = 0,
+  PrimitiveText = 1,
+  PrimitiveTexture = 2,
+  PrimitiveCircle = 3, // Triangles, not quads
+};
+
+// Texture field of shapes (raylib's white texture) and of text in the
+// default font; other textures use their GL id. The field only groups
+// commands for batching, so a clash costs a batch break, never a wrong
+// draw. Small values keep the key's varying bits, and so the sort's
+// passes, few.
+const uint16_t renderShapesTexture = 0;
+const uint16_t renderFontTexture = 1;
+
+// Sort key, most significant bits first:
+//   layer:8 | depth:24 | shader:8 | texture:16 | primitive:8
+// Depth orders commands within a layer, lowest first: isometric tiles
+// pass their screen y (or column + row), so the tiles behind are drawn
+// before the ones in front. At equal depth, commands with the same
+// shader and texture come out together and rlgl batches them.
+inline uint64_t MakeRenderKey(RenderLayer layer, uint32_t depth,
+                              uint8_t shader, uint16_t texture,
+                              RenderPrimitive primitive) {
+  return ((uint64_t)layer << 56) | ((uint64_t)(depth & 0xFFFFFF) << 32) |
+         ((uint64_t)shader << 24) | ((uint64_t)texture << 8) |
+         (uint64_t)primitive;
+}
+
+// One command's key and where the command is, the unit the sort moves
+struct RenderSortItem {
+  uint64_t key;
+  uint32_t command;
+};
+
+// Stable LSD radix sort on the whole key, 11 bits per pass, skipping
+// bits every key shares. 'scratch' must hold 'count' items; returns
+// whichever of the two buffers holds the result.
+RenderSortItem *RadixSortRenderItems(RenderSortItem *items,
+                                     RenderSortItem *scratch, size_t count);
+
+// One recorded draw
+struct RenderCommand {
+  Rectangle rect;    // Rectangle, texture destination; circle: centre in
+                     // x/y, radius in width; text: x/y, font size in height
+  Rectangle source;  // Texture only
+  Texture2D texture; // Texture only
+  Color color;
+  uint32_t text; // Text only: offset into the queue's text storage
+  RenderPrimitive primitive;
+};
+
+// ----------- RenderQueue -----------
+// Manages: one frame's draw commands, recorded in any order
+// Should Own:
+//   - The commands, their sort keys and the strings they draw
+//   - Sorting by key and drawing in that order
+//   - The shaders a key's shader byte refers to
+// Should Not:
+//   - Know about entities or game state
+//   - Begin or end the frame (the Renderer does)
+class RenderQueue {
+public:
+  RenderQueue();
+
+  // Forgets the commands, keeps the memory: a steady frame allocates
+  // nothing
+  void Clear();
+  void Reserve(size_t commands, size_t textBytes);
+
+  void PushRectangle(RenderLayer layer, uint32_t depth, Rectangle rect,
+                     Color color);
+  void PushCircle(RenderLayer layer, uint32_t depth, Vector2 centre,
+                  float radius, Color color);
+  // Default font; the string is copied
+  void PushText(RenderLayer layer, uint32_t depth, const char *text, int x,
+                int y, int fontSize, Color color);
+  void PushTexture(RenderLayer layer, uint32_t depth, Texture2D texture,
+                   Rectangle source, Rectangle dest, Color tint,
+                   uint8_t shader = 0);
+
+  // Shader for keys with this shader byte (1-255; 0 is raylib's default).
+  // Slots are the caller's to assign; the queue only looks them up.
+  void SetShader(uint8_t slot, Shader shader);
+
+  void Sort();
+  // Draws every command: in key order after Sort, else in the order
+  // they were pushed. Call between BeginDrawing and EndDrawing.
+  void Submit() const;
+
+  int Count() const { return (int)commands.size(); }
+  // The i-th command in the order Submit draws them, for other backends
+  const RenderCommand &At(int i) const { return commands[items[i].command]; }
+  const char *Text(const RenderCommand &c) const { return &text[c.text]; }
+  // Shader or texture changes in the order Submit would draw, each
+  // one a batch rlgl has to flush
+  int BatchBreaks() const;
+  // Pixels the commands cover, overlaps counted twice: the fill they
+  // cost (text is measured, so call it with a window open)
+  double FillPixels() const;
+  // Smallest rectangle holding every command (all zero when empty)
+  Rectangle Bounds() const;
+
+private:
+  std::vector<RenderCommand> commands;
+  std::vector<RenderSortItem> items;   // In submit order
+  std::vector<RenderSortItem> scratch; // For the sort
+  std::vector<char> text;              // Strings, each 0-terminated
+  Shader shaders[256];
+  bool hasShader[256];
+
+  void Push(uint64_t key, const RenderCommand &command);
+};
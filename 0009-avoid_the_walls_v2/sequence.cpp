@@ -0,0 +1,193 @@
+// sequence.cpp
+
+#include "sequence.h"
+#include <new>
+
+static const uint32_t noSlot = 0xFFFFFFFFu;
+
+// ----------- FramePool -----------
+
+FramePool::FramePool()
+    : freeLists{}, cursor(nullptr), chunkEnd(nullptr), allocations(0),
+      heapAllocations(0) {}
+
+FramePool::~FramePool() {
+  for (char *chunk : chunks) {
+    ::operator delete(chunk);
+  }
+}
+
+void *FramePool::Allocate(size_t size) {
+  allocations++;
+  size_t total = size + sizeof(Header);
+  uint32_t sizeClass = (uint32_t)((total + classSize - 1) / classSize) - 1;
+  if (sizeClass >= (uint32_t)classes) {
+    heapAllocations++;
+    Header *header = static_cast<Header *>(::operator new(total));
+    header->pool = nullptr;
+    header->sizeClass = sizeClass;
+    return header + 1;
+  }
+
+  Header *header = freeLists[sizeClass];
+  if (header) {
+    freeLists[sizeClass] = reinterpret_cast<Header *>(header->pool);
+  } else {
+    size_t bytes = (sizeClass + 1) * classSize;
+    if ((size_t)(chunkEnd - cursor) < bytes) {
+      // The old chunk's tail is abandoned; it is under one block
+      cursor = static_cast<char *>(::operator new(chunkSize));
+      chunkEnd = cursor + chunkSize;
+      chunks.push_back(cursor);
+    }
+    header = reinterpret_cast<Header *>(cursor);
+    cursor += bytes;
+  }
+  header->pool = this;
+  header->sizeClass = sizeClass;
+  return header + 1;
+}
+
+void FramePool::Free(void *block) {
+  Header *header = static_cast<Header *>(block) - 1;
+  FramePool *pool = header->pool;
+  if (!pool) {
+    ::operator delete(header);
+    return;
+  }
+  Header *&list = pool->freeLists[header->sizeClass];
+  header->pool = reinterpret_cast<FramePool *>(list);
+  list = header;
+}
+
+// ----------- Sequence -----------
+
+Sequence::~Sequence() {
+  if (handle)
+    handle.destroy();
+}
+
+void Sequence::FinalAwaiter::await_suspend(
+    std::coroutine_handle<promise_type> handle) noexcept {
+  handle.promise().runner->Release(handle.promise().slot);
+  handle.destroy();
+}
+
+// ----------- DelayAwaiter -----------
+
+static void ResumeSequence(void *address, uint64_t) {
+  std::coroutine_handle<>::from_address(address).resume();
+}
+
+void DelayAwaiter::await_suspend(
+    std::coroutine_handle<Sequence::promise_type> handle) {
+  timer = timers->Schedule(seconds, ResumeSequence, handle.address(), 0);
+  handle.promise().timer = timer;
+}
+
+// ----------- Signal -----------
+
+Signal::Awaiter::~Awaiter() {
+  if (signal && handle) // Still linked
+    signal->Unlink(this);
+}
+
+void Signal::Awaiter::await_suspend(std::coroutine_handle<> handle) {
+  this->handle = handle;
+  serial = signal->serial;
+  prev = signal->tail;
+  next = nullptr;
+  if (signal->tail)
+    signal->tail->next = this;
+  else
+    signal->head = this;
+  signal->tail = this;
+  signal->waiting++;
+}
+
+void Signal::Unlink(Awaiter *awaiter) {
+  if (awaiter->prev)
+    awaiter->prev->next = awaiter->next;
+  else
+    head = awaiter->next;
+  if (awaiter->next)
+    awaiter->next->prev = awaiter->prev;
+  else
+    tail = awaiter->prev;
+  waiting--;
+}
+
+void Signal::Raise() {
+  uint64_t raised = ++serial;
+  // Taking one waiter at a time stays safe when a resumed sequence stops
+  // others that are still queued
+  while (head && head->serial < raised) {
+    Awaiter *awaiter = head;
+    Unlink(awaiter);
+    awaiter->signal = nullptr;
+    awaiter->handle.resume();
+  }
+}
+
+// ----------- SequenceRunner -----------
+
+SequenceRunner::SequenceRunner(TimerWheel &timers)
+    : pool(), timers(&timers), slots(), freeSlot(noSlot), count(0) {}
+
+SequenceRunner::~SequenceRunner() { Clear(); }
+
+SequenceHandle SequenceRunner::Start(Sequence sequence) {
+  uint32_t index = freeSlot;
+  if (index == noSlot) {
+    index = (uint32_t)slots.size();
+    slots.push_back({{}, 1, noSlot});
+  } else {
+    freeSlot = slots[index].nextFree;
+  }
+  std::coroutine_handle<Sequence::promise_type> handle = sequence.handle;
+  sequence.handle = {};
+  slots[index].handle = handle;
+  handle.promise().slot = index;
+  count++;
+
+  SequenceHandle started = {index, slots[index].generation};
+  handle.resume(); // May finish right away and free the slot
+  return started;
+}
+
+bool SequenceRunner::Running(SequenceHandle handle) const {
+  return handle.index < slots.size() &&
+         slots[handle.index].generation == handle.generation &&
+         slots[handle.index].handle;
+}
+
+bool SequenceRunner::Stop(SequenceHandle handle) {
+  if (!Running(handle))
+    return false;
+  std::coroutine_handle<Sequence::promise_type> frame =
+      slots[handle.index].handle;
+  Release(handle.index);
+  frame.destroy(); // Its awaiter's destructor cancels the wait
+  return true;
+}
+
+double SequenceRunner::WaitLeft(SequenceHandle handle) const {
+  if (!Running(handle))
+    return 0.0;
+  return timers->TimeLeft(slots[handle.index].handle.promise().timer);
+}
+
+void SequenceRunner::Clear() {
+  for (uint32_t index = 0; index < slots.size(); ++index) {
+    if (slots[index].handle)
+      Stop({index, slots[index].generation});
+  }
+}
+
+void SequenceRunner::Release(uint32_t slot) {
+  slots[slot].handle = {};
+  slots[slot].generation++; // Invalidates outstanding handles
+  slots[slot].nextFree = freeSlot;
+  freeSlot = slot;
+  count--;
+}
@@ -0,0 +1,248 @@
+// sequence.h
+
+#pragma once
+
+#include "timer_wheel.h"
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+class SequenceRunner;
+
+// ----------- FramePool -----------
+// Manages: memory for coroutine frames
+// Should Own:
+//   - Size classes of 64 bytes up to 1 KiB, each a free list carved from
+//     16 KiB chunks (no malloc per sequence once warm)
+//   - Falling back to the heap for bigger frames
+// Should Not:
+//   - Know what runs in the frames
+class FramePool {
+public:
+  FramePool();
+  ~FramePool(); // Every block must be freed by now
+  FramePool(const FramePool &) = delete;
+  FramePool &operator=(const FramePool &) = delete;
+
+  void *Allocate(size_t size);
+  static void Free(void *block); // A block from any pool, or a heap one
+
+  long long Allocations() const { return allocations; }
+  long long HeapAllocations() const { return heapAllocations; }
+  size_t ReservedBytes() const { return chunks.size() * chunkSize; }
+
+private:
+  static const size_t classSize = 64;
+  static const int classes = 16;
+  static const size_t chunkSize = 16 * 1024;
+
+  // In front of every block; 16 bytes keeps frames 16-byte aligned
+  struct alignas(16) Header {
+    FramePool *pool; // Null for heap blocks
+    uint32_t sizeClass;
+  };
+
+  Header *freeLists[classes]; // Linked through the 'pool' field
+  std::vector<char *> chunks;
+  char *cursor; // Unused tail of the newest chunk
+  char *chunkEnd;
+  long long allocations;
+  long long heapAllocations;
+};
+
+// ----------- Sequence -----------
+// A coroutine driven by a SequenceRunner. Write one as a function whose
+// first parameter is the runner, so its frame comes from the runner's
+// pool:
+//
+//   Sequence Blink(SequenceRunner &runner, Lamp &lamp) {
+//     for (;;) {
+//       lamp.on = !lamp.on;
+//       co_await runner.Delay(0.5);
+//     }
+//   }
+//
+// It does nothing until passed to runner.Start(), which keeps it.
+class Sequence {
+public:
+  struct FinalAwaiter;
+
+  struct promise_type {
+    SequenceRunner *runner;
+    uint32_t slot;     // In the runner's table
+    TimerHandle timer; // Set while waiting on a Delay
+
+    template <typename... Args>
+    promise_type(SequenceRunner &runner, Args &...)
+        : runner(&runner), slot(0), timer() {}
+
+    template <typename... Args>
+    static void *operator new(size_t size, SequenceRunner &runner, Args &...);
+    static void operator delete(void *frame) { FramePool::Free(frame); }
+
+    Sequence get_return_object() {
+      return Sequence(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept;
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  // Finished: tells the runner, then frees the frame
+  struct FinalAwaiter {
+    bool await_ready() noexcept { return false; }
+    void await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+    void await_resume() noexcept {}
+  };
+
+  Sequence(Sequence &&other) : handle(other.handle) { other.handle = {}; }
+  Sequence(const Sequence &) = delete;
+  Sequence &operator=(const Sequence &) = delete;
+  ~Sequence(); // Destroys it if it was never started
+
+private:
+  friend class SequenceRunner;
+  explicit Sequence(std::coroutine_handle<promise_type> handle)
+      : handle(handle) {}
+  std::coroutine_handle<promise_type> handle;
+};
+
+inline Sequence::FinalAwaiter
+Sequence::promise_type::final_suspend() noexcept {
+  return {};
+}
+
+// ----------- DelayAwaiter -----------
+// co_await runner.Delay(seconds): a timer on the runner's wheel resumes
+// the sequence, so waiting costs nothing per tick
+class DelayAwaiter {
+public:
+  DelayAwaiter(TimerWheel &timers, double seconds)
+      : timers(&timers), seconds(seconds), timer() {}
+  DelayAwaiter(const DelayAwaiter &) = delete;
+  DelayAwaiter &operator=(const DelayAwaiter &) = delete;
+  ~DelayAwaiter() { timers->Cancel(timer); } // The sequence was stopped
+
+  bool await_ready() const { return seconds <= 0.0; }
+  void await_suspend(std::coroutine_handle<Sequence::promise_type> handle);
+  void await_resume() {}
+
+private:
+  TimerWheel *timers;
+  double seconds;
+  TimerHandle timer;
+};
+
+// ----------- Signal -----------
+// Manages: sequences waiting for something to happen
+// Should Own:
+//   - The waiting sequences, oldest first (linked through their awaiters,
+//     so waiting allocates nothing)
+// Should Not:
+//   - Remember being raised: co_await only sees later Raise() calls, so
+//     check the condition first when it may already hold
+class Signal {
+public:
+  class Awaiter {
+  public:
+    explicit Awaiter(Signal &signal)
+        : signal(&signal), prev(nullptr), next(nullptr), serial(0) {}
+    Awaiter(const Awaiter &) = delete;
+    Awaiter &operator=(const Awaiter &) = delete;
+    ~Awaiter(); // Stops waiting if the sequence was stopped
+
+    bool await_ready() const { return false; }
+    void await_suspend(std::coroutine_handle<> handle);
+    void await_resume() {}
+
+  private:
+    friend class Signal;
+    Signal *signal; // Null once woken
+    Awaiter *prev, *next;
+    std::coroutine_handle<> handle;
+    uint64_t serial; // Raise() count when it started waiting
+  };
+
+  Signal() : head(nullptr), tail(nullptr), serial(0), waiting(0) {}
+  Signal(const Signal &) = delete;
+  Signal &operator=(const Signal &) = delete;
+
+  Awaiter operator co_await() { return Awaiter(*this); }
+  // Resumes everything waiting at the time of the call; sequences that
+  // start waiting again from inside Raise() wait for the next one
+  void Raise();
+  int Waiting() const { return waiting; }
+
+private:
+  Awaiter *head, *tail;
+  uint64_t serial;
+  int waiting;
+  void Unlink(Awaiter *awaiter);
+};
+
+// ----------- SequenceHandle -----------
+// Names one started sequence; stays safe to use after it finished or was
+// stopped (the generation no longer matches)
+struct SequenceHandle {
+  uint32_t index = 0;
+  uint32_t generation = 0;
+};
+
+// ----------- SequenceRunner -----------
+// Manages: scripted flows written as coroutines (countdowns, intros,
+// boss patterns), resumed by the simulation clock
+// Should Own:
+//   - The running sequences and the pool their frames come from
+//   - Stopping a sequence wherever it waits
+// Should Not:
+//   - Advance the clock (whoever owns the TimerWheel does, and sequences
+//     resume from inside its Advance)
+//   - Poll conditions every tick (sequences wait on Signals instead)
+class SequenceRunner {
+public:
+  explicit SequenceRunner(TimerWheel &timers);
+  ~SequenceRunner(); // Stops whatever is still running
+  SequenceRunner(const SequenceRunner &) = delete;
+  SequenceRunner &operator=(const SequenceRunner &) = delete;
+
+  SequenceHandle Start(Sequence sequence); // Runs it up to its first wait
+  // False if it already finished. Not for a sequence stopping itself.
+  bool Stop(SequenceHandle handle);
+  bool Running(SequenceHandle handle) const;
+  // Seconds left on the Delay it waits on, 0 when waiting on anything else
+  double WaitLeft(SequenceHandle handle) const;
+  void Clear(); // Stops everything
+
+  DelayAwaiter Delay(double seconds) { return DelayAwaiter(*timers, seconds); }
+
+  int Count() const { return count; }
+  const FramePool &Pool() const { return pool; }
+
+private:
+  friend struct Sequence::promise_type;
+  friend struct Sequence::FinalAwaiter;
+
+  struct Slot {
+    std::coroutine_handle<Sequence::promise_type> handle; // Null when free
+    uint32_t generation;
+    uint32_t nextFree;
+  };
+
+  FramePool pool; // First, so it outlives the frames
+  TimerWheel *timers;
+  std::vector<Slot> slots;
+  uint32_t freeSlot;
+  int count;
+
+  void Release(uint32_t slot);
+};
+
+template <typename... Args>
+void *Sequence::promise_type::operator new(size_t size,
+                                           SequenceRunner &runner, Args &...) {
+  return runner.pool.Allocate(size);
+}
@@ -0,0 +1,200 @@
+// session_host.cpp
+
+#include "session_host.h"
+#include "constants.h"
+#include <algorithm>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+static uint32_t Nanoseconds(Clock::duration d) {
+  long long ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+  return ns < 0 ? 0 : (ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns);
+}
+
+static uint32_t Percentile(std::vector<uint32_t> &samples, float p) {
+  if (samples.empty())
+    return 0;
+  size_t n = std::min(samples.size() - 1, (size_t)(p * samples.size()));
+  std::nth_element(samples.begin(), samples.begin() + n, samples.end());
+  return samples[n];
+}
+
+// ----------- SessionBot -----------
+
+SessionBot::SessionBot(float lookahead) : lookahead(lookahead) {}
+
+void SessionBot::Think(const Game &game, ScriptedInput &input) const {
+  if (game.gameState.gameOver) {
+    input.Press(KEY_R);
+    return;
+  }
+  if (game.gameState.countdownActive)
+    return;
+
+  const Player &player = game.entityManager.player;
+  float roomLeft = player.position.x;
+  float roomRight = screenWidth - (player.position.x + player.bounds.width);
+  float roomUp = player.position.y;
+  float roomDown = screenHeight - (player.position.y + player.bounds.height);
+
+  float ahead = player.moveDir.x > 0   ? roomRight
+                : player.moveDir.x < 0 ? roomLeft
+                : player.moveDir.y > 0 ? roomDown
+                                       : roomUp;
+  if (ahead >= lookahead * player.speed)
+    return;
+
+  // Turn 90 degrees toward the side with more room
+  if (player.moveDir.x != 0) {
+    input.Press(roomDown >= roomUp ? KEY_S : KEY_W);
+  } else {
+    input.Press(roomRight >= roomLeft ? KEY_D : KEY_A);
+  }
+}
+
+// ----------- Session -----------
+
+Session::Session(uint32_t seed, float lookahead, int ticks)
+    : input(), game(input, seed), bot(lookahead), tick(0), gamesFinished(0) {
+  serviceNs.reserve(ticks);
+  lateNs.reserve(ticks);
+}
+
+void Session::Advance(int ticks, float deltaTime, bool paced,
+                      Clock::time_point dueStart) {
+  for (int n = 0; n < ticks; ++n) {
+    bool wasOver = game.gameState.gameOver;
+    Clock::time_point begin = Clock::now();
+
+    bot.Think(game, input);
+    game.Step(deltaTime);
+    input.Clear();
+
+    Clock::time_point end = Clock::now();
+    serviceNs.push_back(Nanoseconds(end - begin));
+    if (paced) {
+      // Tick t is due when the virtual clock reaches t * deltaTime
+      auto due = dueStart + std::chrono::duration_cast<Clock::duration>(
+                                std::chrono::duration<double>(
+                                    tick * (double)deltaTime));
+      lateNs.push_back(Nanoseconds(end - due));
+    }
+    if (!wasOver && game.gameState.gameOver)
+      gamesFinished++;
+    tick++;
+  }
+}
+
+// ----------- SessionHost -----------
+
+SessionHost::SessionHost(const HostConfig &config)
+    : config(config), arrived(0), round(0), nextSlot(0) {
+  uint32_t seed = config.seed ? config.seed : 1;
+  for (int i = 0; i < config.sessions; ++i) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    float lookahead = 0.15f + (seed % 1000) * 0.0004f; // 0.15-0.55 s
+    sessions.emplace_back(
+        new Session(seed, lookahead, config.ticksPerSession));
+  }
+}
+
+void SessionHost::WaitForRound(int finishedRound) {
+  std::unique_lock<std::mutex> lock(mutex);
+  if (++arrived == config.workers) {
+    // Last worker in: open the next round
+    arrived = 0;
+    nextSlot.store(0);
+    round = finishedRound + 1;
+    roundDone.notify_all();
+    return;
+  }
+  roundDone.wait(lock, [&] { return round > finishedRound; });
+}
+
+void SessionHost::WorkerLoop(int worker, int rounds) {
+  const int count = (int)sessions.size();
+  const float deltaTime = 1.0f / config.tickRate;
+  const double roundSeconds = config.sliceTicks * (double)deltaTime;
+  double busy = 0.0;
+
+  for (int r = 0; r < rounds; ++r) {
+    if (config.paced) {
+      std::this_thread::sleep_until(
+          start + std::chrono::duration_cast<Clock::duration>(
+                      std::chrono::duration<double>(r * roundSeconds)));
+    }
+
+    int ticks = std::min(config.sliceTicks,
+                         config.ticksPerSession - r * config.sliceTicks);
+    // Rotate the pick order so the same sessions aren't always served last
+    int offset = (int)((long long)r * (count / 2 + 1) % count);
+    for (int slot = nextSlot.fetch_add(1); slot < count;
+         slot = nextSlot.fetch_add(1)) {
+      Clock::time_point begin = Clock::now();
+      sessions[(slot + offset) % count]->Advance(ticks, deltaTime,
+                                                 config.paced, start);
+      busy += std::chrono::duration<double>(Clock::now() - begin).count();
+    }
+
+    WaitForRound(r);
+  }
+  busySeconds[worker] = busy;
+}
+
+HostReport SessionHost::Run() {
+  HostReport report;
+  report.totalTicks = 0;
+  report.busySeconds = 0.0;
+  report.sessionsPerCore = 0.0;
+  if (sessions.empty() || config.workers < 1 || config.sliceTicks < 1) {
+    report.wallSeconds = 0.0;
+    return report;
+  }
+
+  int rounds =
+      (config.ticksPerSession + config.sliceTicks - 1) / config.sliceTicks;
+  busySeconds.assign(config.workers, 0.0);
+  arrived = 0;
+  round = 0;
+  nextSlot.store(0);
+
+  start = Clock::now();
+  std::vector<std::thread> workers;
+  for (int w = 1; w < config.workers; ++w) {
+    workers.emplace_back(&SessionHost::WorkerLoop, this, w, rounds);
+  }
+  WorkerLoop(0, rounds); // The calling thread is worker 0
+  for (std::thread &t : workers) {
+    t.join();
+  }
+  report.wallSeconds =
+      std::chrono::duration<double>(Clock::now() - start).count();
+
+  for (std::unique_ptr<Session> &session : sessions) {
+    SessionReport s;
+    s.ticks = session->Ticks();
+    s.games = session->GamesFinished();
+    std::vector<uint32_t> &service = session->ServiceNs();
+    s.serviceP50 = Percentile(service, 0.50f);
+    s.serviceP99 = Percentile(service, 0.99f);
+    s.serviceMax = Percentile(service, 1.0f);
+    std::vector<uint32_t> &late = session->LateNs();
+    s.lateP50 = Percentile(late, 0.50f);
+    s.lateP99 = Percentile(late, 0.99f);
+    s.lateMax = Percentile(late, 1.0f);
+    report.sessions.push_back(s);
+    report.totalTicks += s.ticks;
+  }
+  for (double busy : busySeconds) {
+    report.busySeconds += busy;
+  }
+  if (report.busySeconds > 0.0) {
+    report.sessionsPerCore =
+        report.totalTicks / report.busySeconds / config.tickRate;
+  }
+  return report;
+}
@@ -0,0 +1,128 @@
+// session_host.h
+
+#pragma once
+
+#include "game.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// ----------- HostConfig -----------
+// How many sessions to host and how to schedule their ticks
+struct HostConfig {
+  int sessions = 64;
+  int workers = 4;
+  int ticksPerSession = 3600; // Virtual-clock ticks each session plays
+  int sliceTicks = 4;         // Ticks a worker runs per session per round
+  float tickRate = 60.0f;     // Virtual clock rate (Hz)
+  bool paced = false;         // Hold each round until its wall-clock due time
+  uint32_t seed = 12345;
+};
+
+// ----------- SessionBot -----------
+// Manages: the simulated player for one hosted session
+// Should Own:
+//   - Reading the game and pressing keys through a ScriptedInput
+//   - Turning toward the side with more room when a wall gets close
+//   - Pressing R after a game over
+// Should Not:
+//   - Change game state directly
+class SessionBot {
+public:
+  explicit SessionBot(float lookahead);
+  void Think(const Game &game, ScriptedInput &input) const;
+
+private:
+  float lookahead; // Seconds of travel before a wall that trigger a turn
+};
+
+// ----------- Session -----------
+// Manages: one hosted game and its virtual clock
+// Should Own:
+//   - The Game, its injected input and its bot
+//   - Tick count (the virtual clock) and games played
+//   - Per-tick timing samples, preallocated for the whole run
+// Should Not:
+//   - Know about workers or scheduling
+class Session {
+public:
+  Session(uint32_t seed, float lookahead, int ticks);
+  Session(const Session &) = delete;
+  Session &operator=(const Session &) = delete;
+
+  // Plays up to 'ticks' ticks of 'deltaTime' seconds of virtual time.
+  // 'dueStart' is the wall-clock time tick 0 was due (paced hosts only).
+  void Advance(int ticks, float deltaTime, bool paced,
+               std::chrono::steady_clock::time_point dueStart);
+
+  long long Ticks() const { return tick; }
+  long long GamesFinished() const { return gamesFinished; }
+  std::vector<uint32_t> &ServiceNs() { return serviceNs; }
+  std::vector<uint32_t> &LateNs() { return lateNs; }
+
+private:
+  ScriptedInput input; // Declared before game, which keeps a reference
+  Game game;
+  SessionBot bot;
+  long long tick;
+  long long gamesFinished;
+  std::vector<uint32_t> serviceNs; // Time spent inside each Step
+  std::vector<uint32_t> lateNs;    // Paced: tick end minus its due time
+};
+
+// ----------- SessionReport -----------
+// Tick latency percentiles for one session (nanoseconds)
+struct SessionReport {
+  long long ticks;
+  long long games;
+  uint32_t serviceP50, serviceP99, serviceMax;
+  uint32_t lateP50, lateP99, lateMax; // Zero unless paced
+};
+
+// ----------- HostReport -----------
+struct HostReport {
+  std::vector<SessionReport> sessions;
+  long long totalTicks;
+  double wallSeconds;
+  double busySeconds;     // Summed over workers, time spent stepping games
+  double sessionsPerCore; // Sessions one fully busy core sustains at tickRate
+};
+
+// ----------- SessionHost -----------
+// Manages: many independent Game sessions on a pool of worker threads
+// Should Own:
+//   - The sessions and the worker threads
+//   - Round-based fair scheduling: every round each session gets one slice
+//     of 'sliceTicks' ticks, so no session runs ahead of the others by more
+//     than a slice; the pick order rotates each round
+//   - Pacing rounds against the wall clock when asked
+//   - Collecting latency percentiles and throughput
+// Should Not:
+//   - Open a window, render or play audio (sessions are headless)
+class SessionHost {
+public:
+  explicit SessionHost(const HostConfig &config);
+
+  HostReport Run(); // Plays every session to ticksPerSession, then reports
+
+private:
+  HostConfig config;
+  std::vector<std::unique_ptr<Session>> sessions;
+
+  // Round barrier shared by the workers
+  std::mutex mutex;
+  std::condition_variable roundDone;
+  int arrived;
+  int round;
+  std::atomic<int> nextSlot; // Next session slot to hand out this round
+
+  std::chrono::steady_clock::time_point start;
+  std::vector<double> busySeconds; // Per worker
+
+  void WorkerLoop(int worker, int rounds);
+  void WaitForRound(int finishedRound);
+};
@@ -0,0 +1,55 @@
+// playtest.cpp
+//
+// Bulk playtesting for Avoid the Walls: plays many bot runs with the
+// game's tuning values (or overrides) and prints survival statistics per
+// bot policy, plus simulator throughput.
+//
+// Usage: playtest [games] [speedPerTurn] [countdownSeconds]
+
+#include "../batch_sim.h"
+#include "../constants.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+int main(int argc, char **argv) {
+  long long games = argc > 1 ? atoll(argv[1]) : 1000000;
+
+  SimParams params;
+  params.fieldWidth = screenWidth;
+  params.fieldHeight = screenHeight;
+  params.playerSize = playerSize;
+  params.startSpeed = playerStartSpeed;
+  params.speedPerTurn = argc > 2 ? (float)atof(argv[2]) : speedPerTurn;
+  params.countdownSeconds =
+      argc > 3 ? (float)atof(argv[3]) : countdownSeconds;
+  params.deltaTime = 1.0f / 60.0f;
+  params.maxSeconds = 120.0f;
+
+  BatchSimulator sim(params, 4096, 12345);
+  sim.AddPolicy({"reckless", 0.05f, 0.02f, 0.2f});
+  sim.AddPolicy({"steady", 0.25f, 0.0f, 0.2f});
+  sim.AddPolicy({"careful", 0.6f, 0.0f, 0.2f});
+  sim.AddPolicy({"jittery", 0.3f, 0.05f, 0.2f});
+
+  auto start = std::chrono::steady_clock::now();
+  long long instanceTicks = sim.Run(games);
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  printf("speedPerTurn %.1f px/s, countdown %.1f s, %lld games\n",
+         params.speedPerTurn, params.countdownSeconds, games);
+  printf("%-10s %9s %8s %8s %8s %8s %8s %9s\n", "policy", "games", "mean s",
+         "p10 s", "p50 s", "p90 s", "max s", "turns");
+  for (size_t p = 0; p < sim.Policies().size(); ++p) {
+    const PolicyStats &s = sim.Stats()[p];
+    printf("%-10s %9lld %8.2f %8.1f %8.1f %8.1f %8.1f %9.1f\n",
+           sim.Policies()[p].name, s.games, s.MeanSurvival(),
+           s.Percentile(0.1f), s.Percentile(0.5f), s.Percentile(0.9f),
+           s.maxSurvival, s.games ? (double)s.totalTurns / s.games : 0.0);
+  }
+  printf("%lld instance-ticks in %.3f s = %.1f M instance-ticks/s\n",
+         instanceTicks, seconds, instanceTicks / seconds / 1e6);
+  return 0;
+}
@@ -0,0 +1,394 @@
+// soft_raster.cpp
+
+#include "soft_raster.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// x / 255, rounded, for x up to 255 * 255: exact, and cheap in 16 bits
+static inline uint32_t Div255(uint32_t x) {
+  x += 128;
+  return (x + (x >> 8)) >> 8;
+}
+
+// raylib's default blending, source over destination. The destination
+// keeps an opaque alpha: the source's alpha channel counts as 255.
+static inline Color Blend(Color s, Color d, uint32_t a) {
+  uint32_t inv = 255 - a;
+  return Color{(unsigned char)Div255(s.r * a + d.r * inv),
+               (unsigned char)Div255(s.g * a + d.g * inv),
+               (unsigned char)Div255(s.b * a + d.b * inv),
+               (unsigned char)Div255(255 * a + d.a * inv)};
+}
+
+// ----------- SoftwareRasterizer -----------
+
+SoftwareRasterizer::SoftwareRasterizer(int width, int height, int threads)
+    : width(width), height(height), columns((width + tileSize - 1) / tileSize),
+      rows((height + tileSize - 1) / tileSize),
+      pixels((size_t)width * height), simd(true), skipped(0),
+      fontLoaded(false), fontTried(false), fontBaseSize(10), glyphs{},
+      masks(), shapes(), bins((size_t)columns * rows), clearColor(),
+      workers(), generation(0), busy(0), nextTile(0), stopping(false) {
+#ifdef PLATFORM_WEB
+  threads = 1; // No pthreads in the web build
+#endif
+  for (int i = 1; i < threads; ++i) {
+    workers.emplace_back(&SoftwareRasterizer::Work, this);
+  }
+}
+
+SoftwareRasterizer::~SoftwareRasterizer() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (std::thread &worker : workers) {
+    worker.join();
+  }
+}
+
+void SoftwareRasterizer::SetFont(const Font &font) {
+  fontTried = true;
+  fontLoaded = false;
+  masks.clear();
+  if (!font.glyphs || font.glyphCount <= 0 || font.baseSize <= 0)
+    return;
+  int fallback = -1;
+  bool present[256] = {};
+  for (int i = 0; i < font.glyphCount; ++i) {
+    const GlyphInfo &info = font.glyphs[i];
+    if (info.value < 0 || info.value > 255)
+      continue;
+    Glyph &glyph = glyphs[info.value];
+    glyph.offsetX = info.offsetX;
+    glyph.offsetY = info.offsetY;
+    glyph.advanceX = info.advanceX;
+    glyph.width = info.image.width;
+    glyph.height = info.image.height;
+    glyph.mask = -1;
+    if (info.image.data && glyph.width > 0 && glyph.height > 0) {
+      // Coverage: alpha, or the grey level of a greyscale glyph
+      bool grey = info.image.format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+      glyph.mask = (int)masks.size();
+      for (int y = 0; y < glyph.height; ++y) {
+        for (int x = 0; x < glyph.width; ++x) {
+          Color c = GetImageColor(info.image, x, y);
+          masks.push_back(grey ? c.r : c.a);
+        }
+      }
+    }
+    present[info.value] = true;
+    if (info.value == '?')
+      fallback = info.value;
+  }
+  // Like raylib, anything the font lacks is drawn as '?'
+  if (fallback < 0)
+    fallback = font.glyphs[0].value;
+  for (int c = 0; c < 256; ++c) {
+    if (!present[c])
+      glyphs[c] = glyphs[fallback];
+  }
+  fontBaseSize = font.baseSize;
+  fontLoaded = true;
+}
+
+void SoftwareRasterizer::LoadDefaultFont() {
+  if (!fontTried)
+    SetFont(GetFontDefault());
+}
+
+int SoftwareRasterizer::MeasureText(const char *text, int fontSize) {
+  LoadDefaultFont();
+  if (!fontLoaded)
+    return 0;
+  // raylib's MeasureText: default spacing, widest line
+  if (fontSize < fontBaseSize)
+    fontSize = fontBaseSize;
+  int spacing = fontSize / fontBaseSize;
+  float scale = (float)fontSize / fontBaseSize;
+  int lineWidth = 0, widest = 0, lineBytes = 0, mostBytes = 0;
+  for (const unsigned char *p = (const unsigned char *)text; *p; ++p) {
+    if (*p == '\n') {
+      widest = std::max(widest, lineWidth);
+      lineWidth = 0;
+      lineBytes = 0;
+      continue;
+    }
+    const Glyph &g = GlyphFor(*p);
+    lineWidth += g.advanceX ? g.advanceX : g.width + g.offsetX;
+    mostBytes = std::max(mostBytes, ++lineBytes);
+  }
+  widest = std::max(widest, lineWidth);
+  return (int)(widest * scale + (float)((mostBytes - 1) * spacing));
+}
+
+void SoftwareRasterizer::Draw(const RenderQueue &queue, Color clear) {
+  LoadDefaultFont();
+  clearColor = clear;
+  clearColor.a = 255;
+
+  // Where each command lands, then which tiles it touches
+  shapes.clear();
+  for (std::vector<int> &bin : bins) {
+    bin.clear();
+  }
+  for (int i = 0; i < queue.Count(); ++i) {
+    const RenderCommand &c = queue.At(i);
+    Shape shape = {&c, nullptr, 0, 0, 0, 0};
+    float left, top, right, bottom;
+    switch (c.primitive) {
+    case PrimitiveRectangle:
+      // Pixels whose centres are inside, as the GPU fills them
+      left = ceilf(c.rect.x - 0.5f);
+      top = ceilf(c.rect.y - 0.5f);
+      right = ceilf(c.rect.x + c.rect.width - 0.5f);
+      bottom = ceilf(c.rect.y + c.rect.height - 0.5f);
+      break;
+    case PrimitiveCircle:
+      left = floorf(c.rect.x - c.rect.width);
+      top = floorf(c.rect.y - c.rect.width);
+      right = ceilf(c.rect.x + c.rect.width) + 1.0f;
+      bottom = ceilf(c.rect.y + c.rect.width) + 1.0f;
+      break;
+    case PrimitiveText: {
+      if (!fontLoaded) {
+        skipped++;
+        continue;
+      }
+      shape.text = queue.Text(c);
+      // Generous: glyphs may reach past their advance
+      int lines = 1;
+      for (const char *p = shape.text; *p; ++p)
+        lines += *p == '\n';
+      float size = fmaxf(c.rect.height, (float)fontBaseSize);
+      left = floorf(c.rect.x - size);
+      top = floorf(c.rect.y - size);
+      right = ceilf(c.rect.x + MeasureText(shape.text, (int)size) + size);
+      bottom = ceilf(c.rect.y + lines * (size + 2.0f) + size);
+      break;
+    }
+    default:
+      skipped++; // Textures
+      continue;
+    }
+    shape.left = (int)std::max(left, 0.0f);
+    shape.top = (int)std::max(top, 0.0f);
+    shape.right = (int)std::min(right, (float)width);
+    shape.bottom = (int)std::min(bottom, (float)height);
+    if (shape.left >= shape.right || shape.top >= shape.bottom)
+      continue;
+    int index = (int)shapes.size();
+    shapes.push_back(shape);
+    for (int ty = shape.top / tileSize; ty <= (shape.bottom - 1) / tileSize;
+         ++ty) {
+      for (int tx = shape.left / tileSize;
+           tx <= (shape.right - 1) / tileSize; ++tx) {
+        bins[ty * columns + tx].push_back(index);
+      }
+    }
+  }
+
+  nextTile.store(0);
+  if (workers.empty()) {
+    DrawTiles();
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    generation++;
+    busy = (int)workers.size();
+  }
+  wake.notify_all();
+  DrawTiles();
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [this]() { return busy == 0; });
+}
+
+void SoftwareRasterizer::Work() {
+  unsigned seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait(lock, [&]() { return stopping || generation != seen; });
+      if (stopping)
+        return;
+      seen = generation;
+    }
+    DrawTiles();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (--busy == 0)
+      done.notify_one();
+  }
+}
+
+void SoftwareRasterizer::DrawTiles() {
+  int tiles = columns * rows;
+  for (int tile = nextTile.fetch_add(1); tile < tiles;
+       tile = nextTile.fetch_add(1)) {
+    DrawTile(tile);
+  }
+}
+
+void SoftwareRasterizer::DrawTile(int tile) {
+  int left = (tile % columns) * tileSize;
+  int top = (tile / columns) * tileSize;
+  int right = std::min(left + tileSize, width);
+  int bottom = std::min(top + tileSize, height);
+  for (int y = top; y < bottom; ++y) {
+    Span(&pixels[(size_t)y * width + left], right - left, clearColor);
+  }
+
+  for (int index : bins[tile]) {
+    const Shape &shape = shapes[index];
+    int l = std::max(left, shape.left), t = std::max(top, shape.top);
+    int r = std::min(right, shape.right), b = std::min(bottom, shape.bottom);
+    if (l >= r || t >= b)
+      continue;
+    switch (shape.command->primitive) {
+    case PrimitiveRectangle:
+      for (int y = t; y < b; ++y) {
+        Span(&pixels[(size_t)y * width + l], r - l, shape.command->color);
+      }
+      break;
+    case PrimitiveCircle:
+      FillCircle(shape, l, t, r, b);
+      break;
+    case PrimitiveText:
+      DrawText(shape, l, t, r, b);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void SoftwareRasterizer::FillCircle(const Shape &shape, int clipLeft,
+                                    int clipTop, int clipRight,
+                                    int clipBottom) {
+  // A span per row: the pixels whose centres are inside the circle
+  const RenderCommand &c = *shape.command;
+  float cx = c.rect.x, cy = c.rect.y, radius = c.rect.width;
+  for (int y = clipTop; y < clipBottom; ++y) {
+    float dy = (float)y + 0.5f - cy;
+    float reach = radius * radius - dy * dy;
+    if (reach < 0.0f)
+      continue;
+    float half = sqrtf(reach);
+    int x0 = std::max((int)ceilf(cx - half - 0.5f), clipLeft);
+    int x1 = std::min((int)floorf(cx + half - 0.5f) + 1, clipRight);
+    if (x0 < x1)
+      Span(&pixels[(size_t)y * width + x0], x1 - x0, c.color);
+  }
+}
+
+void SoftwareRasterizer::DrawText(const Shape &shape, int clipLeft,
+                                  int clipTop, int clipRight,
+                                  int clipBottom) {
+  // raylib's DrawText: the default spacing, glyphs scaled with nearest
+  // sampling (the default font's filter)
+  const RenderCommand &c = *shape.command;
+  int fontSize = std::max((int)c.rect.height, fontBaseSize);
+  int spacing = fontSize / fontBaseSize;
+  float scale = (float)fontSize / fontBaseSize;
+  float penX = 0.0f, penY = 0.0f;
+  for (const unsigned char *p = (const unsigned char *)shape.text; *p; ++p) {
+    if (*p == '\n') {
+      penX = 0.0f;
+      penY += (float)(fontSize + 2); // raylib's line spacing
+      continue;
+    }
+    const Glyph &g = GlyphFor(*p);
+    if (*p != ' ' && *p != '\t' && g.mask >= 0) {
+      float gx = c.rect.x + penX + g.offsetX * scale;
+      float gy = c.rect.y + penY + g.offsetY * scale;
+      int x0 = std::max((int)ceilf(gx - 0.5f), clipLeft);
+      int y0 = std::max((int)ceilf(gy - 0.5f), clipTop);
+      int x1 = std::min((int)ceilf(gx + g.width * scale - 0.5f), clipRight);
+      int y1 = std::min((int)ceilf(gy + g.height * scale - 0.5f), clipBottom);
+      for (int y = y0; y < y1; ++y) {
+        int v = std::min((int)(((float)y + 0.5f - gy) / scale), g.height - 1);
+        const uint8_t *mask = &masks[g.mask + v * g.width];
+        Color *row = &pixels[(size_t)y * width];
+        for (int x = x0; x < x1; ++x) {
+          int u = std::min((int)(((float)x + 0.5f - gx) / scale), g.width - 1);
+          uint32_t a = Div255((uint32_t)mask[u] * c.color.a);
+          if (a == 255)
+            row[x] = Color{c.color.r, c.color.g, c.color.b, 255};
+          else if (a > 0)
+            row[x] = Blend(c.color, row[x], a);
+        }
+      }
+    }
+    penX += (g.advanceX ? g.advanceX : g.width) * scale + spacing;
+  }
+}
+
+void SoftwareRasterizer::Span(Color *dst, int count, Color color) const {
+  uint32_t a = color.a;
+  if (a == 0 || count <= 0)
+    return;
+  int i = 0;
+  if (a == 255) {
+    Color opaque = color;
+#if defined(__SSE2__)
+    if (simd) {
+      uint32_t packed;
+      memcpy(&packed, &opaque, sizeof(packed));
+      __m128i four = _mm_set1_epi32((int)packed);
+      for (; i + 4 <= count; i += 4)
+        _mm_storeu_si128((__m128i *)(dst + i), four);
+    }
+#endif
+    for (; i < count; ++i)
+      dst[i] = opaque;
+    return;
+  }
+#if defined(__SSE2__)
+  if (simd) {
+    // Two pixels per 16-bit half: s * a + d * (255 - a), then Div255
+    const __m128i zero = _mm_setzero_si128();
+    Color source = {color.r, color.g, color.b, 255};
+    uint32_t packed;
+    memcpy(&packed, &source, sizeof(packed));
+    __m128i s = _mm_unpacklo_epi8(_mm_set1_epi32((int)packed), zero);
+    __m128i sa = _mm_mullo_epi16(s, _mm_set1_epi16((short)a));
+    __m128i inv = _mm_set1_epi16((short)(255 - a));
+    __m128i round = _mm_set1_epi16(128);
+    for (; i + 4 <= count; i += 4) {
+      __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+      __m128i lo = _mm_add_epi16(
+          _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv), sa),
+          round);
+      __m128i hi = _mm_add_epi16(
+          _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv), sa),
+          round);
+      lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+      hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+      _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+  }
+#endif
+  for (; i < count; ++i)
+    dst[i] = Blend(color, dst[i], a);
+}
+
+uint64_t SoftwareRasterizer::Hash() const {
+  uint64_t hash = 1469598103934665603ull;
+  const unsigned char *bytes = (const unsigned char *)pixels.data();
+  for (size_t i = 0; i < pixels.size() * sizeof(Color); ++i) {
+    hash = (hash ^ bytes[i]) * 1099511628211ull;
+  }
+  return hash;
+}
+
+bool SoftwareRasterizer::ExportPng(const char *path) const {
+  Image image = {(void *)pixels.data(), width, height, 1,
+                 PIXELFORMAT_UNCOMPRESSED_R8G8B8A8};
+  return ExportImage(image, path);
+}
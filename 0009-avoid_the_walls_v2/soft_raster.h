@@ -0,0 +1,113 @@
+// soft_raster.h
+
+#pragma once
+
+#include "raylib.h"
+#include "render_queue.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ----------- SoftwareRasterizer -----------
+// Manages: drawing a RenderQueue into a framebuffer in memory, with no
+// window and no GPU (screenshots on headless servers, replay thumbnails,
+// golden-image checks)
+// Should Own:
+//   - The framebuffer: RGBA8, top row first, as ExportImage takes it
+//   - Rectangles, circles and bitmap text, blended like raylib's default
+//     alpha blending, with SSE2 span kernels where the CPU has them
+//   - Splitting the frame into tiles for its worker threads. Each pixel
+//     is drawn by one thread, in command order, so the image is the same
+//     for any thread count and with or without SIMD.
+// Should Not:
+//   - Record commands (the Renderer does)
+//   - Open a window or call OpenGL
+class SoftwareRasterizer {
+public:
+  static const int tileSize = 64;
+
+  SoftwareRasterizer(int width, int height, int threads);
+  ~SoftwareRasterizer();
+  SoftwareRasterizer(const SoftwareRasterizer &) = delete;
+  SoftwareRasterizer &operator=(const SoftwareRasterizer &) = delete;
+
+  int Width() const { return width; }
+  int Height() const { return height; }
+  int Threads() const { return (int)workers.size() + 1; }
+
+  // Glyphs come from the font's CPU-side glyph images. The default is
+  // raylib's default font, which InitWindow loads (a hidden window will
+  // do); with no font, text is skipped and counted.
+  void SetFont(const Font &font);
+  bool HasFont() const { return fontLoaded; }
+  // As raylib's MeasureText, from this atlas
+  int MeasureText(const char *text, int fontSize);
+  // Off: plain C++ kernels, for comparison (the pixels are the same)
+  void SetSimd(bool enabled) { simd = enabled; }
+
+  // Clears the frame, then draws every command in the queue's order.
+  // Textures are skipped (their pixels live on the GPU).
+  void Draw(const RenderQueue &queue, Color clear);
+
+  const Color *Pixels() const { return pixels.data(); }
+  uint64_t Hash() const; // FNV-1a of the pixels, for golden images
+  bool ExportPng(const char *path) const;
+  long long Skipped() const { return skipped; } // Commands not drawn
+
+private:
+  struct Glyph {
+    int offsetX, offsetY, advanceX;
+    int width, height;
+    int mask; // Offset of its coverage bytes in 'masks', -1 if none
+  };
+
+  // One command as the tiles see it: what to draw and where
+  struct Shape {
+    const RenderCommand *command;
+    const char *text;
+    int left, top, right, bottom; // Pixels covered, right/bottom exclusive
+  };
+
+  int width;
+  int height;
+  int columns; // Tiles across
+  int rows;    // Tiles down
+  std::vector<Color> pixels;
+  bool simd;
+  long long skipped;
+
+  bool fontLoaded;
+  bool fontTried; // The default font is looked up once
+  int fontBaseSize;
+  Glyph glyphs[256]; // By byte; missing ones point at '?'
+  std::vector<uint8_t> masks;
+
+  // This frame
+  std::vector<Shape> shapes;
+  std::vector<std::vector<int>> bins; // Per tile, shape indices in order
+  Color clearColor;
+
+  // Tile workers
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+  unsigned generation;
+  int busy; // Workers still on this frame
+  std::atomic<int> nextTile;
+  bool stopping;
+
+  void LoadDefaultFont();
+  const Glyph &GlyphFor(unsigned char c) const { return glyphs[c]; }
+  void Work();
+  void DrawTiles();
+  void DrawTile(int tile);
+  void FillCircle(const Shape &shape, int clipLeft, int clipTop,
+                  int clipRight, int clipBottom);
+  void DrawText(const Shape &shape, int clipLeft, int clipTop, int clipRight,
+                int clipBottom);
+  void Span(Color *dst, int count, Color color) const;
+};
@@ -0,0 +1,292 @@
+// tilemap.cpp
+
+#include "tilemap.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Keeps a box that ends exactly on a tile edge, give or take rounding,
+// from counting as overlapping the tile past it
+static const double edgeEpsilon = 1e-7; // Tiles
+
+// Bits 'from' to 'to' (inclusive) of a 32-bit row
+static inline uint32_t BitRange(int from, int to) {
+  uint32_t upTo = to == 31 ? 0xFFFFFFFFu : (1u << (to + 1)) - 1u;
+  return upTo & ~((1u << from) - 1u);
+}
+
+// ----------- TileMap -----------
+
+TileMap::TileMap(int widthTiles, int heightTiles, float tileSize,
+                 ChunkSource source, void *context, int maxChunks)
+    : widthTiles(widthTiles), heightTiles(heightTiles),
+      chunksX((widthTiles + TileChunk::size - 1) / TileChunk::size),
+      chunksY((heightTiles + TileChunk::size - 1) / TileChunk::size),
+      tileSize(tileSize), source(source), context(context),
+      maxChunks(std::max(maxChunks, 1)), solid(), chunks(), free(), index(),
+      last(nullptr), clock(0), focusLeft(0), focusTop(0), focusRight(-1),
+      focusBottom(-1), loads(0), evictions(0), tilesTested(0) {
+  for (int id = 0; id < 256; ++id) {
+    solid[id] = id != 0;
+  }
+  chunks.reserve(this->maxChunks);
+  index.reserve(this->maxChunks * 2);
+}
+
+static void BuildMasks(TileChunk &chunk, const bool *solid) {
+  memset(chunk.rows, 0, sizeof(chunk.rows));
+  memset(chunk.columns, 0, sizeof(chunk.columns));
+  for (int y = 0; y < TileChunk::size; ++y) {
+    for (int x = 0; x < TileChunk::size; ++x) {
+      if (solid[chunk.tiles[y * TileChunk::size + x]]) {
+        chunk.rows[y] |= 1u << x;
+        chunk.columns[x] |= 1u << y;
+      }
+    }
+  }
+}
+
+void TileMap::SetSolid(uint8_t id, bool isSolid) {
+  if (solid[id] == isSolid)
+    return;
+  solid[id] = isSolid;
+  for (const auto &entry : index) {
+    BuildMasks(chunks[entry.second], solid);
+  }
+}
+
+TileChunk &TileMap::Chunk(int chunkX, int chunkY) {
+  clock++;
+  if (last && last->chunkX == chunkX && last->chunkY == chunkY) {
+    last->lastUsed = clock;
+    return *last;
+  }
+  auto found = index.find(Key(chunkX, chunkY));
+  int entry;
+  if (found != index.end()) {
+    entry = found->second;
+  } else {
+    if (Resident() >= maxChunks)
+      Evict();
+    if (!free.empty()) {
+      entry = free.back();
+      free.pop_back();
+    } else {
+      // Over budget only when everything resident is pinned
+      entry = (int)chunks.size();
+      chunks.emplace_back();
+    }
+    Load(chunks[entry], chunkX, chunkY);
+    index.emplace(Key(chunkX, chunkY), entry);
+  }
+  last = &chunks[entry];
+  last->lastUsed = clock;
+  return *last;
+}
+
+void TileMap::Load(TileChunk &chunk, int chunkX, int chunkY) {
+  chunk.chunkX = chunkX;
+  chunk.chunkY = chunkY;
+  chunk.edited = false;
+  memset(chunk.tiles, 0, sizeof(chunk.tiles));
+  source(context, chunkX, chunkY, chunk.tiles);
+  BuildMasks(chunk, solid);
+  loads++;
+}
+
+bool TileMap::InFocus(const TileChunk &chunk) const {
+  return chunk.chunkX >= focusLeft && chunk.chunkX <= focusRight &&
+         chunk.chunkY >= focusTop && chunk.chunkY <= focusBottom;
+}
+
+void TileMap::Evict() {
+  // A scan, but only on a load, and over a few hundred chunks
+  auto oldest = index.end();
+  for (auto entry = index.begin(); entry != index.end(); ++entry) {
+    const TileChunk &chunk = chunks[entry->second];
+    if (chunk.edited || InFocus(chunk))
+      continue;
+    if (oldest == index.end() ||
+        chunk.lastUsed < chunks[oldest->second].lastUsed)
+      oldest = entry;
+  }
+  if (oldest == index.end())
+    return; // All pinned: the pool grows instead
+  if (last == &chunks[oldest->second])
+    last = nullptr;
+  free.push_back(oldest->second);
+  index.erase(oldest);
+  evictions++;
+}
+
+uint8_t TileMap::Tile(int x, int y) {
+  if (x < 0 || y < 0 || x >= widthTiles || y >= heightTiles)
+    return 0;
+  const TileChunk &chunk =
+      Chunk(x / TileChunk::size, y / TileChunk::size);
+  return chunk.tiles[(y % TileChunk::size) * TileChunk::size +
+                     x % TileChunk::size];
+}
+
+bool TileMap::IsSolid(int x, int y) {
+  if (x < 0 || y < 0 || x >= widthTiles || y >= heightTiles)
+    return true;
+  const TileChunk &chunk =
+      Chunk(x / TileChunk::size, y / TileChunk::size);
+  return chunk.rows[y % TileChunk::size] >> (x % TileChunk::size) & 1u;
+}
+
+void TileMap::SetTile(int x, int y, uint8_t id) {
+  if (x < 0 || y < 0 || x >= widthTiles || y >= heightTiles)
+    return;
+  TileChunk &chunk = Chunk(x / TileChunk::size, y / TileChunk::size);
+  int localX = x % TileChunk::size, localY = y % TileChunk::size;
+  chunk.tiles[localY * TileChunk::size + localX] = id;
+  chunk.rows[localY] &= ~(1u << localX);
+  chunk.columns[localX] &= ~(1u << localY);
+  if (solid[id]) {
+    chunk.rows[localY] |= 1u << localX;
+    chunk.columns[localX] |= 1u << localY;
+  }
+  chunk.edited = true; // The source can't make it again
+}
+
+void TileMap::Focus(const WorldBox &view, double margin) {
+  double chunkPixels = (double)tileSize * TileChunk::size;
+  focusLeft = std::max((int)floor((view.x - margin) / chunkPixels), 0);
+  focusTop = std::max((int)floor((view.y - margin) / chunkPixels), 0);
+  focusRight = std::min(
+      (int)floor((view.x + view.width + margin) / chunkPixels), chunksX - 1);
+  focusBottom = std::min(
+      (int)floor((view.y + view.height + margin) / chunkPixels), chunksY - 1);
+  for (int chunkY = focusTop; chunkY <= focusBottom; ++chunkY) {
+    for (int chunkX = focusLeft; chunkX <= focusRight; ++chunkX) {
+      Chunk(chunkX, chunkY);
+    }
+  }
+}
+
+bool TileMap::ColumnBlocked(int x, int top, int bottom) {
+  if (x < 0 || x >= widthTiles || top < 0 || bottom >= heightTiles)
+    return true;
+  int chunkX = x / TileChunk::size, localX = x % TileChunk::size;
+  for (int y = top; y <= bottom;) {
+    int end = std::min(bottom, (y / TileChunk::size + 1) * TileChunk::size - 1);
+    const TileChunk &chunk = Chunk(chunkX, y / TileChunk::size);
+    tilesTested += end - y + 1;
+    if (chunk.columns[localX] &
+        BitRange(y % TileChunk::size, end % TileChunk::size))
+      return true;
+    y = end + 1;
+  }
+  return false;
+}
+
+bool TileMap::RowBlocked(int y, int left, int right) {
+  if (y < 0 || y >= heightTiles || left < 0 || right >= widthTiles)
+    return true;
+  int chunkY = y / TileChunk::size, localY = y % TileChunk::size;
+  for (int x = left; x <= right;) {
+    int end = std::min(right, (x / TileChunk::size + 1) * TileChunk::size - 1);
+    const TileChunk &chunk = Chunk(x / TileChunk::size, chunkY);
+    tilesTested += end - x + 1;
+    if (chunk.rows[localY] &
+        BitRange(x % TileChunk::size, end % TileChunk::size))
+      return true;
+    x = end + 1;
+  }
+  return false;
+}
+
+double TileMap::SweepX(const WorldBox &box, double dx, bool &hit) {
+  hit = false;
+  if (dx == 0.0)
+    return 0.0;
+  double size = tileSize;
+  // The rows the box spans; the columns its leading edge crosses
+  int top = (int)floor(box.y / size + edgeEpsilon);
+  int bottom = (int)ceil((box.y + box.height) / size - edgeEpsilon) - 1;
+  if (dx > 0.0) {
+    double right = box.x + box.width;
+    int first = (int)ceil(right / size - edgeEpsilon);
+    int lastColumn = (int)ceil((right + dx) / size - edgeEpsilon) - 1;
+    for (int x = first; x <= lastColumn; ++x) {
+      if (ColumnBlocked(x, top, bottom)) {
+        hit = true;
+        return x * size - right;
+      }
+    }
+  } else {
+    double left = box.x;
+    int first = (int)floor(left / size + edgeEpsilon) - 1;
+    int lastColumn = (int)floor((left + dx) / size + edgeEpsilon);
+    for (int x = first; x >= lastColumn; --x) {
+      if (ColumnBlocked(x, top, bottom)) {
+        hit = true;
+        return (x + 1) * size - left;
+      }
+    }
+  }
+  return dx;
+}
+
+double TileMap::SweepY(const WorldBox &box, double dy, bool &hit) {
+  hit = false;
+  if (dy == 0.0)
+    return 0.0;
+  double size = tileSize;
+  int left = (int)floor(box.x / size + edgeEpsilon);
+  int right = (int)ceil((box.x + box.width) / size - edgeEpsilon) - 1;
+  if (dy > 0.0) {
+    double bottom = box.y + box.height;
+    int first = (int)ceil(bottom / size - edgeEpsilon);
+    int lastRow = (int)ceil((bottom + dy) / size - edgeEpsilon) - 1;
+    for (int y = first; y <= lastRow; ++y) {
+      if (RowBlocked(y, left, right)) {
+        hit = true;
+        return y * size - bottom;
+      }
+    }
+  } else {
+    double top = box.y;
+    int first = (int)floor(top / size + edgeEpsilon) - 1;
+    int lastRow = (int)floor((top + dy) / size + edgeEpsilon);
+    for (int y = first; y >= lastRow; --y) {
+      if (RowBlocked(y, left, right)) {
+        hit = true;
+        return (y + 1) * size - top;
+      }
+    }
+  }
+  return dy;
+}
+
+TileSweep TileMap::Sweep(const WorldBox &box, double dx, double dy) {
+  TileSweep result = {box.x, box.y, false, false};
+  result.x += SweepX(box, dx, result.hitX);
+  WorldBox moved = {result.x, box.y, box.width, box.height};
+  result.y += SweepY(moved, dy, result.hitY);
+  return result;
+}
+
+bool TileMap::Overlaps(const WorldBox &box) {
+  double size = tileSize;
+  int left = (int)floor(box.x / size + edgeEpsilon);
+  int right = (int)ceil((box.x + box.width) / size - edgeEpsilon) - 1;
+  int top = (int)floor(box.y / size + edgeEpsilon);
+  int bottom = (int)ceil((box.y + box.height) / size - edgeEpsilon) - 1;
+  for (int x = left; x <= right; ++x) {
+    if (ColumnBlocked(x, top, bottom))
+      return true;
+  }
+  return false;
+}
+
+size_t TileMap::ResidentBytes() const {
+  // Node-based map: a node (key, value, next pointer, cached hash) per
+  // chunk, plus the bucket array
+  size_t node = sizeof(std::pair<const uint64_t, int>) + 2 * sizeof(void *);
+  return chunks.capacity() * sizeof(TileChunk) +
+         free.capacity() * sizeof(int) + index.size() * node +
+         index.bucket_count() * sizeof(void *);
+}
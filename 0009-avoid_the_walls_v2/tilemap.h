@@ -0,0 +1,126 @@
+// tilemap.h
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// ----------- WorldBox -----------
+// An axis-aligned box in world pixels. Doubles, not raylib's floats: a
+// million 16 px tiles is past 2^24, where a float steps by whole pixels.
+struct WorldBox {
+  double x, y, width, height;
+};
+
+// ----------- TileSweep -----------
+// Where a box moved to, and which axes stopped against a solid tile
+struct TileSweep {
+  double x, y;
+  bool hitX, hitY;
+};
+
+// ----------- TileChunk -----------
+// 32x32 tiles: their ids, and which are solid as bitmasks both ways, so
+// a sweep tests a whole edge of the box in one AND
+struct TileChunk {
+  static const int size = 32; // Tiles per edge
+
+  int chunkX, chunkY;
+  uint32_t rows[size];    // Bit x of rows[y]: tile (x, y) is solid
+  uint32_t columns[size]; // Bit y of columns[x]: the same, transposed
+  uint8_t tiles[size * size]; // Row-major ids; 0 is empty
+  uint64_t lastUsed;          // TileMap's clock, for eviction
+  bool edited;                // Changed by SetTile: never evicted
+};
+
+// ----------- TileMap -----------
+// Manages: a world of tiles far bigger than memory, for scrolling games
+// Should Own:
+//   - Chunks, made on first use by a ChunkSource and evicted, least
+//     recently used first, once more than 'maxChunks' are resident.
+//     Chunks around the camera (Focus) and edited chunks stay.
+//   - Which tiles are solid (by id)
+//   - Swept collision: a box moves along x, then along y, stopping at the
+//     first solid tile on the way. Only the tile columns (rows) the
+//     moving edge crosses are tested, so speed can't tunnel through a
+//     wall and a short move tests a few tiles. Outside the world is
+//     solid.
+// Should Not:
+//   - Draw anything, or know where the camera is beyond what it's told
+//   - Decide what a collision means (the PhysicsEngine does)
+class TileMap {
+public:
+  // Fills one chunk's tiles (row-major, TileChunk::size squared) for the
+  // chunk at (chunkX, chunkY); the same chunk must get the same tiles
+  // every time, since an evicted chunk is made again
+  typedef void (*ChunkSource)(void *context, int chunkX, int chunkY,
+                              uint8_t *tiles);
+
+  TileMap(int widthTiles, int heightTiles, float tileSize,
+          ChunkSource source, void *context, int maxChunks = 256);
+
+  int WidthTiles() const { return widthTiles; }
+  int HeightTiles() const { return heightTiles; }
+  float TileSize() const { return tileSize; }
+
+  // Which ids block movement; by default every id but 0
+  void SetSolid(uint8_t id, bool solid);
+  uint8_t Tile(int x, int y);   // 0 outside the world
+  bool IsSolid(int x, int y);   // True outside the world
+  void SetTile(int x, int y, uint8_t id); // Ignored outside the world
+
+  // Loads the chunks within 'margin' pixels of 'view' (the camera's
+  // rectangle, world pixels) and keeps them resident until the next
+  // Focus; queries elsewhere still load what they touch
+  void Focus(const WorldBox &view, double margin);
+
+  // Moves 'box' by (dx, dy), x first; it must not start inside a solid
+  // tile. A stopped axis ends touching the tile.
+  TileSweep Sweep(const WorldBox &box, double dx, double dy);
+  // True when 'box' overlaps a solid tile
+  bool Overlaps(const WorldBox &box);
+
+  int Resident() const { return (int)index.size(); }
+  long long Loads() const { return loads; }
+  long long Evictions() const { return evictions; }
+  long long TilesTested() const { return tilesTested; }
+  // Chunks plus the lookup table, in bytes
+  size_t ResidentBytes() const;
+
+private:
+  int widthTiles;
+  int heightTiles;
+  int chunksX; // Chunks across, rounded up
+  int chunksY;
+  float tileSize;
+  ChunkSource source;
+  void *context;
+  int maxChunks;
+  bool solid[256];
+
+  std::vector<TileChunk> chunks; // Pool; 'free' lists unused entries
+  std::vector<int> free;
+  std::unordered_map<uint64_t, int> index; // Chunk key -> pool entry
+  TileChunk *last;                         // The last chunk looked up
+  uint64_t clock;
+  int focusLeft, focusTop, focusRight, focusBottom; // Chunks, inclusive
+
+  long long loads;
+  long long evictions;
+  long long tilesTested;
+
+  static uint64_t Key(int chunkX, int chunkY) {
+    return (uint64_t)(uint32_t)chunkX << 32 | (uint32_t)chunkY;
+  }
+  TileChunk &Chunk(int chunkX, int chunkY); // Loads it if needed
+  void Load(TileChunk &chunk, int chunkX, int chunkY);
+  void Evict();
+  bool InFocus(const TileChunk &chunk) const;
+  // Solid tiles in column 'x', rows top..bottom (inclusive); any?
+  bool ColumnBlocked(int x, int top, int bottom);
+  bool RowBlocked(int y, int left, int right);
+  double SweepX(const WorldBox &box, double dx, bool &hit);
+  double SweepY(const WorldBox &box, double dy, bool &hit);
+};
@@ -0,0 +1,181 @@
+// timer_wheel.cpp
+
+#include "timer_wheel.h"
+#include <cmath>
+
+static const uint32_t noNode = 0xFFFFFFFFu;
+
+// Times within this fraction of a tick of a boundary count as on it, so
+// float round-off in a caller's clock or delay can't cost a whole tick
+static const double tickSlack = 1e-3;
+
+// ----------- TimerWheel -----------
+
+TimerWheel::TimerWheel(int ticksPerSecond, int capacity)
+    : ticksPerSecond(ticksPerSecond > 0 ? ticksPerSecond : 1000),
+      freeList(noNode), current(0), count(0), fired(0) {
+  nodes.resize(firstNode);
+  for (uint32_t list = 0; list < firstNode; ++list) {
+    nodes[list].prev = list; // Empty circular list
+    nodes[list].next = list;
+  }
+  nodes.reserve(firstNode + (capacity > 0 ? capacity : 1));
+}
+
+uint32_t TimerWheel::Allocate() {
+  if (freeList == noNode) {
+    // Doubling keeps Schedule amortized O(1); handles are indices, so
+    // they survive the move
+    uint32_t start = (uint32_t)nodes.size();
+    uint32_t grow = start - firstNode > 64 ? start - firstNode : 64;
+    nodes.resize(start + grow);
+    for (uint32_t i = start + grow; i-- > start;) {
+      nodes[i].generation = 1;
+      nodes[i].next = freeList;
+      freeList = i;
+    }
+  }
+  uint32_t index = freeList;
+  freeList = nodes[index].next;
+  return index;
+}
+
+void TimerWheel::Release(uint32_t index) {
+  nodes[index].generation++; // Invalidates outstanding handles
+  nodes[index].next = freeList;
+  freeList = index;
+}
+
+void TimerWheel::Link(uint32_t list, uint32_t index) {
+  uint32_t last = nodes[list].prev;
+  nodes[index].prev = last;
+  nodes[index].next = list;
+  nodes[last].next = index;
+  nodes[list].prev = index;
+}
+
+void TimerWheel::Unlink(uint32_t index) {
+  Node &node = nodes[index];
+  nodes[node.prev].next = node.next;
+  nodes[node.next].prev = node.prev;
+}
+
+void TimerWheel::Insert(uint32_t index) {
+  uint64_t expiry = nodes[index].expiry;
+  uint64_t delta = expiry - current;
+  int level = 0;
+  while (level < levels - 1 && delta >= (1ull << (slotBits * (level + 1)))) {
+    level++;
+  }
+  uint32_t slot = (uint32_t)(expiry >> (slotBits * level)) & (slots - 1);
+  Link(level * slots + slot, index);
+}
+
+TimerHandle TimerWheel::Schedule(double delaySeconds, Callback callback,
+                                 void *context, uint64_t data) {
+  // Round up so a timer never fires early; the farthest timer fits in the
+  // top level's range
+  double ticks = std::ceil(delaySeconds * ticksPerSecond - tickSlack);
+  const double maxTicks = (double)((1ull << (slotBits * levels)) - 1);
+  uint64_t delay = ticks < 1.0 ? 1 : (ticks > maxTicks ? (uint64_t)maxTicks
+                                                       : (uint64_t)ticks);
+  uint32_t index = Allocate();
+  Node &node = nodes[index];
+  node.expiry = current + delay;
+  node.callback = callback;
+  node.context = context;
+  node.data = data;
+  Insert(index);
+  count++;
+  return {index, node.generation};
+}
+
+bool TimerWheel::Pending(TimerHandle handle) const {
+  return handle.index >= firstNode && handle.index < nodes.size() &&
+         nodes[handle.index].generation == handle.generation;
+}
+
+bool TimerWheel::Cancel(TimerHandle handle) {
+  if (!Pending(handle))
+    return false;
+  Unlink(handle.index);
+  Release(handle.index);
+  count--;
+  return true;
+}
+
+double TimerWheel::TimeLeft(TimerHandle handle) const {
+  if (!Pending(handle))
+    return 0.0;
+  return (nodes[handle.index].expiry - current) / (double)ticksPerSecond;
+}
+
+void TimerWheel::Tick() {
+  uint64_t tick = ++current;
+
+  // When a level's lower bits wrap, its next coarse slot moves down
+  for (int level = 1; level < levels; ++level) {
+    if (tick & ((1ull << (slotBits * level)) - 1))
+      break;
+    uint32_t list = level * slots +
+                    ((uint32_t)(tick >> (slotBits * level)) & (slots - 1));
+    uint32_t index = nodes[list].next;
+    nodes[list].prev = nodes[list].next = list;
+    while (index != list) {
+      uint32_t next = nodes[index].next;
+      Insert(index);
+      index = next;
+    }
+  }
+
+  // Move this tick's slot to the firing list, then run it as one
+  // batch. A callback may cancel a timer further down the batch (it is
+  // unlinked like anywhere else) or schedule new ones (they land in later
+  // slots).
+  uint32_t list = (uint32_t)(tick & (slots - 1));
+  if (nodes[list].next == list)
+    return;
+  uint32_t first = nodes[list].next, last = nodes[list].prev;
+  nodes[list].prev = nodes[list].next = list;
+  nodes[first].prev = firingList;
+  nodes[last].next = firingList;
+  nodes[firingList].next = first;
+  nodes[firingList].prev = last;
+
+  while (nodes[firingList].next != firingList) {
+    uint32_t index = nodes[firingList].next;
+    Unlink(index);
+    Callback callback = nodes[index].callback;
+    void *context = nodes[index].context;
+    uint64_t data = nodes[index].data;
+    Release(index);
+    count--;
+    fired++;
+    callback(context, data);
+  }
+}
+
+void TimerWheel::Advance(double now) {
+  double ticks = std::floor(now * ticksPerSecond + tickSlack);
+  uint64_t target = ticks < 0.0 ? 0 : (uint64_t)ticks;
+  while (current < target) {
+    if (count == 0) {
+      current = target; // Nothing can fire, skip straight there
+      break;
+    }
+    Tick();
+  }
+}
+
+void TimerWheel::Clear() {
+  for (uint32_t list = 0; list < firingList; ++list) {
+    uint32_t index = nodes[list].next;
+    while (index != list) {
+      uint32_t next = nodes[index].next;
+      Release(index);
+      index = next;
+    }
+    nodes[list].prev = nodes[list].next = list;
+  }
+  count = 0;
+}
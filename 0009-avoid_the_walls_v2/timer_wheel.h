@@ -0,0 +1,81 @@
+// timer_wheel.h
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// ----------- TimerHandle -----------
+// Names one scheduled timer; stays safe to use after the timer fired or
+// was cancelled (the generation no longer matches)
+struct TimerHandle {
+  uint32_t index = 0;
+  uint32_t generation = 0;
+};
+
+// ----------- TimerWheel -----------
+// Manages: one-shot timers on the simulation clock
+// Should Own:
+//   - A hierarchical timing wheel: 4 levels of 256 slots (2^32 ticks of
+//     range, about 49 days at the default 1 ms tick); far timers sit in
+//     coarse slots and cascade down as their time gets close
+//   - O(1) Schedule and Cancel (intrusive doubly linked lists in a pooled
+//     node array, no allocation per timer once the pool has grown)
+//   - Firing every timer that falls due in a tick as one batch
+// Should Not:
+//   - Read the wall clock (Advance is given simulation time, so timers
+//     replay exactly with the simulation)
+//   - Know what the callbacks do
+class TimerWheel {
+public:
+  typedef void (*Callback)(void *context, uint64_t data);
+
+  // 'capacity' is the initial pool size (it grows)
+  explicit TimerWheel(int ticksPerSecond = 1000, int capacity = 64);
+
+  // Fires 'callback(context, data)' once the clock passes now + delay,
+  // rounded up to whole ticks. A delay of zero fires on the next tick.
+  TimerHandle Schedule(double delaySeconds, Callback callback, void *context,
+                       uint64_t data);
+  bool Cancel(TimerHandle handle); // False if it already fired
+  bool Pending(TimerHandle handle) const;
+  double TimeLeft(TimerHandle handle) const; // Seconds, 0 if not pending
+
+  // Moves the clock to 'now' (seconds), firing everything due on the way
+  void Advance(double now);
+  void Clear(); // Drops every timer, keeps the clock
+
+  double Now() const { return current / (double)ticksPerSecond; }
+  int Count() const { return count; }
+  long long Fired() const { return fired; }
+
+private:
+  static const int levels = 4;
+  static const int slotBits = 8;
+  static const int slots = 1 << slotBits;
+  static const uint32_t firingList = levels * slots; // Sentinel index
+  static const uint32_t firstNode = firingList + 1;  // Sentinels come first
+
+  struct Node {
+    uint64_t expiry; // Tick
+    uint32_t prev, next;
+    uint32_t generation;
+    Callback callback;
+    void *context;
+    uint64_t data;
+  };
+
+  int ticksPerSecond;
+  std::vector<Node> nodes; // Sentinels, then timers
+  uint32_t freeList;       // Unused timer nodes, linked through 'next'
+  uint64_t current;        // Last tick processed
+  int count;
+  long long fired;
+
+  uint32_t Allocate();
+  void Release(uint32_t index);
+  void Link(uint32_t list, uint32_t index); // Appends to a sentinel's list
+  void Unlink(uint32_t index);
+  void Insert(uint32_t index); // Puts a node in the slot for its expiry
+  void Tick();                 // Processes tick current + 1
+};
@@ -0,0 +1,187 @@
+// trace.cpp
+
+#include "trace.h"
+#include <chrono>
+
+std::atomic<bool> traceEnabled(false);
+
+static const TraceEventInfo eventInfo[TraceEventCount] = {
+    {nullptr, nullptr},
+    {"round_start", "countdown:f"},
+    {"countdown_end", ""},
+    {"step", "x:f y:f speed:f dir:d sim_ms:u"},
+    {"input", "key:i latency_us:u speed:f dir:d"},
+    {"reset", "x:f y:f dir:d"},
+    {"wall_hit", "x:f y:f speed:f dir:d wall:w"},
+    {"game_over", "elapsed:f"},
+};
+
+const TraceEventInfo *TraceEventLookup(uint16_t event) {
+  return event > 0 && event < TraceEventCount ? &eventInfo[event] : nullptr;
+}
+
+int FormatTraceRecord(const TraceRecord &record, char *out, size_t size) {
+  static const char *directions[] = {"up", "down", "left", "right", "none"};
+  static const char *walls[] = {"left", "right", "top", "bottom", "none"};
+  const TraceEventInfo *info = TraceEventLookup(record.event);
+  size_t length = (size_t)snprintf(out, size, "%10llu  t%-2u %-14s",
+                                   (unsigned long long)record.tick,
+                                   (unsigned)record.thread,
+                                   info ? info->name : "?");
+  if (!info) {
+    length += snprintf(out + length, length < size ? size - length : 0,
+                       " event=%u", (unsigned)record.event);
+    return (int)(length < size ? length : size - 1);
+  }
+
+  // "name:type name:type ...", one per argument
+  const char *spec = info->args;
+  for (int arg = 0; arg < 5 && *spec && length < size; ++arg) {
+    const char *colon = strchr(spec, ':');
+    if (!colon)
+      break;
+    int nameLength = (int)(colon - spec);
+    char type = colon[1];
+    uint32_t bits = record.args[arg];
+    char value[32];
+    switch (type) {
+    case 'f': {
+      float f;
+      memcpy(&f, &bits, sizeof(f));
+      snprintf(value, sizeof(value), "%.2f", f);
+      break;
+    }
+    case 'i':
+      snprintf(value, sizeof(value), "%d", (int)bits);
+      break;
+    case 'd':
+      snprintf(value, sizeof(value), "%s", directions[bits < 4 ? bits : 4]);
+      break;
+    case 'w':
+      snprintf(value, sizeof(value), "%s", walls[bits < 4 ? bits : 4]);
+      break;
+    default:
+      snprintf(value, sizeof(value), "%u", bits);
+      break;
+    }
+    length += snprintf(out + length, size - length, " %.*s=%s", nameLength,
+                       spec, value);
+    spec = colon + 2;
+    while (*spec == ' ')
+      spec++;
+  }
+  return (int)(length < size ? length : size - 1);
+}
+
+// ----------- TraceFile -----------
+
+TraceFile::TraceFile()
+    : file(nullptr), rings{}, ringCount(0), written(0), unattached(0),
+      stopping(false) {}
+
+TraceFile::~TraceFile() {
+  Close();
+  for (int i = 0; i < ringCount.load(); ++i) {
+    delete rings[i];
+  }
+}
+
+bool TraceFile::Open(const char *path) {
+#ifdef PLATFORM_WEB
+  (void)path;
+  return false; // No threads for the flusher
+#else
+  Close();
+  file = fopen(path, "wb");
+  if (!file)
+    return false;
+  TraceFileHeader header = {traceMagic, traceVersion,
+                            (uint32_t)sizeof(TraceRecord), 0};
+  if (fwrite(&header, sizeof(header), 1, file) != 1) {
+    fclose(file);
+    file = nullptr;
+    return false;
+  }
+  stopping = false;
+  thread = std::thread(&TraceFile::Flush, this);
+  traceEnabled.store(true);
+  return true;
+#endif
+}
+
+void TraceFile::Close() {
+  if (!file)
+    return;
+  traceEnabled.store(false);
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_one();
+  thread.join(); // Its last pass drains every ring
+  fclose(file);
+  file = nullptr;
+}
+
+long long TraceFile::Dropped() const {
+  long long dropped = unattached.load();
+  for (int i = 0; i < ringCount.load(); ++i) {
+    dropped += (long long)rings[i]->dropped.load(std::memory_order_relaxed);
+  }
+  return dropped;
+}
+
+TraceRing *TraceFile::AttachThread() {
+  std::lock_guard<std::mutex> lock(mutex);
+  int count = ringCount.load();
+  if (count == maxThreads) {
+    unattached++;
+    return nullptr;
+  }
+  // Rings outlive their threads (and Close), so a thread's cached
+  // pointer never dangles; they go with the log
+  TraceRing *ring = new TraceRing();
+  ring->thread = (uint16_t)count;
+  rings[count] = ring;
+  ringCount.store(count + 1); // Publishes the ring to the flush thread
+  return ring;
+}
+
+void TraceFile::Flush() {
+  std::unique_lock<std::mutex> lock(mutex);
+  for (;;) {
+    bool last = wake.wait_for(lock, std::chrono::milliseconds(flushMs),
+                              [this]() { return stopping; });
+    int count = ringCount.load();
+    lock.unlock(); // Writing the file must not hold up AttachThread
+    for (int i = 0; i < count; ++i) {
+      FlushRing(*rings[i]);
+    }
+    fflush(file); // Into the OS, so a crash of the game keeps it
+    lock.lock();
+    if (last)
+      return;
+  }
+}
+
+void TraceFile::FlushRing(TraceRing &ring) {
+  uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+  uint32_t head = ring.head.load(std::memory_order_acquire);
+  uint32_t pending = head - tail;
+  if (pending == 0)
+    return;
+  // At most two runs: up to the end of the array, then from its start
+  uint32_t start = tail & (TraceRing::capacity - 1);
+  uint32_t first = TraceRing::capacity - start;
+  if (first > pending)
+    first = pending;
+  fwrite(&ring.records[start], sizeof(TraceRecord), first, file);
+  fwrite(&ring.records[0], sizeof(TraceRecord), pending - first, file);
+  ring.tail.store(head, std::memory_order_release);
+  written += pending;
+}
+
+TraceFile &GameTrace() {
+  static TraceFile log;
+  return log;
+}
@@ -0,0 +1,191 @@
+// trace.h
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+// Trace file layout (little-endian):
+//   TraceFileHeader
+//   TraceRecord..., each thread's records in the order it wrote them
+// Threads are flushed one after another, so records from different
+// threads interleave in chunks; sort by tick to merge them.
+
+const uint32_t traceMagic = 0x52545741u; // "AWTR"
+const uint32_t traceVersion = 1;
+
+// What happened. Append only: the number is what the file stores.
+enum TraceEventId : uint16_t {
+  TraceRoundStart = 1, // A countdown began
+  TraceCountdownEnd,   // Play started
+  TraceStep,           // One Step, with where the player ended up
+  TraceInput,          // A press applied by the simulation
+  TraceReset,          // The player was put back in the middle
+  TraceWallHit,        // PhysicsEngine ended the run
+  TraceGameOver,       // The round sequence saw the game over
+  TraceEventCount
+};
+
+struct TraceFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t recordSize;
+  uint32_t reserved;
+};
+
+struct TraceRecord {
+  uint64_t tick;    // Game::tickCount when it happened
+  uint16_t event;   // TraceEventId
+  uint16_t thread;  // Which ring wrote it (first thread to trace is 0)
+  uint32_t args[5]; // Packed by TraceArg, decoded by TraceEventInfo
+};
+
+// ----------- TraceArg -----------
+// One 32-bit argument: ints as they are, floats by their bits
+struct TraceArg {
+  uint32_t bits;
+  TraceArg() : bits(0) {}
+  TraceArg(int value) : bits((uint32_t)value) {}
+  TraceArg(unsigned value) : bits(value) {}
+  TraceArg(bool value) : bits(value ? 1u : 0u) {}
+  TraceArg(float value) { memcpy(&bits, &value, sizeof(bits)); }
+  TraceArg(double value) : TraceArg((float)value) {}
+};
+
+// ----------- TraceEventInfo -----------
+// How the decoder prints an event: its name and up to five "name:type"
+// arguments, types being i (int), u (unsigned), f (float), d (direction)
+// and w (wall)
+struct TraceEventInfo {
+  const char *name;
+  const char *args;
+};
+
+const TraceEventInfo *TraceEventLookup(uint16_t event); // Null if unknown
+// One line of text, without the newline; returns its length
+int FormatTraceRecord(const TraceRecord &record, char *out, size_t size);
+
+// The direction argument type, from a unit move vector
+inline int TraceDirection(float x, float y) {
+  return y < 0.0f ? 0 : y > 0.0f ? 1 : x < 0.0f ? 2 : x > 0.0f ? 3 : 4;
+}
+
+// The wall argument type: the side of the player that hit, from the axes
+// the move was stopped on and the move along them
+inline int TraceWall(bool hitX, bool hitY, float dx, float dy) {
+  return hitX ? (dx < 0.0f ? 0 : 1) : hitY ? (dy < 0.0f ? 2 : 3) : 4;
+}
+
+// ----------- TraceRing -----------
+// Manages: one thread's unflushed records
+// Should Own:
+//   - A fixed ring, written by its thread and read by the flush thread
+//     (single producer, single consumer, no locks)
+//   - Counting records dropped because the flush thread fell behind
+// Should Not:
+//   - Be written by any thread but the one it was handed to
+struct TraceRing {
+  static const uint32_t capacity = 8192; // Power of two, 256 KiB
+
+  alignas(64) std::atomic<uint32_t> head{0}; // Written by the producer
+  uint32_t tailSeen = 0; // The producer's last look at 'tail'
+  std::atomic<uint64_t> dropped{0};
+  alignas(64) std::atomic<uint32_t> tail{0}; // Written by the flush thread
+  uint16_t thread = 0;
+  TraceRecord records[capacity];
+
+  bool Push(uint16_t event, uint64_t tick, TraceArg a0, TraceArg a1,
+            TraceArg a2, TraceArg a3, TraceArg a4) {
+    uint32_t at = head.load(std::memory_order_relaxed);
+    if (at - tailSeen == capacity) {
+      tailSeen = tail.load(std::memory_order_acquire);
+      if (at - tailSeen == capacity) {
+        dropped.store(dropped.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+        return false;
+      }
+    }
+    TraceRecord &record = records[at & (capacity - 1)];
+    record.tick = tick;
+    record.event = event;
+    record.thread = thread;
+    record.args[0] = a0.bits;
+    record.args[1] = a1.bits;
+    record.args[2] = a2.bits;
+    record.args[3] = a3.bits;
+    record.args[4] = a4.bits;
+    head.store(at + 1, std::memory_order_release);
+    return true;
+  }
+};
+
+// ----------- TraceFile -----------
+// Manages: the process's binary trace file
+// Should Own:
+//   - Handing each tracing thread its own TraceRing, once
+//   - A flush thread that copies the rings to the file every
+//     flushMs, so a crash loses at most that much
+// Should Not:
+//   - Format text (that is the decoder's job, see trace/)
+//   - Make a tracing thread wait: a full ring drops the record
+class TraceFile {
+public:
+  static const int maxThreads = 32; // Later threads trace nothing
+  static const int flushMs = 10;
+
+  TraceFile();
+  ~TraceFile(); // Closes
+  TraceFile(const TraceFile &) = delete;
+  TraceFile &operator=(const TraceFile &) = delete;
+
+  // False if the file can't be created or the platform has no threads
+  // (web)
+  bool Open(const char *path);
+  // Stops tracing and writes what's left. Call it once the tracing
+  // threads are done: a record being written during Close may be lost.
+  void Close();
+  bool IsOpen() const { return file != nullptr; }
+
+  long long Written() const { return written.load(); }
+  long long Dropped() const; // Ring full, or too many threads
+
+  TraceRing *AttachThread(); // Null when out of rings
+
+private:
+  FILE *file;
+  TraceRing *rings[maxThreads];
+  std::atomic<int> ringCount;
+  std::atomic<long long> written;
+  std::atomic<long long> unattached;
+  std::mutex mutex; // Attaching threads and waking the flush thread
+  std::condition_variable wake;
+  bool stopping;
+  std::thread thread;
+
+  void Flush();
+  void FlushRing(TraceRing &ring);
+};
+
+// The one log Trace() writes to
+TraceFile &GameTrace();
+
+// Set while GameTrace() is open, so tracing costs one load otherwise
+extern std::atomic<bool> traceEnabled;
+
+// Records one event from the calling thread. The first call on a thread
+// takes a ring (under a lock); every later one is a few stores.
+inline void Trace(TraceEventId event, uint64_t tick, TraceArg a0 = {},
+                  TraceArg a1 = {}, TraceArg a2 = {}, TraceArg a3 = {},
+                  TraceArg a4 = {}) {
+  if (!traceEnabled.load(std::memory_order_relaxed))
+    return;
+  static thread_local TraceRing *ring = nullptr;
+  if (!ring && !(ring = GameTrace().AttachThread()))
+    return;
+  ring->Push(event, tick, a0, a1, a2, a3, a4);
+}
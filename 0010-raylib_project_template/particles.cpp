@@ -0,0 +1,164 @@
+// particles.cpp
+
+#include "particles.h"
+#include "raylib.h"
+#include "rlgl.h"
+#include <cmath>
+#include <cstring>
+
+// 4-wide float vector; GCC/Clang lower this to SSE on desktop and to
+// wasm simd128 (or scalar code) on the web build
+typedef float float4 __attribute__((vector_size(16)));
+
+static inline float4 Load4(const float *p) {
+  float4 v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline void Store4(float *p, float4 v) { std::memcpy(p, &v, sizeof(v)); }
+
+static inline unsigned char ToByte(float c) {
+  return (unsigned char)(c < 0.0f ? 0.0f : (c > 255.0f ? 255.0f : c));
+}
+
+// ----------- ParticleSystem -----------
+
+ParticleSystem::ParticleSystem(int capacity)
+    : gravity{0.0f, 0.0f}, drag(0.0f), capacity(capacity), count(0),
+      seed(0x9E3779B9u) {
+  size_t padded = (size_t)((capacity + 3) & ~3);
+  for (std::vector<float> *array :
+       {&posX, &posY, &velX, &velY, &life, &size, &colR, &colG, &colB, &colA,
+        &fadeR, &fadeG, &fadeB, &fadeA}) {
+    array->assign(padded, 0.0f);
+  }
+}
+
+float ParticleSystem::Random01() {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return (seed >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticleSystem::Emit(const ParticleEmitter &emitter, int amount) {
+  if (amount > capacity - count)
+    amount = capacity - count;
+
+  for (int n = 0; n < amount; ++n) {
+    int i = count++;
+    float angle = emitter.angle + (Random01() - 0.5f) * emitter.spread;
+    float speed =
+        emitter.minSpeed + Random01() * (emitter.maxSpeed - emitter.minSpeed);
+    float span =
+        emitter.minLife + Random01() * (emitter.maxLife - emitter.minLife);
+    float invSpan = 1.0f / fmaxf(span, 0.001f);
+
+    posX[i] = emitter.position.x;
+    posY[i] = emitter.position.y;
+    velX[i] = cosf(angle) * speed;
+    velY[i] = sinf(angle) * speed;
+    life[i] = span;
+    size[i] = emitter.size;
+    colR[i] = emitter.startColor.r;
+    colG[i] = emitter.startColor.g;
+    colB[i] = emitter.startColor.b;
+    colA[i] = emitter.startColor.a;
+    fadeR[i] = (emitter.endColor.r - emitter.startColor.r) * invSpan;
+    fadeG[i] = (emitter.endColor.g - emitter.startColor.g) * invSpan;
+    fadeB[i] = (emitter.endColor.b - emitter.startColor.b) * invSpan;
+    fadeA[i] = (emitter.endColor.a - emitter.startColor.a) * invSpan;
+  }
+}
+
+void ParticleSystem::Stream(ParticleEmitter &emitter, float deltaTime) {
+  emitter.accumulator += emitter.rate * deltaTime;
+  int amount = (int)emitter.accumulator;
+  emitter.accumulator -= amount;
+  Emit(emitter, amount);
+}
+
+void ParticleSystem::Update(float deltaTime) {
+  Integrate(deltaTime);
+  RemoveDead();
+}
+
+void ParticleSystem::Integrate(float deltaTime) {
+  const float damping = fmaxf(0.0f, 1.0f - drag * deltaTime);
+  const float4 dt = {deltaTime, deltaTime, deltaTime, deltaTime};
+  const float4 keep = {damping, damping, damping, damping};
+  const float4 gx = {gravity.x * deltaTime, gravity.x * deltaTime,
+                     gravity.x * deltaTime, gravity.x * deltaTime};
+  const float4 gy = {gravity.y * deltaTime, gravity.y * deltaTime,
+                     gravity.y * deltaTime, gravity.y * deltaTime};
+
+  // Lanes past 'count' hold stale data; updating them is harmless
+  for (int i = 0; i < count; i += 4) {
+    float4 vx = (Load4(&velX[i]) + gx) * keep;
+    float4 vy = (Load4(&velY[i]) + gy) * keep;
+    Store4(&velX[i], vx);
+    Store4(&velY[i], vy);
+    Store4(&posX[i], Load4(&posX[i]) + vx * dt);
+    Store4(&posY[i], Load4(&posY[i]) + vy * dt);
+    Store4(&life[i], Load4(&life[i]) - dt);
+    Store4(&colR[i], Load4(&colR[i]) + Load4(&fadeR[i]) * dt);
+    Store4(&colG[i], Load4(&colG[i]) + Load4(&fadeG[i]) * dt);
+    Store4(&colB[i], Load4(&colB[i]) + Load4(&fadeB[i]) * dt);
+    Store4(&colA[i], Load4(&colA[i]) + Load4(&fadeA[i]) * dt);
+  }
+}
+
+void ParticleSystem::RemoveDead() {
+  // Swap-remove: the last live particle fills the hole, order is not kept
+  int i = 0;
+  while (i < count) {
+    if (life[i] > 0.0f) {
+      i++;
+      continue;
+    }
+    int last = --count;
+    posX[i] = posX[last];
+    posY[i] = posY[last];
+    velX[i] = velX[last];
+    velY[i] = velY[last];
+    life[i] = life[last];
+    size[i] = size[last];
+    colR[i] = colR[last];
+    colG[i] = colG[last];
+    colB[i] = colB[last];
+    colA[i] = colA[last];
+    fadeR[i] = fadeR[last];
+    fadeG[i] = fadeG[last];
+    fadeB[i] = fadeB[last];
+    fadeA[i] = fadeA[last];
+  }
+}
+
+void ParticleSystem::Draw() const {
+  if (count == 0)
+    return;
+
+  // One textured-quad batch for all particles; rlgl flushes on its own
+  // whenever the vertex buffer fills up
+  rlSetTexture(rlGetTextureIdDefault());
+  rlBegin(RL_QUADS);
+  rlNormal3f(0.0f, 0.0f, 1.0f);
+  for (int i = 0; i < count; ++i) {
+    float half = size[i] * 0.5f;
+    float x0 = posX[i] - half, y0 = posY[i] - half;
+    float x1 = posX[i] + half, y1 = posY[i] + half;
+    rlColor4ub(ToByte(colR[i]), ToByte(colG[i]), ToByte(colB[i]),
+               ToByte(colA[i]));
+    rlTexCoord2f(0.0f, 0.0f);
+    rlVertex2f(x0, y0);
+    rlTexCoord2f(0.0f, 1.0f);
+    rlVertex2f(x0, y1);
+    rlTexCoord2f(1.0f, 1.0f);
+    rlVertex2f(x1, y1);
+    rlTexCoord2f(1.0f, 0.0f);
+    rlVertex2f(x1, y0);
+  }
+  rlEnd();
+  rlSetTexture(0);
+}
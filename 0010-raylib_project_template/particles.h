@@ -0,0 +1,75 @@
+// particles.h
+
+#pragma once
+
+#include "raylib.h"
+#include <cstdint>
+#include <vector>
+
+// ----------- ParticleEmitter -----------
+// Describes how new particles are spawned (explosions, exhaust, sparks)
+// Should Own:
+//   - Spawn position, direction cone, speed/life/size ranges, colors
+//   - Continuous emission rate and its leftover fraction
+// Should Not:
+//   - Store particles (ParticleSystem does)
+struct ParticleEmitter {
+  Vector2 position;
+  float angle;       // Center of the emission cone (radians)
+  float spread;      // Full width of the cone (radians, 2*PI = all around)
+  float minSpeed;    // px/sec
+  float maxSpeed;    // px/sec
+  float minLife;     // sec
+  float maxLife;     // sec
+  float size;        // Side of the square drawn per particle (px)
+  Color startColor;  // Color at spawn
+  Color endColor;    // Color reached when the particle dies
+  float rate;        // Particles per second for Stream()
+  float accumulator; // Fractional particles carried to the next frame
+};
+
+// ----------- ParticleSystem -----------
+// Manages: a fixed pool of short-lived particles
+// Should Own:
+//   - Structure-of-arrays buffers (one array per field, no per-particle heap)
+//   - Integrating position, velocity, life and color fade (4 lanes at a time)
+//   - Removing dead particles by swapping the last live one into their slot
+//   - Drawing every particle in a single batched submission
+// Should Not:
+//   - Know about entities, physics or game rules
+class ParticleSystem {
+public:
+  Vector2 gravity; // px/sec^2 applied to every particle
+  float drag;      // Fraction of velocity lost per second (0 = none)
+
+  explicit ParticleSystem(int capacity);
+
+  int Count() const { return count; }
+  int Capacity() const { return capacity; }
+
+  // Spawns up to 'amount' particles at once (dropped when the pool is full)
+  void Emit(const ParticleEmitter &emitter, int amount);
+  // Spawns emitter.rate particles per second, carrying the remainder
+  void Stream(ParticleEmitter &emitter, float deltaTime);
+
+  void Update(float deltaTime);
+  void Draw() const;
+  void Clear() { count = 0; }
+
+private:
+  int capacity;
+  int count;
+  uint32_t seed; // xorshift state, keeps spawning off raylib's RNG
+
+  // Arrays are padded to a multiple of 4 so the vector loop needs no tail
+  std::vector<float> posX, posY;
+  std::vector<float> velX, velY;
+  std::vector<float> life;
+  std::vector<float> size;
+  std::vector<float> colR, colG, colB, colA;     // Current color (0-255)
+  std::vector<float> fadeR, fadeG, fadeB, fadeA; // Color change per second
+
+  float Random01();
+  void Integrate(float deltaTime);
+  void RemoveDead();
+};
@@ -0,0 +1,147 @@
+// grid_bench.cpp
+//
+// Headless benchmark for the grid module: a line covering 99% of a 512x512
+// grid keeps moving along a Hamiltonian cycle, so every step pays the full
+// self-collision test without ever dying.
+
+#include "../grid.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double NsPer(Clock::time_point start, long long count) {
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                 start)
+                .count();
+  return (double)ns / (double)count;
+}
+
+int main() {
+  const int cols = 512;
+  const int rows = 512;
+  const int cells = cols * rows;
+  const int length = cells * 99 / 100;
+
+  // Cycle: serpentine over columns 1..cols-1, then back up column 0
+  std::vector<int8_t> dirX(cells), dirY(cells);
+  for (int y = 0; y < rows; ++y) {
+    for (int x = 0; x < cols; ++x) {
+      int dx = 0, dy = 0;
+      if (x == 0) {
+        dy = (y == 0) ? 0 : -1;
+        dx = (y == 0) ? 1 : 0;
+      } else if (y % 2 == 0) {
+        if (x < cols - 1)
+          dx = 1;
+        else
+          dy = 1;
+      } else {
+        if (x > 1)
+          dx = -1;
+        else if (y < rows - 1)
+          dy = 1;
+        else
+          dx = -1;
+      }
+      dirX[y * cols + x] = (int8_t)dx;
+      dirY[y * cols + x] = (int8_t)dy;
+    }
+  }
+
+  OccupancyGrid grid(cols, rows);
+  GridBody body(cells);
+
+  // Lay the body along the cycle, tail first
+  auto start = Clock::now();
+  int cell = 0;
+  for (int i = 0; i < length; ++i) {
+    grid.Occupy(cell);
+    body.PushHead(cell);
+    Cell c = grid.CellOf(cell);
+    cell = grid.IndexOf(c.x + dirX[cell], c.y + dirY[cell]);
+  }
+  printf("grid %dx%d, body %d cells (%.1f%% full), %d free\n", cols, rows,
+         body.Length(), 100.0 * body.Length() / cells, grid.FreeCount());
+  printf("fill:          %8.2f ns/cell\n", NsPer(start, length));
+
+  // Move: full self-collision test every step
+  const long long moves = 20000000;
+  start = Clock::now();
+  for (long long i = 0; i < moves; ++i) {
+    int head = body.Head();
+    if (Advance(body, grid, dirX[head], dirY[head]) != StepResult::Moved) {
+      printf("unexpected collision at step %lld\n", i);
+      return 1;
+    }
+  }
+  printf("move:          %8.2f ns/step\n", NsPer(start, moves));
+
+  // Grow into half of the remaining free cells
+  const int grows = grid.FreeCount() / 2;
+  body.pendingGrowth = grows;
+  start = Clock::now();
+  for (int i = 0; i < grows; ++i) {
+    int head = body.Head();
+    if (Advance(body, grid, dirX[head], dirY[head]) != StepResult::Grew) {
+      printf("unexpected result while growing at %d\n", i);
+      return 1;
+    }
+  }
+  printf("grow:          %8.2f ns/step (%d steps, now %.2f%% full)\n",
+         NsPer(start, grows), grows, 100.0 * body.Length() / cells);
+
+  // Self hit: steering off the cycle runs into the body
+  int head = body.Head();
+  Cell h = grid.CellOf(head);
+  const int turns[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+  int hitX = 0, hitY = 0;
+  for (const auto &t : turns) {
+    if (grid.InBounds(h.x + t[0], h.y + t[1]) &&
+        grid.IsOccupied(grid.IndexOf(h.x + t[0], h.y + t[1])) &&
+        grid.IndexOf(h.x + t[0], h.y + t[1]) != body.Tail()) {
+      hitX = t[0];
+      hitY = t[1];
+      break;
+    }
+  }
+  const long long hits = 20000000;
+  long long hitCount = 0;
+  start = Clock::now();
+  for (long long i = 0; i < hits; ++i)
+    hitCount += Advance(body, grid, hitX, hitY) == StepResult::HitSelf;
+  printf("self hit:      %8.2f ns/test (%lld hits)\n", NsPer(start, hits),
+         hitCount);
+
+  // Food placement: rank select over the bitset vs. rejection sampling
+  std::mt19937 rng(1234);
+  const int picks = 200000;
+  long long checksum = 0;
+  start = Clock::now();
+  for (int i = 0; i < picks; ++i) {
+    int rank = (int)(rng() % (uint32_t)grid.FreeCount());
+    checksum += grid.NthFree(rank);
+  }
+  printf("food (select): %8.2f ns/pick (%d free cells, %zu words)\n",
+         NsPer(start, picks), grid.FreeCount(),
+         (size_t)(cells + 63) / 64);
+
+  long long tries = 0;
+  start = Clock::now();
+  for (int i = 0; i < picks; ++i) {
+    int candidate;
+    do {
+      candidate = (int)(rng() % (uint32_t)cells);
+      tries++;
+    } while (grid.IsOccupied(candidate));
+    checksum += candidate;
+  }
+  printf("food (reject): %8.2f ns/pick (%.1f tries/pick)\n",
+         NsPer(start, picks), (double)tries / picks);
+
+  printf("checksum %lld\n", checksum);
+  return 0;
+}
@@ -0,0 +1,239 @@
+// trail_bench.cpp
+//
+// Headless benchmark for the Light Cycles AI (trail_ai.h).
+//   evaluate - Voronoi territory on boards from real games, by the
+//              bitboard fill and by a breadth-first search over cells
+//              (the naive way); the two must agree
+//   search   - two AIs play each other, 5 ms per move, on the Growing
+//              Line grid (40x30) and on a 64x64 arena; per move: nodes
+//              per second and the depth completed (in moves by both
+//              cycles). Then the same positions, in the same order, are
+//              searched again with no transposition table.
+// Games start from mirror-image cells with a few random opening moves,
+// mirrored too, so they are fair and don't all play out the same.
+//
+// Usage: trail_bench [games] [budget ms]
+
+#include "../trail_ai.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// The naive evaluation: distances from both heads by BFS, then count
+// the cells each side reaches strictly first
+static int ReferenceEvaluate(const TrailBoard &board, int player) {
+  const int size = TrailBoard::maxSize;
+  static int dist[2][size * size];
+  static int queue[size * size];
+  for (int side = 0; side < 2; ++side) {
+    std::fill(dist[side], dist[side] + size * size, -1);
+    int start = board.head[side == 0 ? player : 1 - player];
+    int read = 0, write = 0;
+    dist[side][start] = 0;
+    queue[write++] = start;
+    while (read < write) {
+      int cell = queue[read++];
+      for (int d = 0; d < 4; ++d) {
+        int x = cell % size + trailDirX[d], y = cell / size + trailDirY[d];
+        int next = y * size + x;
+        if (board.IsBlocked(x, y) || dist[side][next] >= 0)
+          continue;
+        dist[side][next] = dist[side][cell] + 1;
+        queue[write++] = next;
+      }
+    }
+  }
+  int territory = 0;
+  for (int y = 0; y < board.rows; ++y) {
+    for (int x = 0; x < board.cols; ++x) {
+      int a = dist[0][y * size + x], b = dist[1][y * size + x];
+      if (board.IsBlocked(x, y))
+        continue;
+      if (a > 0 && (b < 0 || a < b))
+        territory++;
+      else if (b > 0 && (a < 0 || b < a))
+        territory--;
+    }
+  }
+  return territory;
+}
+
+struct Stats {
+  std::vector<int> depths;
+  std::vector<double> nodesPerSecond;
+  long long nodes = 0, hits = 0;
+  std::vector<double> times; // Seconds per ChooseMove
+  int wins[3] = {}; // Player 0, player 1, draw
+  int moves = 0;
+};
+
+static bool Step(TrailBoard &board, int player, int direction) {
+  int x = board.head[player] % TrailBoard::maxSize + trailDirX[direction];
+  int y = board.head[player] / TrailBoard::maxSize + trailDirY[direction];
+  if (board.IsBlocked(x, y))
+    return false;
+  board.Place(player, x, y);
+  return true;
+}
+
+static void Start(TrailBoard &board, int cols, int rows, std::mt19937 &rng) {
+  board.Reset(cols, rows);
+  board.Place(0, cols / 4, rows / 2);
+  board.Place(1, cols - 1 - cols / 4, rows / 2);
+  // A few random safe moves each, mirrored, so the start stays fair
+  std::uniform_int_distribution<int> pick(0, 3);
+  for (int i = 0; i < 3; ++i) {
+    int d = pick(rng);
+    if (Step(board, 0, d))
+      Step(board, 1, d == 1 || d == 3 ? 4 - d : d);
+  }
+}
+
+static void Record(const TrailAI &ai, Stats &stats) {
+  stats.depths.push_back(ai.Depth());
+  stats.nodesPerSecond.push_back(ai.Nodes() / ai.Seconds());
+  stats.nodes += ai.Nodes();
+  stats.hits += ai.TableHits();
+  stats.times.push_back(ai.Seconds());
+}
+
+// One game; every position is kept, for the replay and evaluate tests.
+// A new game starts with an empty table, as it would in play.
+static void Play(int cols, int rows, double budgetMs, std::mt19937 &rng,
+                 Stats &stats, std::vector<TrailBoard> &positions) {
+  TrailAI ai[2];
+  TrailBoard board;
+  Start(board, cols, rows, rng);
+  positions.push_back(TrailBoard()); // Marks a new game
+  positions.back().cols = 0;
+  for (;;) {
+    int move[2];
+    for (int p = 0; p < 2; ++p) {
+      move[p] = ai[p].ChooseMove(board, p, budgetMs);
+      Record(ai[p], stats);
+    }
+    positions.push_back(board);
+    stats.moves++;
+    // Both at once, as the search assumes
+    int x[2], y[2];
+    bool dead[2];
+    for (int p = 0; p < 2; ++p) {
+      x[p] = board.head[p] % TrailBoard::maxSize + trailDirX[move[p]];
+      y[p] = board.head[p] / TrailBoard::maxSize + trailDirY[move[p]];
+      dead[p] = board.IsBlocked(x[p], y[p]);
+    }
+    if (x[0] == x[1] && y[0] == y[1])
+      dead[0] = dead[1] = true;
+    if (dead[0] || dead[1]) {
+      stats.wins[dead[0] && dead[1] ? 2 : (dead[0] ? 1 : 0)]++;
+      return;
+    }
+    board.Place(0, x[0], y[0]);
+    board.Place(1, x[1], y[1]);
+  }
+}
+
+// The games' positions again, each player's search with no table
+static void Replay(const std::vector<TrailBoard> &positions, double budgetMs,
+                   Stats &stats) {
+  TrailAI ai[2] = {TrailAI(0), TrailAI(0)};
+  for (const TrailBoard &board : positions) {
+    if (board.cols == 0)
+      continue;
+    for (int p = 0; p < 2; ++p) {
+      ai[p].ChooseMove(board, p, budgetMs);
+      Record(ai[p], stats);
+    }
+  }
+}
+
+static void Report(const char *name, Stats &stats) {
+  std::vector<int> &d = stats.depths;
+  std::vector<double> &n = stats.nodesPerSecond;
+  std::sort(d.begin(), d.end());
+  std::sort(n.begin(), n.end());
+  std::sort(stats.times.begin(), stats.times.end());
+  double mean = 0.0;
+  for (int depth : d)
+    mean += depth;
+  mean /= d.size();
+  printf("%-16s %7.0f %7.0f %6.2f %5d %5d %5d %6.1f%% %6.2f %6.2f", name,
+         n[n.size() / 2] / 1e3, n[n.size() / 10] / 1e3, mean, d[d.size() / 10],
+         d[d.size() / 2], d.back(),
+         stats.nodes ? 100.0 * stats.hits / stats.nodes : 0.0,
+         stats.times[stats.times.size() * 99 / 100] * 1e3,
+         stats.times.back() * 1e3);
+  if (stats.moves)
+    printf(" %4d-%d-%d", stats.wins[0], stats.wins[1], stats.wins[2]);
+  printf("\n");
+}
+
+// Both evaluations over the same positions: microseconds each
+static int CompareEvaluate(const char *name,
+                           const std::vector<TrailBoard> &positions) {
+  std::vector<const TrailBoard *> boards;
+  for (const TrailBoard &board : positions) {
+    if (board.cols != 0)
+      boards.push_back(&board);
+  }
+  int mismatches = 0;
+  volatile int sink = 0;
+  Clock::time_point start = Clock::now();
+  for (const TrailBoard *board : boards)
+    sink = sink + TrailAI::Evaluate(*board, 0);
+  double bitboard = Seconds(start);
+  start = Clock::now();
+  for (const TrailBoard *board : boards)
+    sink = sink + ReferenceEvaluate(*board, 0);
+  double reference = Seconds(start);
+  for (const TrailBoard *board : boards) {
+    if (TrailAI::Evaluate(*board, 0) != ReferenceEvaluate(*board, 0))
+      mismatches++;
+  }
+  printf("%-8s %9zu %10.2f %8.2f %10d\n", name, boards.size(),
+         bitboard / boards.size() * 1e6, reference / boards.size() * 1e6,
+         mismatches);
+  return mismatches;
+}
+
+int main(int argc, char **argv) {
+  int games = argc > 1 ? atoi(argv[1]) : 4;
+  double budgetMs = argc > 2 ? atof(argv[2]) : 5.0;
+
+  printf("%d games per row, %.1f ms per move\n", games, budgetMs);
+  printf("search          knode/s   p10 k  depth   p10   p50   max  "
+         "table p99 ms max ms  W-L-D\n");
+  struct Arena {
+    const char *name;
+    int cols, rows;
+  };
+  const Arena arenas[] = {{"40x30", 40, 30}, {"64x64", 64, 64}};
+  std::vector<TrailBoard> positions[2];
+  for (int a = 0; a < 2; ++a) {
+    std::mt19937 rng(11u);
+    Stats played, replayed;
+    for (int g = 0; g < games; ++g)
+      Play(arenas[a].cols, arenas[a].rows, budgetMs, rng, played,
+           positions[a]);
+    Report(arenas[a].name, played);
+    Replay(positions[a], budgetMs, replayed);
+    char name[32];
+    snprintf(name, sizeof(name), "%s no table", arenas[a].name);
+    Report(name, replayed);
+  }
+
+  // Evaluation on every position the games went through
+  printf("evaluate positions bitboard us   BFS us mismatches\n");
+  int mismatches = CompareEvaluate("40x30", positions[0]) +
+                   CompareEvaluate("64x64", positions[1]);
+  return mismatches ? 1 : 0;
+}
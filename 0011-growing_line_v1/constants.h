@@ -0,0 +1,12 @@
+// constants.h
+
+#pragma once
+
+constexpr const char *gameTitle = "Growing Line V1";
+
+const int screenWidth = 800;
+const int screenHeight = 600;
+
+const int cellSize = 20; // Pixels per grid cell
+const int gridCols = screenWidth / cellSize;
+const int gridRows = screenHeight / cellSize;
\ No newline at end of file
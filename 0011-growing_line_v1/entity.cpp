@@ -0,0 +1,54 @@
+#include "entity.h"
+#include "constants.h"
+#include "raylib.h"
+
+// ----------- Entity -----------
+
+Entity::Entity(float x, float y, float width, float height)
+    : position{x, y}, bounds{x, y, width, height} {}
+
+// ----------- Snake -----------
+
+Snake::Snake(int capacity)
+    : Entity(0, 0, cellSize, cellSize), body(capacity), moveDir{1, 0},
+      queuedDir{1, 0} {}
+
+void Snake::Update(float deltaTime) {
+  if (body.Length() == 0)
+    return;
+  int head = body.Head();
+  position = {(float)(head % gridCols * cellSize),
+              (float)(head / gridCols * cellSize)};
+  bounds.x = position.x;
+  bounds.y = position.y;
+}
+
+void Snake::Draw() const {
+  for (int i = body.Length() - 1; i >= 0; --i) {
+    int index = body.At(i);
+    Color color = (i == 0) ? YELLOW : GREEN;
+    DrawRectangle(index % gridCols * cellSize + 1,
+                  index / gridCols * cellSize + 1, cellSize - 2, cellSize - 2,
+                  color);
+  }
+}
+
+// ----------- Food -----------
+
+Food::Food() : Entity(0, 0, cellSize, cellSize), cell(-1) {}
+
+void Food::Update(float deltaTime) {
+  if (cell < 0)
+    return;
+  position = {(float)(cell % gridCols * cellSize),
+              (float)(cell / gridCols * cellSize)};
+  bounds.x = position.x;
+  bounds.y = position.y;
+}
+
+void Food::Draw() const {
+  if (cell < 0)
+    return;
+  DrawCircleV({position.x + cellSize / 2.0f, position.y + cellSize / 2.0f},
+              cellSize / 2.0f - 2, RED);
+}
\ No newline at end of file
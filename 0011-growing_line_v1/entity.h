@@ -0,0 +1,62 @@
+// entity.h
+
+#pragma once
+
+#include "grid.h"
+#include "raylib.h"
+
+// ----------- Entity -----------
+// Base class for all game entities
+// Manages: position, size, and collision detection
+// Should Own:
+//   - Position and size of the entity
+//   - Bounding box for collision detection
+// Should Not:
+//   - Handle rendering directly (should use Renderer)
+class Entity {
+public:
+  Vector2 position; // Position of the entity
+  Rectangle bounds; // Bounding box for collision detection
+
+  Entity(float x, float y, float width, float height);
+
+  virtual void
+  Update(float deltaTime) = 0;   // Pure virtual function for updating
+  virtual void Draw() const = 0; // Pure virtual function for drawing
+};
+
+// ----------- Snake -----------
+// Manages: the growing line controlled by the player
+// Should Own:
+//   - Body cells (ring buffer, see GridBody)
+//   - Current and queued move direction
+// Should Not:
+//   - Move itself (PhysicsEngine steps it on the grid)
+//   - Read input directly (InputHandler queues turns)
+class Snake : public Entity {
+public:
+  GridBody body;
+  Cell moveDir;   // Direction used by the last step
+  Cell queuedDir; // Direction to use on the next step
+
+  explicit Snake(int capacity);
+
+  void Update(float deltaTime) override; // Sync position/bounds to the head
+  void Draw() const override;            // Draw every body cell
+};
+
+// ----------- Food -----------
+// Manages: the cell the snake is trying to reach
+// Should Own:
+//   - Food cell index (-1 when there is no free cell left)
+// Should Not:
+//   - Pick its own cell (EntityManager asks the grid for a free one)
+class Food : public Entity {
+public:
+  int cell;
+
+  Food();
+
+  void Update(float deltaTime) override; // Sync position/bounds to the cell
+  void Draw() const override;            // Draw the food
+};
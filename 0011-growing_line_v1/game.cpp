@@ -0,0 +1,237 @@
+// game.cpp
+
+#include "game.h"
+#include "constants.h"
+#include "entity.h"
+#include "raylib.h"
+#include <cmath>  // Include for ceilf usage
+#include <cstdio> // Include for snprintf usage
+
+const int startLength = 4;     // Cells in a fresh snake
+const int growthPerFood = 3;   // Cells added for every food eaten
+const float startStep = 0.12f; // Seconds per step at score 0
+const float minStep = 0.05f;   // Fastest allowed step
+
+// ----------- GameState -----------
+
+GameState::GameState()
+    : gameOver(false), shutdownRequested(false), resetRequested(false),
+      score(0), stepTimer(0.0f), stepInterval(startStep),
+      countdownActive(true), countdownTime(3.0f) {}
+
+// ----------- InputHandler -----------
+
+InputHandler::InputHandler() {}
+
+void InputHandler::HandleInput(GameState &state, EntityManager &entities) {
+  if (IsKeyPressed(KEY_W) || IsKeyPressed(KEY_UP)) {
+    entities.SetSnakeDirection({0, -1});
+  } else if (IsKeyPressed(KEY_S) || IsKeyPressed(KEY_DOWN)) {
+    entities.SetSnakeDirection({0, 1});
+  } else if (IsKeyPressed(KEY_A) || IsKeyPressed(KEY_LEFT)) {
+    entities.SetSnakeDirection({-1, 0});
+  } else if (IsKeyPressed(KEY_D) || IsKeyPressed(KEY_RIGHT)) {
+    entities.SetSnakeDirection({1, 0});
+  }
+
+  if (IsKeyPressed(KEY_Q)) {
+    state.shutdownRequested = true;
+  }
+  if (IsKeyPressed(KEY_R)) {
+    state.resetRequested = true;
+  }
+};
+
+// ----------- AudioManager -----------
+
+AudioManager::AudioManager() {
+  InitAudioDevice();             // Initialize audio device
+  sound = LoadSound("beep.wav"); // Load a beep sound
+}
+
+void AudioManager::PlayBeep() {
+  PlaySound(sound); // Load and play a beep sound
+}
+
+AudioManager::~AudioManager() {
+  UnloadSound(sound); // Unload the sound
+  CloseAudioDevice(); // Close the audio device
+}
+
+// ----------- PhysicsEngine -----------
+
+PhysicsEngine::PhysicsEngine() {}
+
+void PhysicsEngine::Update(GameState &state, EntityManager &entities,
+                           float deltaTime) {
+  // Grid movement runs at a fixed rate independent of the frame rate
+  state.stepTimer += deltaTime;
+  while (state.stepTimer >= state.stepInterval && !state.gameOver) {
+    state.stepTimer -= state.stepInterval;
+    Step(state, entities);
+  }
+}
+
+void PhysicsEngine::Step(GameState &state, EntityManager &entities) {
+  Snake &snake = entities.snake;
+  snake.moveDir = snake.queuedDir;
+
+  StepResult result = Advance(snake.body, entities.grid, snake.moveDir.x,
+                              snake.moveDir.y);
+  if (result == StepResult::HitWall || result == StepResult::HitSelf) {
+    state.gameOver = true;
+    return;
+  }
+
+  if (snake.body.Head() == entities.food.cell) {
+    state.score++;
+    snake.body.pendingGrowth += growthPerFood;
+    state.stepInterval = fmaxf(minStep, startStep - state.score * 0.002f);
+    if (!entities.PlaceFood()) {
+      state.gameOver = true; // The line fills the whole grid
+    }
+  }
+}
+
+// ----------- EntityManager -----------
+
+EntityManager::EntityManager()
+    : grid(gridCols, gridRows), snake(gridCols * gridRows), food() {
+  ResetSnake();
+}
+
+void EntityManager::Update(GameState &state, float deltaTime) {
+  snake.Update(deltaTime);
+  food.Update(deltaTime);
+}
+
+void EntityManager::SetSnakeDirection(Cell direction) {
+  // Turning straight back into the body is not allowed
+  if (direction.x == -snake.moveDir.x && direction.y == -snake.moveDir.y) {
+    return;
+  }
+  snake.queuedDir = direction;
+}
+
+void EntityManager::ResetSnake() {
+  grid.Clear();
+  snake.body.Reset();
+  snake.moveDir = {1, 0};
+  snake.queuedDir = {1, 0};
+
+  // Lay the body out horizontally, tail first, ending at the center
+  int y = gridRows / 2;
+  for (int i = startLength - 1; i >= 0; --i) {
+    int index = grid.IndexOf(gridCols / 2 - i, y);
+    grid.Occupy(index);
+    snake.body.PushHead(index);
+  }
+  snake.Update(0.0f);
+  PlaceFood();
+}
+
+bool EntityManager::PlaceFood() {
+  if (grid.FreeCount() == 0) {
+    food.cell = -1;
+    return false;
+  }
+  food.cell = grid.NthFree(GetRandomValue(0, grid.FreeCount() - 1));
+  food.Update(0.0f);
+  return true;
+}
+
+// ----------- Renderer -----------
+
+// Note to AI: Window is already initialized in platform loop
+Renderer::Renderer() {}
+
+void Renderer::Render(const EntityManager &entities, const GameState &state) {
+  BeginDrawing();
+  ClearBackground(BLACK);
+
+  entities.food.Draw();
+  entities.snake.Draw();
+
+  // HUD: Score and length
+  char hud[64];
+  snprintf(hud, sizeof(hud), "Score: %d   Length: %d", state.score,
+           entities.snake.body.Length());
+  DrawText(hud, 20, 20, 20, WHITE);
+
+  if (state.countdownActive) {
+    int screenW = GetScreenWidth();
+    int screenH = GetScreenHeight();
+    int number = (int)ceilf(state.countdownTime);
+    if (number > 0) {
+      char numStr[16];
+      snprintf(numStr, sizeof(numStr), "%d", number);
+      int fontSize = 120;
+      DrawText(numStr, screenW / 2 - MeasureText(numStr, fontSize) / 2,
+               screenH / 2 - fontSize / 2, fontSize, YELLOW);
+    }
+    EndDrawing();
+    return;
+  }
+
+  if (state.gameOver) {
+    int screenW = GetScreenWidth();
+    int screenH = GetScreenHeight();
+    const char *msg = "GAME OVER";
+    const char *prompt = "Press R to Restart";
+    int fontSize = 40;
+    int promptSize = 20;
+    DrawText(msg, screenW / 2 - MeasureText(msg, fontSize) / 2,
+             screenH / 2 - fontSize, fontSize, RED);
+    DrawText(prompt, screenW / 2 - MeasureText(prompt, promptSize) / 2,
+             screenH / 2 + 10, promptSize, WHITE);
+  }
+
+  EndDrawing();
+}
+
+// ----------- Game -----------
+
+Game::Game()
+    : gameState(), inputHandler(), audioManager(), physicsEngine(),
+      entityManager(), renderer() {}
+
+void Game::HandleInput() { inputHandler.HandleInput(gameState, entityManager); }
+
+void Game::Update(float deltaTime) {
+  if (gameState.resetRequested) {
+    entityManager.ResetSnake();
+    gameState.shutdownRequested = false;
+    gameState.resetRequested = false;
+    gameState.gameOver = false;
+    gameState.score = 0;
+    gameState.stepTimer = 0.0f;
+    gameState.stepInterval = startStep;
+    gameState.countdownActive = true;
+    gameState.countdownTime = 3.0f;
+  }
+  if (gameState.countdownActive) {
+    gameState.countdownTime -= deltaTime;
+    if (gameState.countdownTime <= 0.0f) {
+      gameState.countdownActive = false;
+      gameState.countdownTime = 0.0f;
+    }
+    // Don't step the grid during countdown
+    return;
+  }
+  if (!gameState.gameOver) {
+    int score = gameState.score;
+    physicsEngine.Update(gameState, entityManager, deltaTime);
+    entityManager.Update(gameState, deltaTime);
+    if (gameState.score != score) {
+      audioManager.PlayBeep();
+    }
+  }
+}
+
+void Game::Render() { renderer.Render(entityManager, gameState); }
+
+void Game::Run() {
+  HandleInput();
+  Update(GetFrameTime());
+  Render();
+}
@@ -0,0 +1,140 @@
+// game.h
+
+#pragma once
+
+#include "entity.h"
+#include "grid.h"
+#include "raylib.h"
+
+// ----------- GameState -----------
+// Manages: overall game status flags
+// Should Own:
+//   - Whether the game is running
+//   - Whether the game is over
+//   - Whether a shutdown has been requested
+//   - Score and the fixed grid step timer
+// Should Not:
+//   - Know about entities
+//   - Know about input or rendering
+class GameState {
+public:
+  bool gameOver;
+  bool shutdownRequested;
+  bool resetRequested;
+  int score;
+  float stepTimer;      // Time accumulated towards the next grid step
+  float stepInterval;   // Seconds per grid step
+  bool countdownActive; // Is countdown running?
+  float countdownTime;  // Time left in countdown
+  GameState();
+};
+
+// ----------- AudioManager -----------
+// Manages: sound effects and audio playback
+// Should Own:
+//   - Loading, playing, stopping sounds
+//   - Keeping track of currently loaded sounds
+// Should Not:
+//   - Know about input, physics, or entities
+class AudioManager {
+public:
+  void PlayBeep(); // Example: play a simple beep sound
+  AudioManager();
+  ~AudioManager();
+
+private:
+  Sound sound;
+};
+
+// ----------- EntityManager -----------
+// Manages: the collection of game entities
+// Should Own:
+//   - Storage of all entities (snake, food)
+//   - The occupancy grid shared by the snake and food placement
+//   - Creating, deleting, updating entities
+// Should Not:
+//   - Draw entities
+//   - Handle physics directly (physics can modify entities, but not the manager
+//   itself)
+class EntityManager {
+public:
+  OccupancyGrid grid;
+  Snake snake;
+  Food food;
+  void Update(GameState &state, float deltaTime);
+  EntityManager();
+
+  void SetSnakeDirection(Cell direction);
+  void ResetSnake();
+  bool PlaceFood(); // False when the grid is full
+};
+
+// ----------- InputHandler -----------
+// Manages: user input handling
+// Should Own:
+//   - Mapping input keys/buttons to actions
+//   - Detecting key presses or mouse input
+// Should Not:
+//   - Update entities
+//   - Play sounds
+class InputHandler {
+public:
+  void HandleInput(GameState &state, EntityManager &entities);
+  InputHandler();
+};
+
+// ----------- PhysicsEngine -----------
+// Manages: grid movement and collisions
+// Should Own:
+//   - Stepping the snake one cell per fixed tick
+//   - Wall, self and food collisions (all O(1) via the occupancy grid)
+// Should Not:
+//   - Render entities
+//   - Handle user input
+class PhysicsEngine {
+public:
+  void Update(GameState &state, EntityManager &entities, float deltaTime);
+  PhysicsEngine();
+
+private:
+  void Step(GameState &state, EntityManager &entities);
+};
+
+// ----------- Renderer -----------
+// Manages: drawing to the screen
+// Should Own:
+//   - Drawing entities, backgrounds, UI
+//   - Managing the render order if necessary
+// Should Not:
+//   - Update game logic or entity states
+//   - Handle input or play sounds
+class Renderer {
+public:
+  void Render(const EntityManager &entities, const GameState &state);
+  Renderer();
+};
+
+// ----------- Game -----------
+// Manages: top-level orchestration of the game
+// Should Own:
+//   - Instances of all subsystems (InputHandler, AudioManager, etc.)
+//   - Game loop: input -> update -> render
+//   - Starting and stopping the game
+// Should Not:
+//   - Directly update physics, entities, or render details (delegate to
+//   subsystems)
+class Game {
+public:
+  GameState gameState;
+  InputHandler inputHandler;
+  AudioManager audioManager;
+  PhysicsEngine physicsEngine;
+  EntityManager entityManager;
+  Renderer renderer;
+
+  Game();
+  void HandleInput();
+  void Update(float deltaTime);
+  void Render();
+  void Run();
+};
@@ -0,0 +1,117 @@
+// grid.cpp
+
+#include "grid.h"
+#include <algorithm>
+#include <cstddef>
+
+// ----------- OccupancyGrid -----------
+
+OccupancyGrid::OccupancyGrid(int cols, int rows)
+    : cols(cols), rows(rows), freeCount(0),
+      words((static_cast<size_t>(cols) * rows + 63) / 64),
+      blockFree((words.size() + 63) / 64) {
+  Clear();
+}
+
+void OccupancyGrid::Occupy(int index) {
+  uint64_t bit = uint64_t(1) << (index & 63);
+  uint64_t &word = words[index >> 6];
+  if (!(word & bit)) {
+    word |= bit;
+    freeCount--;
+    blockFree[index >> 12]--;
+  }
+}
+
+void OccupancyGrid::Release(int index) {
+  uint64_t bit = uint64_t(1) << (index & 63);
+  uint64_t &word = words[index >> 6];
+  if (word & bit) {
+    word &= ~bit;
+    freeCount++;
+    blockFree[index >> 12]++;
+  }
+}
+
+void OccupancyGrid::Clear() {
+  for (uint64_t &word : words)
+    word = 0;
+  // Padding bits in the last word count as occupied so NthFree never
+  // returns a cell outside the grid
+  int used = CellCount() & 63;
+  if (used != 0)
+    words.back() = ~uint64_t(0) << used;
+  freeCount = CellCount();
+  for (size_t b = 0; b < blockFree.size(); ++b)
+    blockFree[b] = std::min(4096, CellCount() - static_cast<int>(b) * 4096);
+}
+
+int OccupancyGrid::NthFree(int rank) const {
+  if (rank < 0 || rank >= freeCount)
+    return -1;
+  size_t b = 0;
+  while (rank >= blockFree[b]) {
+    rank -= blockFree[b];
+    b++;
+  }
+  for (size_t w = b * 64; w < words.size(); ++w) {
+    uint64_t freeBits = ~words[w];
+    int count = __builtin_popcountll(freeBits);
+    if (rank >= count) {
+      rank -= count;
+      continue;
+    }
+    // Drop the lowest 'rank' free bits, the next one is the answer
+    for (; rank > 0; --rank)
+      freeBits &= freeBits - 1;
+    return static_cast<int>(w * 64) + __builtin_ctzll(freeBits);
+  }
+  return -1;
+}
+
+// ----------- GridBody -----------
+
+GridBody::GridBody(int capacity)
+    : pendingGrowth(0), ring(capacity), head(capacity - 1), length(0) {}
+
+void GridBody::Reset() {
+  head = Capacity() - 1;
+  length = 0;
+  pendingGrowth = 0;
+}
+
+void GridBody::PushHead(int index) {
+  head = Wrap(head + 1);
+  ring[head] = index;
+  length++;
+}
+
+void GridBody::PopTail() { length--; }
+
+// ----------- Advance -----------
+
+StepResult Advance(GridBody &body, OccupancyGrid &grid, int dx, int dy) {
+  Cell from = grid.CellOf(body.Head());
+  int x = from.x + dx;
+  int y = from.y + dy;
+  if (!grid.InBounds(x, y))
+    return StepResult::HitWall;
+
+  int next = grid.IndexOf(x, y);
+  bool growing = body.pendingGrowth > 0 && body.Length() < body.Capacity();
+  // The tail moves out this step unless we are growing, so it is not a hit
+  if (grid.IsOccupied(next) && (growing || next != body.Tail()))
+    return StepResult::HitSelf;
+
+  if (!growing) {
+    grid.Release(body.Tail());
+    body.PopTail();
+  }
+  grid.Occupy(next);
+  body.PushHead(next);
+  if (growing) {
+    body.pendingGrowth--;
+    return StepResult::Grew;
+  }
+  return StepResult::Moved;
+}
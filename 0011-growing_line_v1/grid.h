@@ -0,0 +1,103 @@
+// grid.h
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// ----------- Cell -----------
+// A column/row pair on the playfield grid
+struct Cell {
+  int x;
+  int y;
+};
+
+// ----------- OccupancyGrid -----------
+// Manages: which cells of the playfield are taken
+// Should Own:
+//   - Packed occupancy bitset (one bit per cell, 64 cells per word)
+//   - Running count of free cells, overall and per block of 64 words
+//   - Picking a free cell uniformly without rejection sampling
+// Should Not:
+//   - Know about the order of the body or where the food is
+//   - Call raylib (so it can run headless in benchmarks)
+class OccupancyGrid {
+public:
+  OccupancyGrid(int cols, int rows);
+
+  int Cols() const { return cols; }
+  int Rows() const { return rows; }
+  int CellCount() const { return cols * rows; }
+  int FreeCount() const { return freeCount; }
+
+  bool InBounds(int x, int y) const {
+    return x >= 0 && x < cols && y >= 0 && y < rows;
+  }
+  int IndexOf(int x, int y) const { return y * cols + x; }
+  Cell CellOf(int index) const { return {index % cols, index / cols}; }
+
+  bool IsOccupied(int index) const {
+    return (words[index >> 6] >> (index & 63)) & 1u;
+  }
+  void Occupy(int index);
+  void Release(int index);
+  void Clear(); // Mark every cell free
+
+  // Returns the free cell with the given rank (0 <= rank < FreeCount()),
+  // counting in row-major order, or -1 if the grid is full. Skips whole
+  // blocks by their free count, then walks at most 64 words by popcount, so
+  // the cost is O(words) at worst regardless of fill level.
+  int NthFree(int rank) const;
+
+private:
+  int cols;
+  int rows;
+  int freeCount;
+  std::vector<uint64_t> words; // Padding bits past the last cell stay set
+  std::vector<int> blockFree;  // Free cells in each run of 64 words
+};
+
+// ----------- GridBody -----------
+// Manages: the cells covered by a growing line, head to tail
+// Should Own:
+//   - Fixed-capacity ring buffer of cell indices (no allocation per move)
+//   - Pending growth still to be applied
+// Should Not:
+//   - Decide where the body moves (see Advance)
+//   - Draw itself
+class GridBody {
+public:
+  explicit GridBody(int capacity);
+
+  int Length() const { return length; }
+  int Capacity() const { return static_cast<int>(ring.size()); }
+  int Head() const { return ring[head]; }
+  int Tail() const { return ring[Wrap(head + 1 - length)]; }
+  // i = 0 is the head, i = Length() - 1 is the tail
+  int At(int i) const { return ring[Wrap(head - i)]; }
+
+  void Reset(); // Empty body, no pending growth
+  void PushHead(int index);
+  void PopTail();
+
+  int pendingGrowth; // Cells still to be added by upcoming moves
+
+private:
+  std::vector<int> ring;
+  int head;
+  int length;
+
+  int Wrap(int i) const {
+    int capacity = static_cast<int>(ring.size());
+    return i < 0 ? i + capacity : (i >= capacity ? i - capacity : i);
+  }
+};
+
+// ----------- Advance -----------
+// Result of moving a body one cell
+enum class StepResult { Moved, Grew, HitWall, HitSelf };
+
+// Moves the body one cell in direction (dx, dy), keeping the occupancy grid
+// in sync. The head may follow directly into the cell the tail is leaving.
+// On HitWall/HitSelf nothing is changed. O(1) per call.
+StepResult Advance(GridBody &body, OccupancyGrid &grid, int dx, int dy);
@@ -0,0 +1,5 @@
+// loop.h
+
+#pragma once
+
+void RunPlatformLoop(void (*MainLoop)(void *GameState), void *GameState);
\ No newline at end of file
@@ -0,0 +1,291 @@
+// trail_ai.cpp
+
+#include "trail_ai.h"
+#include <algorithm>
+#include <cstddef>
+#include <random>
+
+static const int maxCells = TrailBoard::maxSize * TrailBoard::maxSize;
+static const int infinity = TrailAI::winScore + 1;
+// Scores this close to winScore are crashes found by the search
+static const int decidedScore = TrailAI::winScore - maxCells;
+
+// Random keys for every blocked cell and every head position
+struct ZobristKeys {
+  uint64_t cell[maxCells];
+  uint64_t head[2][maxCells];
+  uint64_t side; // The search is for player 1
+
+  ZobristKeys() {
+    std::mt19937_64 rng(0x5EEDCAFEu);
+    for (int i = 0; i < maxCells; ++i) {
+      cell[i] = rng();
+      head[0][i] = rng();
+      head[1][i] = rng();
+    }
+    side = rng();
+  }
+};
+
+static const ZobristKeys zobrist;
+
+static inline int CellX(int cell) { return cell % TrailBoard::maxSize; }
+static inline int CellY(int cell) { return cell / TrailBoard::maxSize; }
+
+// Crash scores count from the root, so the table stores them counted
+// from the node instead
+static inline int ToTable(int value, int ply) {
+  return value > decidedScore ? value + ply
+                              : (value < -decidedScore ? value - ply : value);
+}
+
+static inline int FromTable(int value, int ply) {
+  return value > decidedScore ? value - ply
+                              : (value < -decidedScore ? value + ply : value);
+}
+
+// ----------- TrailBoard -----------
+
+void TrailBoard::Reset(int arenaCols, int arenaRows) {
+  cols = std::clamp(arenaCols, 1, maxSize);
+  rows = std::clamp(arenaRows, 1, maxSize);
+  uint64_t walls = cols == 64 ? 0 : ~uint64_t(0) << cols;
+  for (int y = 0; y < maxSize; ++y)
+    blocked[y] = y < rows ? walls : ~uint64_t(0);
+  head[0] = head[1] = 0;
+  hash = zobrist.head[0][0] ^ zobrist.head[1][0];
+}
+
+void TrailBoard::Place(int player, int x, int y) {
+  int cell = y * maxSize + x;
+  if (!(blocked[y] >> x & 1u)) {
+    blocked[y] |= uint64_t(1) << x;
+    hash ^= zobrist.cell[cell];
+  }
+  hash ^= zobrist.head[player][head[player]] ^ zobrist.head[player][cell];
+  head[player] = cell;
+}
+
+// ----------- TrailAI -----------
+
+TrailAI::TrailAI(int tableBits)
+    : table(size_t(1) << std::clamp(tableBits, 0, 26)),
+      tableMask(table.size() - 1), work(), me(0), stopped(false), nodes(0),
+      evaluations(0), tableHits(0), depth(0), score(0), seconds(0.0) {
+  work.Reset(1, 1);
+}
+
+int TrailAI::Evaluate(const TrailBoard &board, int player) {
+  // Row arrays padded by one on each side, so row y - 1 and y + 1 can be
+  // read without a bounds test; the padding stays zero
+  const int rows = board.rows;
+  uint64_t fronts[4][TrailBoard::maxSize + 2] = {};
+  uint64_t *frontA = fronts[0], *frontB = fronts[1];
+  uint64_t *nextA = fronts[2], *nextB = fronts[3];
+  uint64_t claimed[TrailBoard::maxSize];
+  uint64_t ownA[TrailBoard::maxSize] = {};
+  uint64_t ownB[TrailBoard::maxSize] = {};
+  for (int y = 0; y < rows; ++y)
+    claimed[y] = board.blocked[y];
+  int a = board.head[player], b = board.head[1 - player];
+  frontA[CellY(a) + 1] = uint64_t(1) << CellX(a);
+  frontB[CellY(b) + 1] = uint64_t(1) << CellX(b);
+  // Rows the fronts are on; a step reaches one row further each way
+  int top = std::min(CellY(a), CellY(b));
+  int bottom = std::max(CellY(a), CellY(b));
+
+  // One step of both fills per pass, over the fronts' rows only: in a
+  // maze of trails the fronts are a few cells wide and the pass is short.
+  // A cell both reach in the same step belongs to neither and stops.
+  while (top <= bottom) {
+    int first = std::max(top - 1, 0), last = std::min(bottom + 1, rows - 1);
+    top = rows;
+    bottom = -1;
+    for (int y = first; y <= last; ++y) {
+      uint64_t fa = frontA[y + 1], fb = frontB[y + 1];
+      uint64_t open = ~claimed[y];
+      uint64_t grownA = (fa << 1 | fa >> 1 | frontA[y] | frontA[y + 2]) & open;
+      uint64_t grownB = (fb << 1 | fb >> 1 | frontB[y] | frontB[y + 2]) & open;
+      uint64_t tie = grownA & grownB;
+      nextA[y + 1] = grownA & ~tie;
+      nextB[y + 1] = grownB & ~tie;
+      claimed[y] |= grownA | grownB;
+      ownA[y] |= nextA[y + 1];
+      ownB[y] |= nextB[y + 1];
+      if (grownA | grownB) {
+        top = std::min(top, y);
+        bottom = y;
+      }
+    }
+    // The old fronts' rows outside this pass's band were empty already
+    for (int y = first; y <= last; ++y)
+      frontA[y + 1] = frontB[y + 1] = 0;
+    std::swap(frontA, nextA);
+    std::swap(frontB, nextB);
+  }
+  // Counted once at the end: without a popcount instruction it's a
+  // dozen operations a word
+  int territory = 0;
+  for (int y = 0; y < rows; ++y)
+    territory += __builtin_popcountll(ownA[y]) - __builtin_popcountll(ownB[y]);
+  return territory;
+}
+
+bool TrailAI::OutOfTime() { return Clock::now() >= deadline; }
+
+int TrailAI::Search(int remaining, int ply, int alpha, int beta) {
+  nodes++;
+  // A leaf costs microseconds, the clock tens of nanoseconds: checking
+  // every 16 nodes keeps the overrun well under the budget
+  if ((nodes & 15) == 0 && OutOfTime())
+    stopped = true;
+  if (stopped)
+    return 0;
+  if (remaining == 0) {
+    evaluations++;
+    return Evaluate(work, me);
+  }
+
+  uint64_t key = work.hash ^ (me ? zobrist.side : 0);
+  TableEntry &entry = table[key & tableMask];
+  int tableMove = -1;
+  unsigned replies = 0; // Answer to move m in bits 2m, 2m + 1
+  if (entry.key == key && entry.bound != BoundNone) {
+    tableMove = entry.move;
+    replies = entry.replies;
+    if (entry.depth >= remaining) {
+      int value = FromTable(entry.value, ply);
+      if (entry.bound == BoundExact ||
+          (entry.bound == BoundLower && value >= beta) ||
+          (entry.bound == BoundUpper && value <= alpha)) {
+        tableHits++;
+        return value;
+      }
+    }
+  }
+
+  // The table's move first, then clockwise
+  int order[4] = {0, 1, 2, 3};
+  if (tableMove > 0)
+    std::swap(order[0], order[tableMove]);
+
+  int you = 1 - me;
+  int alphaStart = alpha;
+  int best = -infinity;
+  int bestMove = -1;
+  for (int m : order) {
+    int from = work.head[me];
+    int mx = CellX(from) + trailDirX[m], my = CellY(from) + trailDirY[m];
+    bool meDead = work.IsBlocked(mx, my);
+    int meTo = my * TrailBoard::maxSize + mx;
+
+    // The opponent answers knowing our move: the lowest answer counts.
+    // Last time's best answer first, then clockwise from it.
+    int worst = infinity;
+    int firstReply = replies >> (2 * m) & 3;
+    for (int r = 0; r < 4; ++r) {
+      int o = (firstReply + r) & 3;
+      int oppFrom = work.head[you];
+      int ox = CellX(oppFrom) + trailDirX[o];
+      int oy = CellY(oppFrom) + trailDirY[o];
+      bool youDead = work.IsBlocked(ox, oy);
+      int youTo = oy * TrailBoard::maxSize + ox;
+      if (!meDead && !youDead && meTo == youTo)
+        meDead = youDead = true; // Head on
+      int value;
+      if (meDead && youDead) {
+        value = 0;
+      } else if (meDead) {
+        value = -(winScore - ply);
+      } else if (youDead) {
+        value = winScore - ply;
+      } else {
+        // Both moves at once: each head's new cell joins its trail
+        uint64_t saved = work.hash;
+        work.blocked[my] |= uint64_t(1) << mx;
+        work.blocked[oy] |= uint64_t(1) << ox;
+        work.hash ^= zobrist.cell[meTo] ^ zobrist.cell[youTo] ^
+                     zobrist.head[me][from] ^ zobrist.head[me][meTo] ^
+                     zobrist.head[you][oppFrom] ^ zobrist.head[you][youTo];
+        work.head[me] = meTo;
+        work.head[you] = youTo;
+        value = Search(remaining - 1, ply + 1, alpha, std::min(beta, worst));
+        work.head[me] = from;
+        work.head[you] = oppFrom;
+        work.blocked[my] &= ~(uint64_t(1) << mx);
+        work.blocked[oy] &= ~(uint64_t(1) << ox);
+        work.hash = saved;
+      }
+      meDead = work.IsBlocked(mx, my); // Undo the head-on case
+      if (value < worst) {
+        worst = value;
+        replies = (replies & ~(3u << (2 * m))) | (unsigned)o << (2 * m);
+      }
+      if (worst <= alpha || stopped)
+        break; // The opponent has a reply at least this bad for us
+    }
+    if (stopped)
+      return 0;
+    if (worst > best) {
+      best = worst;
+      bestMove = m;
+    }
+    alpha = std::max(alpha, best);
+    if (alpha >= beta)
+      break;
+  }
+
+  entry.key = key;
+  entry.value = ToTable(best, ply);
+  entry.depth = (int8_t)std::min(remaining, 127);
+  entry.bound = best <= alphaStart ? BoundUpper
+                                   : (best >= beta ? BoundLower : BoundExact);
+  // Failing low, every move was refuted: none of them is known best
+  entry.move = (int8_t)(best <= alphaStart ? -1 : bestMove);
+  entry.replies = (uint8_t)replies;
+  return best;
+}
+
+int TrailAI::ChooseMove(const TrailBoard &board, int player, double budgetMs) {
+  Clock::time_point start = Clock::now();
+  deadline = start + std::chrono::duration_cast<Clock::duration>(
+                         std::chrono::duration<double, std::milli>(budgetMs));
+  work = board;
+  me = player;
+  stopped = false;
+  nodes = evaluations = tableHits = 0;
+  depth = 0;
+  score = 0;
+
+  // Until a search completes: the first direction that doesn't crash
+  int choice = 0;
+  int from = board.head[player];
+  for (int m = 0; m < 4; ++m) {
+    if (!board.IsBlocked(CellX(from) + trailDirX[m],
+                         CellY(from) + trailDirY[m])) {
+      choice = m;
+      break;
+    }
+  }
+
+  // Deeper each time until the budget runs out; a search cut short is
+  // thrown away. Each level is one move by both cycles.
+  uint64_t rootKey = board.hash ^ (player ? zobrist.side : 0);
+  int freeCells = 0;
+  for (int y = 0; y < board.rows; ++y)
+    freeCells += __builtin_popcountll(~board.blocked[y]);
+  for (int level = 1; level <= std::min(freeCells / 2 + 1, 127); ++level) {
+    int value = Search(level, 0, -infinity, infinity);
+    if (stopped)
+      break;
+    const TableEntry &root = table[rootKey & tableMask];
+    if (root.key == rootKey && root.move >= 0)
+      choice = root.move;
+    depth = level;
+    score = value;
+    if (value > decidedScore || value < -decidedScore)
+      break; // Someone crashes whatever happens: deeper won't change it
+  }
+  seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  return choice;
+}
@@ -0,0 +1,110 @@
+// trail_ai.h
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// ----------- TrailBoard -----------
+// Manages: a Light Cycles arena as bitboards, one 64-bit word per row
+// Should Own:
+//   - Which cells are blocked: both trails, and the walls (every bit
+//     past the arena's width is set, rows past its height don't exist)
+//   - Where each cycle's head is; a head's cell is part of its trail
+//   - A Zobrist hash of all that, kept up to date as cycles move
+// Should Not:
+//   - Decide where a cycle goes (TrailAI, or the player)
+//   - Call raylib (so it can run headless in benchmarks)
+struct TrailBoard {
+  static const int maxSize = 64; // Columns (bits per row) and rows
+
+  int cols;
+  int rows;
+  uint64_t blocked[maxSize];
+  int head[2]; // Cell index: y * maxSize + x
+  uint64_t hash;
+
+  // Empty arena; both heads at (0, 0) until Place
+  void Reset(int arenaCols, int arenaRows);
+  void Place(int player, int x, int y);
+  bool IsBlocked(int x, int y) const {
+    return x < 0 || y < 0 || x >= cols || y >= rows ||
+           (blocked[y] >> x & 1u);
+  }
+};
+
+// Directions, clockwise from up; a cycle moves one cell per step
+const int trailDirX[4] = {0, 1, 0, -1};
+const int trailDirY[4] = {-1, 0, 1, 0};
+
+// ----------- TrailAI -----------
+// Manages: choosing a CPU cycle's next direction
+// Should Own:
+//   - Search: both cycles move at once, searched as 'we move, then the
+//     opponent answers knowing our move' (the cautious view), with
+//     alpha-beta pruning and iterative deepening until the time budget
+//     runs out. A step where both crash, or both enter the same cell,
+//     is a draw.
+//   - Evaluation: Voronoi territory, the free cells we reach strictly
+//     before the opponent minus the reverse, by flood filling from both
+//     heads at once over the bitboard rows (a few shifts and ANDs per
+//     row per step, no per-cell queue)
+//   - A transposition table keyed by the board's Zobrist hash, kept
+//     between moves. Besides bounds it keeps the best move and the
+//     opponent's best answer to each of our moves: searched first, they
+//     give most of alpha-beta's cutoffs, since few positions repeat.
+// Should Not:
+//   - Move the cycles (the caller applies the returned direction)
+//   - Know about rendering, input or timing beyond its budget
+class TrailAI {
+public:
+  static const int winScore = 1000000; // Minus the plies it takes
+
+  explicit TrailAI(int tableBits = 18);
+
+  // Direction (0-3) for 'player' to move next, searched for at most
+  // 'budgetMs' milliseconds. Any direction when every move loses.
+  int ChooseMove(const TrailBoard &board, int player, double budgetMs);
+
+  // Territory difference for 'player': Voronoi cells minus the
+  // opponent's. Public for the benchmark.
+  static int Evaluate(const TrailBoard &board, int player);
+
+  // About the last ChooseMove
+  long long Nodes() const { return nodes; }
+  long long Evaluations() const { return evaluations; }
+  long long TableHits() const { return tableHits; }
+  int Depth() const { return depth; } // Deepest search completed
+  int Score() const { return score; } // Of the chosen move, at Depth()
+  double Seconds() const { return seconds; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  enum Bound : uint8_t { BoundNone, BoundExact, BoundLower, BoundUpper };
+  struct TableEntry {
+    uint64_t key;
+    int32_t value;
+    int8_t depth;
+    uint8_t bound;
+    int8_t move;     // Best direction found, -1 if none
+    uint8_t replies; // The opponent's best answer to each, 2 bits each
+  };
+
+  std::vector<TableEntry> table;
+  uint64_t tableMask;
+  TrailBoard work; // The board as the search walks it
+  int me;
+  Clock::time_point deadline;
+  bool stopped;
+  long long nodes;
+  long long evaluations;
+  long long tableHits;
+  int depth;
+  int score;
+  double seconds;
+
+  int Search(int remaining, int ply, int alpha, int beta);
+  bool OutOfTime();
+};
@@ -0,0 +1,291 @@
+// headless_raylib.cpp
+//
+// Stand-in for libraylib used by the performance suite. Every lesson is
+// linked against this file instead of raylib, so its simulation runs with
+// no window, no GPU and no audio device. Drawing calls are no-ops, input
+// comes from a fixed script, and the frame clock is fixed at 60 Hz.
+// GetTime() is virtual too: it jumps to the tick's start on every
+// WindowShouldClose() and only moves within a tick through WaitTime().
+//
+// Each pass through WindowShouldClose() is one tick. After a warm-up the
+// shim records nanoseconds per tick, operator new calls (per tick and in
+// total) and peak RSS, and writes them as JSON when the lesson calls
+// CloseWindow().
+//
+// Environment:
+//   PERF_LESSON  name written into the result (default "unknown")
+//   PERF_OUT     result file (default stdout)
+//   PERF_TICKS   measured ticks (default 6000)
+
+#include "raylib.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <sys/resource.h>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int warmupTicks = 60;
+static const int keyCycleTicks = 40; // Ticks spent holding each direction
+static const int restartTicks = 600; // Press R this often
+static const float fixedFrameTime = 1.0f / 60.0f;
+
+static int tick = -1;
+static int measuredTicks = 6000;
+static Clock::time_point tickStart;
+static std::vector<long long> tickNs;
+static long long allocations = 0;
+static long long measuredAllocations = 0;
+static bool measuring = false;
+static unsigned int randomState = 12345u;
+static double virtualTime = 0.0;
+static int pressedQueue[4]; // This tick's presses for GetKeyPressed()
+static int pressedCount = 0;
+static int pressedRead = 0;
+
+// ----------- Allocation counting -----------
+
+void *operator new(size_t size) {
+  allocations++;
+  void *p = std::malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete[](void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+
+// Pin the wall clock so std::srand(std::time(nullptr)) in every lesson
+// seeds the same sequence on every run
+extern "C" time_t time(time_t *out) noexcept {
+  if (out)
+    *out = 1700000000;
+  return 1700000000;
+}
+
+// ----------- Scripted input -----------
+
+// Holds W, D, S, A in turn (a square path) and presses R now and then so
+// games that end keep being simulated
+static int ScriptedKey() {
+  static const int keys[4] = {KEY_W, KEY_D, KEY_S, KEY_A};
+  return keys[(tick / keyCycleTicks) % 4];
+}
+
+// ----------- Results -----------
+
+static void WriteResults() {
+  const char *lesson = getenv("PERF_LESSON");
+  const char *path = getenv("PERF_OUT");
+  FILE *out = path ? fopen(path, "w") : stdout;
+  if (!out) {
+    fprintf(stderr, "perf: cannot open %s\n", path);
+    return;
+  }
+
+  std::vector<long long> sorted = tickNs;
+  std::sort(sorted.begin(), sorted.end());
+  long long total = 0;
+  for (long long ns : sorted)
+    total += ns;
+  size_t n = sorted.size();
+  double mean = n ? (double)total / n : 0.0;
+  long long p50 = n ? sorted[n / 2] : 0;
+  long long p99 = n ? sorted[std::min(n - 1, n * 99 / 100)] : 0;
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  fprintf(out,
+          "{\"lesson\": \"%s\", \"ticks\": %zu, \"ns_per_tick\": %.1f, "
+          "\"p50_ns\": %lld, \"p99_ns\": %lld, \"allocs_per_tick\": %.4f, "
+          "\"peak_rss_kb\": %ld, \"allocs\": %lld}\n",
+          lesson ? lesson : "unknown", n, mean, p50, p99,
+          n ? (double)measuredAllocations / n : 0.0, usage.ru_maxrss,
+          measuredAllocations);
+  if (out != stdout)
+    fclose(out);
+}
+
+// ----------- Window and timing -----------
+
+extern "C" {
+
+void InitWindow(int width, int height, const char *title) {
+  const char *ticks = getenv("PERF_TICKS");
+  if (ticks)
+    measuredTicks = atoi(ticks);
+  tickNs.reserve(measuredTicks);
+}
+
+void CloseWindow(void) { WriteResults(); }
+bool IsWindowReady(void) { return true; }
+
+bool WindowShouldClose(void) {
+  Clock::time_point now = Clock::now();
+  if (measuring) {
+    tickNs.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - tickStart)
+            .count());
+    measuredAllocations += allocations;
+  }
+
+  tick++;
+  measuring = tick >= warmupTicks;
+  if (tick >= warmupTicks + measuredTicks)
+    return true;
+
+  allocations = 0;
+  virtualTime = tick * (double)fixedFrameTime;
+  pressedCount = 0;
+  pressedRead = 0;
+  if (tick % keyCycleTicks == 0)
+    pressedQueue[pressedCount++] = ScriptedKey();
+  if (tick % restartTicks == restartTicks - 1)
+    pressedQueue[pressedCount++] = KEY_R;
+  tickStart = Clock::now();
+  return false;
+}
+
+void SetTargetFPS(int fps) {}
+void SetExitKey(int key) {}
+float GetFrameTime(void) { return fixedFrameTime; }
+double GetTime(void) { return virtualTime; }
+void WaitTime(double seconds) { virtualTime += seconds; }
+void PollInputEvents(void) {}
+void TraceLog(int logLevel, const char *text, ...) {}
+int GetScreenWidth(void) { return 800; }
+int GetScreenHeight(void) { return 600; }
+
+int GetRandomValue(int min, int max) {
+  if (min > max)
+    std::swap(min, max);
+  randomState = randomState * 1103515245u + 12345u;
+  return min + (int)((randomState >> 8) % (unsigned int)(max - min + 1));
+}
+
+// ----------- Input -----------
+
+bool IsKeyDown(int key) { return tick >= 0 && key == ScriptedKey(); }
+
+int GetKeyPressed(void) {
+  return pressedRead < pressedCount ? pressedQueue[pressedRead++] : 0;
+}
+
+bool IsKeyPressed(int key) {
+  if (tick < 0)
+    return false;
+  if (key == KEY_R)
+    return tick % restartTicks == restartTicks - 1;
+  return key == ScriptedKey() && tick % keyCycleTicks == 0;
+}
+
+// ----------- Drawing (no-ops) -----------
+
+void BeginDrawing(void) {}
+void EndDrawing(void) {}
+void ClearBackground(Color color) {}
+void DrawText(const char *text, int posX, int posY, int fontSize,
+              Color color) {}
+void DrawCircleV(Vector2 center, float radius, Color color) {}
+void DrawRectangle(int posX, int posY, int width, int height, Color color) {}
+void DrawRectangleV(Vector2 position, Vector2 size, Color color) {}
+void DrawRectangleRec(Rectangle rec, Color color) {}
+void DrawTexturePro(Texture2D texture, Rectangle source, Rectangle dest,
+                    Vector2 origin, float rotation, Color tint) {}
+void BeginShaderMode(Shader shader) {}
+void EndShaderMode(void) {}
+void BeginMode2D(Camera2D camera) {}
+void EndMode2D(void) {}
+void BeginTextureMode(RenderTexture2D target) {}
+void EndTextureMode(void) {}
+RenderTexture2D LoadRenderTexture(int width, int height) {
+  return RenderTexture2D{};
+}
+void UnloadRenderTexture(RenderTexture2D target) {}
+
+// No window, so no default font, as in raylib before InitWindow
+Font GetFontDefault(void) { return Font{}; }
+
+int MeasureText(const char *text, int fontSize) {
+  return (int)strlen(text) * fontSize / 2;
+}
+
+const char *TextFormat(const char *text, ...) {
+  // Same rotating static buffers as raylib, so no allocation
+  static char buffers[4][1024];
+  static int index = 0;
+  char *buffer = buffers[index];
+  index = (index + 1) % 4;
+  va_list args;
+  va_start(args, text);
+  vsnprintf(buffer, sizeof(buffers[0]), text, args);
+  va_end(args);
+  return buffer;
+}
+
+// ----------- Collision -----------
+
+bool CheckCollisionCircles(Vector2 center1, float radius1, Vector2 center2,
+                           float radius2) {
+  float dx = center2.x - center1.x;
+  float dy = center2.y - center1.y;
+  float radii = radius1 + radius2;
+  return dx * dx + dy * dy <= radii * radii;
+}
+
+// ----------- Images -----------
+
+int GetPixelDataSize(int width, int height, int format) {
+  // Only the uncompressed formats, in raylib's PixelFormat order
+  static const int bitsPerPixel[] = {0, 8, 16, 16, 24, 16, 16, 32};
+  int bits = format >= 1 && format <= 7 ? bitsPerPixel[format] : 32;
+  return width * height * bits / 8;
+}
+
+Color GetImageColor(Image image, int x, int y) { return Color{}; }
+bool ExportImage(Image image, const char *fileName) { return false; }
+
+// ----------- OpenGL readback (no-ops) -----------
+// For FrameCapture, which is linked in but never opened here. No
+// mapping ever succeeds, so a capture would count every frame dropped.
+
+void rlDrawRenderBatchActive(void) {}
+void glGenBuffers(int n, unsigned int *buffers) {}
+void glDeleteBuffers(int n, const unsigned int *buffers) {}
+void glBindBuffer(unsigned int target, unsigned int buffer) {}
+void glBufferData(unsigned int target, std::ptrdiff_t size, const void *data,
+                  unsigned int usage) {}
+void glPixelStorei(unsigned int name, int param) {}
+void glReadPixels(int x, int y, int width, int height, unsigned int format,
+                  unsigned int type, void *pixels) {}
+void *glMapBuffer(unsigned int target, unsigned int access) {
+  return nullptr;
+}
+unsigned char glUnmapBuffer(unsigned int target) { return 1; }
+
+// ----------- Audio (no-ops) -----------
+
+void InitAudioDevice(void) {}
+void CloseAudioDevice(void) {}
+Sound LoadSound(const char *fileName) { return Sound{}; }
+Sound LoadSoundFromWave(Wave wave) { return Sound{}; }
+void UnloadSound(Sound sound) {}
+void PlaySound(Sound sound) {}
+
+} // extern "C"
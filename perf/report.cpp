@@ -0,0 +1,204 @@
+// report.cpp
+//
+// Reads the per-lesson JSON written by headless_raylib.cpp, in progression
+// order, prints a table and flags regressions between consecutive versions.
+// Also writes every result into one JSON array.
+//
+// Consecutive files for the same lesson are repeated runs of it: each
+// time and the peak RSS keep their best run, allocations their worst.
+// Time is compared on p50 ns/tick, which a few slow ticks can't move the
+// way they move the mean.
+//
+// A lesson that recorded fewer ticks than asked for left its loop early
+// (0006 quits on game over): its numbers are noise, so it is marked SHORT
+// and skipped, the next lesson being compared with the one before it.
+//
+// Usage: report <summary.json> <lesson1.json> <lesson2.json> ...
+// Exit status is 1 when any regression is flagged.
+//
+// Environment:
+//   PERF_THRESHOLD  allowed relative growth in p50 ns/tick and peak RSS
+//                   (default 0.10 = 10%)
+//   PERF_TICKS      ticks each lesson was asked to measure (default 6000)
+//   PERF_ZERO_ALLOCS  lessons (space separated) that must make no heap
+//                   allocation at all once warmed up; any is flagged
+//   PERF_ACCEPT     known steps, space separated "lesson:time:rss": the
+//                   growth in p50 and peak RSS over the lesson before it
+//                   that is that lesson's normal, or "-" for one that is
+//                   not compared; the threshold applies on top
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct LessonResult {
+  char lesson[128];
+  long ticks;
+  double nsPerTick;
+  long long p50;
+  long long p99;
+  double allocsPerTick;
+  long peakRssKb;
+  long long allocs; // Over all measured ticks
+  int runs;
+  double acceptTime; // Accepted growth over the previous lesson; 0 when
+  double acceptRss;  // not compared
+};
+
+static bool ReadResult(const char *path, LessonResult &r) {
+  FILE *in = fopen(path, "r");
+  if (!in)
+    return false;
+  int fields = fscanf(in,
+                      "{\"lesson\": \"%127[^\"]\", \"ticks\": %ld, "
+                      "\"ns_per_tick\": %lf, \"p50_ns\": %lld, \"p99_ns\": "
+                      "%lld, \"allocs_per_tick\": %lf, \"peak_rss_kb\": %ld, "
+                      "\"allocs\": %lld}",
+                      r.lesson, &r.ticks, &r.nsPerTick, &r.p50, &r.p99,
+                      &r.allocsPerTick, &r.peakRssKb, &r.allocs);
+  fclose(in);
+  r.runs = 1;
+  r.acceptTime = 1.0;
+  r.acceptRss = 1.0;
+  return fields == 8;
+}
+
+// Another run of the same lesson: keep the best of each time, and the
+// worst of the allocations
+static void MergeRun(LessonResult &r, const LessonResult &run) {
+  r.ticks = std::min(r.ticks, run.ticks);
+  r.nsPerTick = std::min(r.nsPerTick, run.nsPerTick);
+  r.p50 = std::min(r.p50, run.p50);
+  r.p99 = std::min(r.p99, run.p99);
+  r.allocsPerTick = std::max(r.allocsPerTick, run.allocsPerTick);
+  r.peakRssKb = std::min(r.peakRssKb, run.peakRssKb);
+  r.allocs = std::max(r.allocs, run.allocs);
+  r.runs++;
+}
+
+// One factor of a PERF_ACCEPT entry ("-": not compared); moves 'p' past it
+static double ReadFactor(const char *&p) {
+  double factor = 0.0;
+  if (*p == '-') {
+    ++p;
+  } else {
+    char *end;
+    factor = strtod(p, &end);
+    p = end;
+  }
+  if (*p == ':')
+    ++p;
+  return factor;
+}
+
+// PERF_ACCEPT's entry for this lesson, if it has one
+static void ReadAccepted(const char *accepted, LessonResult &r) {
+  std::string prefix = std::string(r.lesson) + ":";
+  for (const char *p = accepted; *p;) {
+    while (*p == ' ')
+      ++p;
+    if (strncmp(p, prefix.c_str(), prefix.size()) == 0) {
+      p += prefix.size();
+      r.acceptTime = ReadFactor(p);
+      r.acceptRss = ReadFactor(p);
+      return;
+    }
+    while (*p && *p != ' ')
+      ++p;
+  }
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s <summary.json> <result.json>...\n", argv[0]);
+    return 2;
+  }
+  const char *env = getenv("PERF_THRESHOLD");
+  double threshold = env ? atof(env) : 0.10;
+  const char *ticksEnv = getenv("PERF_TICKS");
+  long expectedTicks = ticksEnv ? atol(ticksEnv) : 6000;
+  // Padded with spaces, so a lesson matches only as a whole word
+  const char *zeroEnv = getenv("PERF_ZERO_ALLOCS");
+  std::string zeroAllocs = " " + std::string(zeroEnv ? zeroEnv : "") + " ";
+  const char *acceptEnv = getenv("PERF_ACCEPT");
+
+  std::vector<LessonResult> results;
+  for (int i = 2; i < argc; ++i) {
+    LessonResult r;
+    if (!ReadResult(argv[i], r)) {
+      fprintf(stderr, "report: cannot read %s\n", argv[i]);
+      return 2;
+    }
+    if (!results.empty() && strcmp(results.back().lesson, r.lesson) == 0) {
+      MergeRun(results.back(), r);
+      continue;
+    }
+    ReadAccepted(acceptEnv ? acceptEnv : "", r);
+    results.push_back(r);
+  }
+
+  printf("%-28s %10s %10s %10s %10s %10s  %s\n", "lesson", "ns/tick",
+         "p50 ns", "p99 ns", "allocs", "rss KiB", "vs previous");
+  bool regressed = false;
+  std::vector<std::string> flags(results.size());
+  const LessonResult *prev = nullptr; // Last lesson with a full run
+  for (size_t i = 0; i < results.size(); ++i) {
+    const LessonResult &r = results[i];
+    bool complete = r.ticks >= expectedTicks;
+    std::string flag;
+    if (complete && prev) {
+      if (r.acceptTime > 0.0 &&
+          r.p50 > prev->p50 * r.acceptTime * (1.0 + threshold))
+        flag += " time";
+      if (r.allocsPerTick > prev->allocsPerTick + 0.01)
+        flag += " allocs";
+      if (r.acceptRss > 0.0 &&
+          r.peakRssKb > prev->peakRssKb * r.acceptRss * (1.0 + threshold))
+        flag += " rss";
+    }
+    if (r.allocs > 0 &&
+        zeroAllocs.find(" " + std::string(r.lesson) + " ") != std::string::npos)
+      flag += " heap (" + std::to_string(r.allocs) + " allocations)";
+    flags[i] = flag.empty() ? "" : "REGRESSION:" + flag;
+    regressed = regressed || !flag.empty();
+    std::string note = !complete ? "SHORT: " + std::to_string(r.ticks) +
+                                       " ticks, not compared"
+                       : !flag.empty() ? flags[i]
+                       : !prev         ? "-"
+                       : r.acceptTime != 1.0 || r.acceptRss != 1.0
+                           ? "ok (accepted step)"
+                           : "ok";
+    printf("%-28s %10.1f %10lld %10lld %10.4f %10ld  %s\n", r.lesson,
+           r.nsPerTick, r.p50, r.p99, r.allocsPerTick, r.peakRssKb,
+           note.c_str());
+    if (complete)
+      prev = &r;
+  }
+
+  FILE *out = fopen(argv[1], "w");
+  if (!out) {
+    fprintf(stderr, "report: cannot write %s\n", argv[1]);
+    return 2;
+  }
+  fprintf(out, "[\n");
+  for (size_t i = 0; i < results.size(); ++i) {
+    const LessonResult &r = results[i];
+    fprintf(out,
+            "  {\"lesson\": \"%s\", \"ticks\": %ld, \"ns_per_tick\": %.1f, "
+            "\"p50_ns\": %lld, \"p99_ns\": %lld, \"allocs_per_tick\": %.4f, "
+            "\"peak_rss_kb\": %ld, \"allocs\": %lld, \"runs\": %d, "
+            "\"complete\": %s, \"regression\": \"%s\"}%s\n",
+            r.lesson, r.ticks, r.nsPerTick, r.p50, r.p99, r.allocsPerTick,
+            r.peakRssKb, r.allocs, r.runs,
+            r.ticks >= expectedTicks ? "true" : "false",
+            flags[i].c_str(),
+            i + 1 < results.size() ? "," : "");
+  }
+  fprintf(out, "]\n");
+  fclose(out);
+
+  return regressed ? 1 : 0;
+}